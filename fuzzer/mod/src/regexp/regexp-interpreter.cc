@@ -25,6 +25,7 @@
 #include "src/strings/unicode.h"
 #include "src/utils/utils.h"
 #include "fuzz/coverage-tracker.hpp"
+#include "fuzz/backtrack-arena.hpp"
 
 
 #ifdef V8_INTL_SUPPORT
@@ -115,44 +116,62 @@ int32_t Load16AlignedSigned(const byte* pc) {
 // Despite the name 'backtracking' stack, it's actually used as a generic stack
 // that stores both program counters (= offsets into the bytecode) and generic
 // integer values.
+// ------- mod_mcl_2020 -------
+// The storage comes from a BacktrackArena which outlives the execution, so
+// that deep stacks need not be re-grown on every execution. Without an arena
+// the stack grows storage of its own.
 class BacktrackStack {
  public:
-  BacktrackStack() = default;
+  explicit BacktrackStack(regulator::fuzz::BacktrackArena* arena)
+      : own_arena_(0),
+        arena_(arena == nullptr ? &own_arena_ : arena),
+        data_(arena_->Data()),
+        capacity_(static_cast<int>(arena_->Capacity())) {}
 
   V8_WARN_UNUSED_RESULT bool push(int v) {
-    data_.emplace_back(v);
-    return (static_cast<int>(data_.size()) <= kMaxSize);
+    if (V8_UNLIKELY(sp_ == capacity_)) grow();
+    data_[sp_++] = v;
+    return sp_ <= kMaxSize;
   }
   int peek() const {
-    DCHECK(!data_.empty());
-    return data_.back();
+    DCHECK_GT(sp_, 0);
+    return data_[sp_ - 1];
   }
   int pop() {
     int v = peek();
-    data_.pop_back();
+    sp_--;
     return v;
   }
 
   // The 'sp' is the index of the first empty element in the stack.
-  int sp() const { return static_cast<int>(data_.size()); }
+  int sp() const { return sp_; }
   void set_sp(int new_sp) {
     DCHECK_LE(new_sp, sp());
-    data_.resize_no_init(new_sp);
+    sp_ = new_sp;
   }
 
  private:
-  // Semi-arbitrary. Should be large enough for common cases to remain in the
-  // static stack-allocated backing store, but small enough not to waste space.
-  static constexpr int kStaticCapacity = 64;
+  void grow() {
+    arena_->Grow(static_cast<size_t>(capacity_) + 1, sp_);
+    data_ = arena_->Data();
+    capacity_ = static_cast<int>(arena_->Capacity());
+  }
 
   using ValueT = int;
-  base::SmallVector<ValueT, kStaticCapacity> data_;
+
+  // Empty (allocation-free) unless used in place of an arena.
+  regulator::fuzz::BacktrackArena own_arena_;
+  regulator::fuzz::BacktrackArena* arena_;
+  ValueT* data_;
+  int capacity_;
+  int sp_ = 0;
 
   static constexpr int kMaxSize =
       RegExpStack::kMaximumStackSize / sizeof(ValueT);
 
   DISALLOW_COPY_AND_ASSIGN(BacktrackStack);
 };
+// ------- (end) mod_mcl_2020 -------
 
 IrregexpInterpreter::Result ThrowStackOverflow(Isolate* isolate,
                                                RegExp::CallOrigin call_origin) {
@@ -237,6 +256,12 @@ IrregexpInterpreter::Result HandleInterrupts(
         result = isolate->stack_guard()->HandleInterrupts();
       }
       if (result.IsException(isolate)) {
+        // ------- mod_mcl_2020 -------
+        if (isolate->pending_exception() ==
+            ReadOnlyRoots(isolate).termination_exception()) {
+          return IrregexpInterpreter::TERMINATED;
+        }
+        // ------- (end) mod_mcl_2020 -------
         return IrregexpInterpreter::EXCEPTION;
       }
 
@@ -275,18 +300,11 @@ bool CheckBitInTable(const uint32_t current_char, const byte* const table) {
     next_insn = Load32Aligned(next_pc);                            \
     next_handler_addr = dispatch_table[next_insn & BYTECODE_MASK]; \
   } while (false)
-#if defined REG_COUNT_PATHLENGTH
-#define DISPATCH()  \
-  pc = next_pc;     \
-  insn = next_insn; \
-  coverage_tracker->IncPathLength(); \
-  goto* next_handler_addr
-#else // DREG_COUNT_PATHLENGTH
 #define DISPATCH()  \
   pc = next_pc;     \
   insn = next_insn; \
+  INC_PATH_LENGTH(); \
   goto* next_handler_addr
-#endif // DREG_COUNT_PATHLENGTH
 // Without computed goto support, we fall back to a simple switch-based
 // dispatch (A large switch statement inside a loop with a case for every
 // bytecode).
@@ -296,6 +314,7 @@ bool CheckBitInTable(const uint32_t current_char, const byte* const table) {
 #define DISPATCH()  \
   pc = next_pc;     \
   insn = next_insn; \
+  INC_PATH_LENGTH(); \
   goto switch_dispatch_continuation
 #endif  // V8_USE_COMPUTED_GOTO
 
@@ -311,9 +330,35 @@ bool CheckBitInTable(const uint32_t current_char, const byte* const table) {
   DECODE()
 
 // ------- mod_mcl_2020 -------
+// Coverage is reported by bytecode offset rather than by address, so that
+// it is stable across executions (and GC moves of the ByteArray), and so
+// that it can be mapped to the edges found by regulator::FindEdges.
+#define PC_OFFSET(p) static_cast<uintptr_t>((p) - code_base)
+
+// Instrumentation hooks. RawMatch is instantiated once per
+// regulator::fuzz::Instrumentation tier; `Policy` is that tier's
+// instrumentation_policy, so hooks it does not want compile to nothing.
+#define INC_PATH_LENGTH()                                       \
+  do {                                                          \
+    if (Policy::kPathLength) coverage_tracker->IncPathLength(); \
+  } while (false)
+#define COVER(...)                                              \
+  do {                                                          \
+    if (Policy::kEdges) coverage_tracker->Cover(__VA_ARGS__);   \
+    total_budget--;                                             \
+  } while (false)
+#define OBSERVE(i)                                              \
+  do {                                                          \
+    if (Policy::kObservations) coverage_tracker->Observe(i);    \
+  } while (false)
+#define SUGGEST(...)                                                  \
+  do {                                                                \
+    if (Policy::kObservations) coverage_tracker->Suggest(__VA_ARGS__); \
+  } while (false)
+
 #define SET_PC_FROM_OFFSET(offset)  \
   next_pc = code_base + offset;     \
-  coverage_tracker->Cover(reinterpret_cast<uintptr_t>(pc), reinterpret_cast<uintptr_t>(next_pc)); \
+  COVER(PC_OFFSET(pc), PC_OFFSET(next_pc)); \
   DECODE()
 // ------- (end) mod_mcl_2020 -------
 
@@ -328,7 +373,7 @@ bool CheckBitInTable(const uint32_t current_char, const byte* const table) {
 
 // ------- mod_mcl_2020 -------
 
-template <typename Char>
+template <typename Char, typename Policy>
 IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
                                      String subject_string,
                                      Vector<const Char> subject, int* registers,
@@ -336,11 +381,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
                                      RegExp::CallOrigin call_origin,
                                      const uint32_t backtrack_limit,
                                      int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-                                     uint64_t max_path,
-#endif
                                      regulator::fuzz::CoverageTracker *coverage_tracker,
-                                     int registers_length) {
+                                     int registers_length,
+                                     regulator::fuzz::BacktrackArena *backtrack_arena) {
   int current_char_src = -1;
 
 // ------- (end) mod_mcl_2020 -------
@@ -398,10 +441,24 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
   const byte* pc = code_array.GetDataStartAddress();
   const byte* code_base = pc;
 
-  BacktrackStack backtrack_stack;
+  BacktrackStack backtrack_stack(backtrack_arena); // ------- mod_mcl_2020 -------
 
   uint32_t backtrack_count = 0;
 
+  // ------- mod_mcl_2020 -------
+  // Every tier counts down the branches (COVERs) left until max_total, so
+  // that ASSERT_MAXTOTAL bounds executions which record no edges, too. In
+  // the edge tiers each branch adds one to the tracker's Total(), so the
+  // countdown stops exactly where Total() reaches max_total.
+  int64_t total_budget = INT64_MAX;
+  if (max_total >= 0) {
+    total_budget = static_cast<int64_t>(max_total);
+    if (Policy::kEdges) {
+      total_budget -= static_cast<int64_t>(coverage_tracker->Total());
+    }
+  }
+  // ------- (end) mod_mcl_2020 -------
+
 #ifdef DEBUG
   if (FLAG_trace_regexp_bytecodes) {
     PrintF("\n\nStart bytecode interpreter\n\n");
@@ -420,7 +477,7 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
     insn = Load32Aligned(pc);
     switch (insn & BYTECODE_MASK) {
 #endif  // V8_USE_COMPUTED_GOTO
-#define ASSERT_MAXTOTAL() {if (max_total >= 0 && coverage_tracker->Total() >= max_total) {return IrregexpInterpreter::EXCEPTION;}}
+#define ASSERT_MAXTOTAL() {if (total_budget <= 0) {return IrregexpInterpreter::EXCEPTION;}}
 
     BYTECODE(BREAK) { UNREACHABLE(); }
     BYTECODE(PUSH_CP) {
@@ -432,9 +489,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
     }
     BYTECODE(PUSH_BT) {
       // ------- mod_mcl_2020 -------
-      uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+      uintptr_t prev_pc = PC_OFFSET(pc);
       ADVANCE(PUSH_BT);
-      coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+      COVER(prev_pc, PC_OFFSET(pc));
       ASSERT_MAXTOTAL();
       // ------- mod_mcl_2020 -------
       if (!backtrack_stack.push(Load32Aligned(pc + 4))) {
@@ -536,9 +593,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         backtrack_stack.pop();
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_GREEDY);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -550,10 +607,10 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 4));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(LOAD_CURRENT_CHAR);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
-        coverage_tracker->Observe(pos);
+        COVER(prev_pc, PC_OFFSET(pc));
+        OBSERVE(pos);
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
         current_char = subject[pos];
@@ -566,7 +623,7 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
       int pos = current + (insn >> BYTECODE_SHIFT);
       current_char = subject[pos];
       // ------- mod_mcl_2020 -------
-      coverage_tracker->Observe(pos);
+      OBSERVE(pos);
       current_char_src = pos;
       // ------- (end) mod_mcl_2020 -------
       DISPATCH();
@@ -577,11 +634,11 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 4));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(LOAD_2_CURRENT_CHARS);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
-        coverage_tracker->Observe(pos);
-        coverage_tracker->Observe(pos + 1);
+        COVER(prev_pc, PC_OFFSET(pc));
+        OBSERVE(pos);
+        OBSERVE(pos + 1);
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
         Char next = subject[pos + 1];
@@ -596,8 +653,8 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
       Char next = subject[pos + 1];
       current_char = (subject[pos] | (next << (kBitsPerByte * sizeof(Char))));
       // ------- mod_mcl_2020 -------
-      coverage_tracker->Observe(pos);
-      coverage_tracker->Observe(pos + 1);
+      OBSERVE(pos);
+      OBSERVE(pos + 1);
       current_char_src = pos;
       // ------- (end) mod_mcl_2020 -------
       DISPATCH();
@@ -609,14 +666,14 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 4));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(LOAD_4_CURRENT_CHARS);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
-        coverage_tracker->Observe(pos);
-        coverage_tracker->Observe(pos + 1);
-        coverage_tracker->Observe(pos + 2);
-        coverage_tracker->Observe(pos + 3);
+        OBSERVE(pos);
+        OBSERVE(pos + 1);
+        OBSERVE(pos + 2);
+        OBSERVE(pos + 3);
         // ------- (end) mod_mcl_2020 -------
         Char next1 = subject[pos + 1];
         Char next2 = subject[pos + 2];
@@ -637,10 +694,10 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
       current_char =
           (subject[pos] | (next1 << 8) | (next2 << 16) | (next3 << 24));
       // ------- mod_mcl_2020 -------
-      coverage_tracker->Observe(pos);
-      coverage_tracker->Observe(pos + 1);
-      coverage_tracker->Observe(pos + 2);
-      coverage_tracker->Observe(pos + 3);
+      OBSERVE(pos);
+      OBSERVE(pos + 1);
+      OBSERVE(pos + 2);
+      OBSERVE(pos + 3);
       current_char_src = pos;
       // ------- (end) mod_mcl_2020 -------
       DISPATCH();
@@ -651,9 +708,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 8));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_4_CHARS);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -665,12 +722,12 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 4));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
-        uintptr_t other_branch_pc = reinterpret_cast<const uintptr_t>(code_base + Load32Aligned(pc + 4));
+        uintptr_t prev_pc = PC_OFFSET(pc);
+        uintptr_t other_branch_pc = Load32Aligned(pc + 4);
         ADVANCE(CHECK_CHAR);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
-        coverage_tracker->Suggest(
+        SUGGEST(
           prev_pc,
           other_branch_pc,
           c,
@@ -686,9 +743,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 8));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_NOT_4_CHARS);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -698,9 +755,10 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
       uint32_t c = (insn >> BYTECODE_SHIFT);
       if (c != current_char) {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
-        uintptr_t other_branch_pc = reinterpret_cast<const uintptr_t>(pc + RegExpBytecodeLength(BC_CHECK_NOT_CHAR));
-        coverage_tracker->Suggest(
+        uintptr_t prev_pc = PC_OFFSET(pc);
+        // the fall-through branch is covered as a self-edge
+        uintptr_t other_branch_pc = prev_pc;
+        SUGGEST(
           prev_pc,
           other_branch_pc,
           c,
@@ -710,9 +768,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 4));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_NOT_CHAR);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -724,9 +782,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 12));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(AND_CHECK_4_CHARS);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -738,11 +796,11 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 8));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         uintptr_t other_branch_pc = Load32Aligned(pc + 8);
         ADVANCE(AND_CHECK_CHAR);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
-        coverage_tracker->Suggest(
+        COVER(prev_pc, PC_OFFSET(pc));
+        SUGGEST(
           prev_pc,
           other_branch_pc,
           c,
@@ -759,9 +817,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 12));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(AND_CHECK_NOT_4_CHARS);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -771,9 +829,10 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
       uint32_t c = (insn >> BYTECODE_SHIFT);
       if (c != (current_char & Load32Aligned(pc + 4))) {
         // ------- mod_mcl_2020 -------
-        uintptr_t other_branch_pc = reinterpret_cast<const uintptr_t>(pc + RegExpBytecodeLength(BC_AND_CHECK_NOT_CHAR));
-        coverage_tracker->Suggest(
-          reinterpret_cast<const uintptr_t>(pc),
+        // the fall-through branch is covered as a self-edge
+        uintptr_t other_branch_pc = PC_OFFSET(pc);
+        SUGGEST(
+          PC_OFFSET(pc),
           other_branch_pc,
           c,
           current_char_src
@@ -781,9 +840,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 8));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(AND_CHECK_NOT_CHAR);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -797,9 +856,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 8));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(MINUS_AND_CHECK_NOT_CHAR);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -812,9 +871,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 8));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_CHAR_IN_RANGE);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -827,9 +886,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 8));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_CHAR_NOT_IN_RANGE);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -840,9 +899,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 4));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_BIT_IN_TABLE);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -854,9 +913,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 4));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_LT);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -868,9 +927,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 4));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_GT);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -881,9 +940,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 8));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_REGISTER_LT);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -894,9 +953,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 8));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_REGISTER_GE);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -907,9 +966,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 4));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_REGISTER_EQ_POS);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -919,9 +978,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
       if (registers[insn >> BYTECODE_SHIFT] ==
           registers[Load32Aligned(pc + 4)]) {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_NOT_REGS_EQUAL);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       } else {
@@ -942,9 +1001,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         current += len;
       }
       // ------- mod_mcl_2020 -------
-      uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+      uintptr_t prev_pc = PC_OFFSET(pc);
       ADVANCE(CHECK_NOT_BACK_REF);
-      coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+      COVER(prev_pc, PC_OFFSET(pc));
       ASSERT_MAXTOTAL();
       // ------- (end) mod_mcl_2020 -------
       DISPATCH();
@@ -962,9 +1021,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         current -= len;
       }
       // ------- mod_mcl_2020 -------
-      uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+      uintptr_t prev_pc = PC_OFFSET(pc);
       ADVANCE(CHECK_NOT_BACK_REF_BACKWARD);
-      coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+      COVER(prev_pc, PC_OFFSET(pc));
       ASSERT_MAXTOTAL();
       // ------- (end) mod_mcl_2020 -------
       DISPATCH();
@@ -984,9 +1043,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         current += len;
       }
       // ------- mod_mcl_2020 -------
-      uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+      uintptr_t prev_pc = PC_OFFSET(pc);
       ADVANCE(CHECK_NOT_BACK_REF_NO_CASE);
-      coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+      COVER(prev_pc, PC_OFFSET(pc));
       ASSERT_MAXTOTAL();
       // ------- (end) mod_mcl_2020 -------
       DISPATCH();
@@ -1006,9 +1065,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         current -= len;
       }
       // ------- mod_mcl_2020 -------
-      uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+      uintptr_t prev_pc = PC_OFFSET(pc);
       ADVANCE(CHECK_NOT_BACK_REF_NO_CASE_BACKWARD);
-      coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+      COVER(prev_pc, PC_OFFSET(pc));
       ASSERT_MAXTOTAL();
       // ------- (end) mod_mcl_2020 -------
       DISPATCH();
@@ -1018,9 +1077,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 4));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_AT_START);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -1029,9 +1088,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
     BYTECODE(CHECK_NOT_AT_START) {
       if (current + (insn >> BYTECODE_SHIFT) == 0) {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_NOT_AT_START);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       } else {
@@ -1055,9 +1114,9 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
         SET_PC_FROM_OFFSET(Load32Aligned(pc + 4));
       } else {
         // ------- mod_mcl_2020 -------
-        uintptr_t prev_pc = reinterpret_cast<const uintptr_t>(pc);
+        uintptr_t prev_pc = PC_OFFSET(pc);
         ADVANCE(CHECK_CURRENT_POSITION);
-        coverage_tracker->Cover(prev_pc, reinterpret_cast<const uintptr_t>(pc));
+        COVER(prev_pc, PC_OFFSET(pc));
         ASSERT_MAXTOTAL();
         // ------- (end) mod_mcl_2020 -------
       }
@@ -1070,16 +1129,14 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
       while (static_cast<uintptr_t>(current + load_offset) <
              static_cast<uintptr_t>(subject.length())) {
         current_char = subject[current + load_offset];
-        coverage_tracker->Observe(current + load_offset); // ------- mod_mcl_2020 -------
+        OBSERVE(current + load_offset); // ------- mod_mcl_2020 -------
         current_char_src = current + load_offset; // ------- mod_mcl_2020 -------
         if (c == current_char) {
           SET_PC_FROM_OFFSET(Load32Aligned(pc + 8));
           DISPATCH();
         }
-#if defined REG_COUNT_PATHLENGTH
-        coverage_tracker->IncPathLength();
-#endif
-        coverage_tracker->Cover(reinterpret_cast<uintptr_t>(pc)); // ------- mod_mcl_2020 -------
+        INC_PATH_LENGTH();
+        COVER(PC_OFFSET(pc)); // ------- mod_mcl_2020 -------
         ASSERT_MAXTOTAL();
         current += advance;
       }
@@ -1095,16 +1152,14 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
       while (static_cast<uintptr_t>(current + maximum_offset) <=
              static_cast<uintptr_t>(subject.length())) {
         current_char = subject[current + load_offset];
-        coverage_tracker->Observe(current + load_offset); // ------- mod_mcl_2020 -------
+        OBSERVE(current + load_offset); // ------- mod_mcl_2020 -------
         current_char_src = current + load_offset; // ------- mod_mcl_2020 -------
         if (c == (current_char & mask)) {
           SET_PC_FROM_OFFSET(Load32Aligned(pc + 16));
           DISPATCH();
         }
-#if defined REG_COUNT_PATHLENGTH
-        coverage_tracker->IncPathLength();
-#endif
-        coverage_tracker->Cover(reinterpret_cast<uintptr_t>(pc)); // ------- mod_mcl_2020 -------
+        INC_PATH_LENGTH();
+        COVER(PC_OFFSET(pc)); // ------- mod_mcl_2020 -------
         ASSERT_MAXTOTAL();
         current += advance;
       }
@@ -1119,16 +1174,14 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
       while (static_cast<uintptr_t>(current + maximum_offset) <=
              static_cast<uintptr_t>(subject.length())) {
         current_char = subject[current + load_offset];
-        coverage_tracker->Observe(current + load_offset); // ------- mod_mcl_2020 -------
+        OBSERVE(current + load_offset); // ------- mod_mcl_2020 -------
         current_char_src = current + load_offset; // ------- mod_mcl_2020 -------
         if (c == current_char) {
           SET_PC_FROM_OFFSET(Load32Aligned(pc + 12));
           DISPATCH();
         }
-#if defined REG_COUNT_PATHLENGTH
-        coverage_tracker->IncPathLength();
-#endif
-        coverage_tracker->Cover(reinterpret_cast<uintptr_t>(pc)); // ------- mod_mcl_2020 -------
+        INC_PATH_LENGTH();
+        COVER(PC_OFFSET(pc)); // ------- mod_mcl_2020 -------
         ASSERT_MAXTOTAL();
         current += advance;
       }
@@ -1142,16 +1195,14 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
       while (static_cast<uintptr_t>(current + load_offset) <
              static_cast<uintptr_t>(subject.length())) {
         current_char = subject[current + load_offset];
-        coverage_tracker->Observe(current + load_offset); // ------- mod_mcl_2020 -------
+        OBSERVE(current + load_offset); // ------- mod_mcl_2020 -------
         current_char_src = current + load_offset; // ------- mod_mcl_2020 -------
         if (CheckBitInTable(current_char, table)) {
           SET_PC_FROM_OFFSET(Load32Aligned(pc + 24));
           DISPATCH();
         }
-#if defined REG_COUNT_PATHLENGTH
-        coverage_tracker->IncPathLength();
-#endif
-        coverage_tracker->Cover(reinterpret_cast<uintptr_t>(pc)); // ------- mod_mcl_2020 -------
+        INC_PATH_LENGTH();
+        COVER(PC_OFFSET(pc)); // ------- mod_mcl_2020 -------
         ASSERT_MAXTOTAL();
         current += advance;
       }
@@ -1166,7 +1217,7 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
       while (static_cast<uintptr_t>(current + load_offset) <
              static_cast<uintptr_t>(subject.length())) {
         current_char = subject[current + load_offset];
-        coverage_tracker->Observe(current + load_offset); // ------- mod_mcl_2020 -------
+        OBSERVE(current + load_offset); // ------- mod_mcl_2020 -------
         current_char_src = current + load_offset; // ------- mod_mcl_2020 -------
         if (current_char > limit) {
           SET_PC_FROM_OFFSET(Load32Aligned(pc + 24));
@@ -1176,10 +1227,8 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
           SET_PC_FROM_OFFSET(Load32Aligned(pc + 24));
           DISPATCH();
         }
-#if defined REG_COUNT_PATHLENGTH
-        coverage_tracker->IncPathLength();
-#endif
-        coverage_tracker->Cover(reinterpret_cast<uintptr_t>(pc)); // ------- mod_mcl_2020 -------
+        INC_PATH_LENGTH();
+        COVER(PC_OFFSET(pc)); // ------- mod_mcl_2020 -------
         ASSERT_MAXTOTAL();
         current += advance;
       }
@@ -1194,7 +1243,7 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
       while (static_cast<uintptr_t>(current + load_offset) <
              static_cast<uintptr_t>(subject.length())) {
         current_char = subject[current + load_offset];
-        coverage_tracker->Observe(current + load_offset); // ------- mod_mcl_2020 -------
+        OBSERVE(current + load_offset); // ------- mod_mcl_2020 -------
         current_char_src = current + load_offset; // ------- mod_mcl_2020 -------
         // The two if-statements below are split up intentionally, as combining
         // them seems to result in register allocation behaving quite
@@ -1207,10 +1256,8 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
           SET_PC_FROM_OFFSET(Load32Aligned(pc + 12));
           DISPATCH();
         }
-#if defined REG_COUNT_PATHLENGTH
-        coverage_tracker->IncPathLength();
-#endif
-        coverage_tracker->Cover(reinterpret_cast<uintptr_t>(pc)); // ------- mod_mcl_2020 -------
+        INC_PATH_LENGTH();
+        COVER(PC_OFFSET(pc)); // ------- mod_mcl_2020 -------
         ASSERT_MAXTOTAL();
         current += advance;
       }
@@ -1235,10 +1282,54 @@ IrregexpInterpreter::Result RawMatch(Isolate* isolate, ByteArray code_array,
 #undef DISPATCH
 #undef DECODE
 #undef SET_PC_FROM_OFFSET
+#undef PC_OFFSET
+#undef INC_PATH_LENGTH
+#undef COVER
+#undef OBSERVE
+#undef SUGGEST
+#undef ASSERT_MAXTOTAL
 #undef ADVANCE
 #undef BC_LABEL
 #undef V8_USE_COMPUTED_GOTO
 
+// ------- mod_mcl_2020 -------
+// Picks the RawMatch instantiation for the requested instrumentation tier.
+template <typename Char>
+IrregexpInterpreter::Result RawMatchInstrumented(
+    Isolate* isolate, ByteArray code_array, String subject_string,
+    Vector<const Char> subject, int* registers, int current,
+    uint32_t current_char, RegExp::CallOrigin call_origin,
+    const uint32_t backtrack_limit, int32_t max_total,
+    regulator::fuzz::Instrumentation instrumentation,
+    regulator::fuzz::CoverageTracker *coverage_tracker,
+    int registers_length,
+    regulator::fuzz::BacktrackArena *backtrack_arena) {
+  switch (instrumentation) {
+    case regulator::fuzz::kInstrumentNone:
+      return RawMatch<Char, regulator::fuzz::InstrumentNonePolicy>(
+          isolate, code_array, subject_string, subject, registers, current,
+          current_char, call_origin, backtrack_limit, max_total,
+          coverage_tracker, registers_length, backtrack_arena);
+    case regulator::fuzz::kInstrumentPathLength:
+      return RawMatch<Char, regulator::fuzz::InstrumentPathLengthPolicy>(
+          isolate, code_array, subject_string, subject, registers, current,
+          current_char, call_origin, backtrack_limit, max_total,
+          coverage_tracker, registers_length, backtrack_arena);
+    case regulator::fuzz::kInstrumentEdges:
+      return RawMatch<Char, regulator::fuzz::InstrumentEdgesPolicy>(
+          isolate, code_array, subject_string, subject, registers, current,
+          current_char, call_origin, backtrack_limit, max_total,
+          coverage_tracker, registers_length, backtrack_arena);
+    case regulator::fuzz::kInstrumentFull:
+      return RawMatch<Char, regulator::fuzz::InstrumentFullPolicy>(
+          isolate, code_array, subject_string, subject, registers, current,
+          current_char, call_origin, backtrack_limit, max_total,
+          coverage_tracker, registers_length, backtrack_arena);
+  }
+  UNREACHABLE();
+}
+// ------- (end) mod_mcl_2020 -------
+
 
 }  // namespace
 
@@ -1258,9 +1349,7 @@ IrregexpInterpreter::Result IrregexpInterpreter::Match(
     start_position,
     call_origin,
     -1,
-#if defined REG_COUNT_PATHLENGTH
-    UINT64_MAX,
-#endif
+    regulator::fuzz::kInstrumentNone,
     nullptr
   );
 }
@@ -1269,9 +1358,7 @@ IrregexpInterpreter::Result IrregexpInterpreter::Match(
     Isolate* isolate, JSRegExp regexp, String subject_string, int* registers,
     int registers_length, int start_position, RegExp::CallOrigin call_origin,
     int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-    uint64_t max_path,
-#endif
+    regulator::fuzz::Instrumentation instrumentation,
     regulator::fuzz::CoverageTracker *coverage_tracker) {
   if (FLAG_regexp_tier_up) {
     regexp.TierUpTick();
@@ -1280,13 +1367,14 @@ IrregexpInterpreter::Result IrregexpInterpreter::Match(
   bool is_one_byte = String::IsOneByteRepresentationUnderneath(subject_string);
   ByteArray code_array = ByteArray::cast(regexp.Bytecode(is_one_byte));
 
+  // Executions on one thread never nest, so they can share backtrack storage
+  static thread_local regulator::fuzz::BacktrackArena backtrack_arena;
+
   return MatchInternal(isolate, code_array, subject_string, registers,
                        registers_length, start_position, call_origin,
                        regexp.BacktrackLimit(), max_total,
-#if defined REG_COUNT_PATHLENGTH
-                       max_path,
-#endif
-                       coverage_tracker);
+                       instrumentation,
+                       coverage_tracker, &backtrack_arena);
 }
 
 IrregexpInterpreter::Result IrregexpInterpreter::MatchInternal(
@@ -1303,9 +1391,8 @@ IrregexpInterpreter::Result IrregexpInterpreter::MatchInternal(
     call_origin,
     backtrack_limit,
     -1,
-#if defined REG_COUNT_PATHLENGTH
-    UINT64_MAX,
-#endif
+    regulator::fuzz::kInstrumentNone,
+    nullptr,
     nullptr
   );
 }
@@ -1315,10 +1402,9 @@ IrregexpInterpreter::Result IrregexpInterpreter::MatchInternal(
     int* registers, int registers_length, int start_position,
     RegExp::CallOrigin call_origin, uint32_t backtrack_limit,
     int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-    uint64_t max_path,
-#endif
-    regulator::fuzz::CoverageTracker *coverage_tracker) {
+    regulator::fuzz::Instrumentation instrumentation,
+    regulator::fuzz::CoverageTracker *coverage_tracker,
+    regulator::fuzz::BacktrackArena *backtrack_arena) {
 
 // ------- (end) mod_mcl_2020 -------
 
@@ -1343,24 +1429,18 @@ IrregexpInterpreter::Result IrregexpInterpreter::MatchInternal(
   if (subject_content.IsOneByte()) {
     Vector<const uint8_t> subject_vector = subject_content.ToOneByteVector();
     if (start_position != 0) previous_char = subject_vector[start_position - 1];
-    return RawMatch(isolate, code_array, subject_string, subject_vector,
+    return RawMatchInstrumented(isolate, code_array, subject_string, subject_vector,
                     registers, start_position, previous_char, call_origin,
-                    backtrack_limit, max_total,
-#if defined REG_COUNT_PATHLENGTH
-                    max_path,
-#endif
-                    coverage_tracker, registers_length);
+                    backtrack_limit, max_total, instrumentation,
+                    coverage_tracker, registers_length, backtrack_arena);
   } else {
     DCHECK(subject_content.IsTwoByte());
     Vector<const uc16> subject_vector = subject_content.ToUC16Vector();
     if (start_position != 0) previous_char = subject_vector[start_position - 1];
-    return RawMatch(isolate, code_array, subject_string, subject_vector,
+    return RawMatchInstrumented(isolate, code_array, subject_string, subject_vector,
                     registers, start_position, previous_char, call_origin,
-                    backtrack_limit, max_total,
-#if defined REG_COUNT_PATHLENGTH
-                    max_path,
-#endif
-                    coverage_tracker, registers_length);
+                    backtrack_limit, max_total, instrumentation,
+                    coverage_tracker, registers_length, backtrack_arena);
   }
 }
 
@@ -1428,9 +1508,7 @@ IrregexpInterpreter::Result IrregexpInterpreter::MatchForCallFromRuntime(
     registers_length,
     start_position,
     -1,
-#if defined REG_COUNT_PATHLENGTH
-    UINT64_MAX,
-#endif
+    regulator::fuzz::kInstrumentNone,
     nullptr
   );
 }
@@ -1438,15 +1516,11 @@ IrregexpInterpreter::Result IrregexpInterpreter::MatchForCallFromRuntime(
 IrregexpInterpreter::Result IrregexpInterpreter::MatchForCallFromRuntime(
     Isolate* isolate, Handle<JSRegExp> regexp, Handle<String> subject_string,
     int* registers, int registers_length, int start_position, int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-    uint64_t max_path,
-#endif
+    regulator::fuzz::Instrumentation instrumentation,
     regulator::fuzz::CoverageTracker *coverage_tracker) {
   return Match(isolate, *regexp, *subject_string, registers, registers_length,
                start_position, RegExp::CallOrigin::kFromRuntime, max_total,
-#if defined REG_COUNT_PATHLENGTH
-               max_path,
-#endif
+               instrumentation,
                coverage_tracker);
 }
 // ------- (end) mod_mcl_2020 -------
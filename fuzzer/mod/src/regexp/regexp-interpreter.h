@@ -13,6 +13,8 @@
 
 #include "src/regexp/regexp.h"
 #include "fuzz/coverage-tracker.hpp"
+#include "fuzz/instrumentation.hpp"
+#include "fuzz/backtrack-arena.hpp"
 
 #include <vector>
 
@@ -27,6 +29,13 @@ class V8_EXPORT_PRIVATE IrregexpInterpreter : public AllStatic {
     SUCCESS = RegExp::kInternalRegExpSuccess,
     EXCEPTION = RegExp::kInternalRegExpException,
     RETRY = RegExp::kInternalRegExpRetry,
+    // ------- mod_mcl_2020 -------
+    // The match was abandoned at an interrupt check because
+    // TerminateExecution was requested (by regulator's ExecWatchdog); the
+    // termination exception is pending. Only calls from the runtime can
+    // see it, and RegExpImpl passes it on as EXCEPTION.
+    TERMINATED = RegExp::kInternalRegExpRetry - 1,
+    // ------- (end) mod_mcl_2020 -------
   };
 
   // ------- mod_mcl_2020 -------
@@ -38,9 +47,7 @@ class V8_EXPORT_PRIVATE IrregexpInterpreter : public AllStatic {
                                         int* registers, int registers_length,
                                         int start_position,
                                         int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-                                        uint64_t max_path,
-#endif
+                                        regulator::fuzz::Instrumentation instrumentation,
                                         regulator::fuzz::CoverageTracker *coverage_tracker);
   
   static Result MatchForCallFromRuntime(Isolate* isolate,
@@ -72,16 +79,17 @@ class V8_EXPORT_PRIVATE IrregexpInterpreter : public AllStatic {
                               RegExp::CallOrigin call_origin,
                               uint32_t backtrack_limit);
 
+  // `backtrack_arena`, if not null, provides the backtrack stack's storage
+  // and is meant to be reused across calls.
   static Result MatchInternal(Isolate* isolate, ByteArray code_array,
                               String subject_string, int* registers,
                               int registers_length, int start_position,
                               RegExp::CallOrigin call_origin,
                               uint32_t backtrack_limit,
                               int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-                              uint64_t max_path,
-#endif
-                              regulator::fuzz::CoverageTracker *coverage_tracker);
+                              regulator::fuzz::Instrumentation instrumentation,
+                              regulator::fuzz::CoverageTracker *coverage_tracker,
+                              regulator::fuzz::BacktrackArena *backtrack_arena);
 
   // ------- (end) mod_mcl_2020 -------
 
@@ -92,9 +100,7 @@ class V8_EXPORT_PRIVATE IrregexpInterpreter : public AllStatic {
   static Result Match(Isolate* isolate, JSRegExp regexp, String subject_string,
                       int* registers, int registers_length, int start_position,
                       RegExp::CallOrigin call_origin, int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-                      uint64_t max_path,
-#endif
+                      regulator::fuzz::Instrumentation instrumentation,
                       regulator::fuzz::CoverageTracker *coverage_tracker);
 
   static Result Match(Isolate* isolate, JSRegExp regexp, String subject_string,
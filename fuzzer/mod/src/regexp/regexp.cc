@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include <memory>
+#include <vector>
 
 #include "src/regexp/regexp.h"
 
@@ -65,17 +66,13 @@ class RegExpImpl final : public AllStatic {
   static int IrregexpExecRaw(Isolate* isolate, Handle<JSRegExp> regexp,
                              Handle<String> subject, int index, int32_t* output,
                              int output_size, int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-                             uint64_t max_path,
-#endif
+                             regulator::fuzz::Instrumentation instrumentation,
                              regulator::fuzz::CoverageTracker *coverage_tracker);
 
   V8_WARN_UNUSED_RESULT static MaybeHandle<Object> IrregexpExec(
       Isolate* isolate, Handle<JSRegExp> regexp, Handle<String> subject,
       int index, Handle<RegExpMatchInfo> last_match_info, int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-      uint64_t max_path,
-#endif
+      regulator::fuzz::Instrumentation instrumentation,
       regulator::fuzz::CoverageTracker *coverage_tracker);
   // ------- (end) mod_mcl_2020 -------
 
@@ -237,9 +234,7 @@ MaybeHandle<Object> RegExp::Exec(
       int index,
       Handle<RegExpMatchInfo> last_match_info,
       int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-      uint64_t max_path,
-#endif
+      regulator::fuzz::Instrumentation instrumentation,
       regulator::fuzz::CoverageTracker *coverage_tracker) {
   switch (regexp->TypeTag()) {
     case JSRegExp::ATOM:
@@ -248,9 +243,7 @@ MaybeHandle<Object> RegExp::Exec(
     case JSRegExp::IRREGEXP: {
       auto ret = RegExpImpl::IrregexpExec(isolate, regexp, subject, index,
                                       last_match_info, max_total,
-#if defined REG_COUNT_PATHLENGTH
-                                      max_path,
-#endif
+                                      instrumentation,
                                       coverage_tracker);
       return ret;
     }
@@ -264,13 +257,9 @@ MaybeHandle<Object> RegExp::Exec(
 MaybeHandle<Object> RegExp::Exec(Isolate* isolate, Handle<JSRegExp> regexp,
                                  Handle<String> subject, int index,
                                  Handle<RegExpMatchInfo> last_match_info) {
-  auto coverage_tracker = std::make_unique<regulator::fuzz::CoverageTracker>(0);
-
   return RegExp::Exec(isolate, regexp, subject, index, last_match_info, -1,
-#if defined REG_COUNT_PATHLENGTH
-    UINT64_MAX,
-#endif
-    coverage_tracker.get());
+    regulator::fuzz::kInstrumentNone,
+    nullptr);
 }
 
 // RegExp Atom implementation: Simple string search using indexOf.
@@ -585,9 +574,7 @@ int RegExpImpl::IrregexpExecRaw(Isolate* isolate, Handle<JSRegExp> regexp,
     output,
     output_size,
     -1,
-#if defined REG_COUNT_PATHLENGTH
-    UINT64_MAX,
-#endif
+    regulator::fuzz::kInstrumentNone,
     nullptr
   );
 }
@@ -595,9 +582,7 @@ int RegExpImpl::IrregexpExecRaw(Isolate* isolate, Handle<JSRegExp> regexp,
 int RegExpImpl::IrregexpExecRaw(Isolate* isolate, Handle<JSRegExp> regexp,
                                 Handle<String> subject, int index,
                                 int32_t* output, int output_size, int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-                                uint64_t max_path,
-#endif
+                                regulator::fuzz::Instrumentation instrumentation,
                                 regulator::fuzz::CoverageTracker *coverage_tracker) {
   Handle<FixedArray> irregexp(FixedArray::cast(regexp->data()), isolate);
 
@@ -651,12 +636,11 @@ int RegExpImpl::IrregexpExecRaw(Isolate* isolate, Handle<JSRegExp> regexp,
           IrregexpInterpreter::MatchForCallFromRuntime(
               isolate, regexp, subject, raw_output, number_of_capture_registers,
               index, max_total,
-#if defined REG_COUNT_PATHLENGTH
-              max_path,
-#endif
+              instrumentation,
               coverage_tracker);
+      // without a pending exception, the match used up max_total
       DCHECK_IMPLIES(result == IrregexpInterpreter::EXCEPTION,
-                     (max_total >= 0 && coverage_tracker->Total() >= max_total) || isolate->has_pending_exception());
+                     max_total >= 0 || isolate->has_pending_exception());
 
       switch (result) {
         case IrregexpInterpreter::SUCCESS:
@@ -667,6 +651,10 @@ int RegExpImpl::IrregexpExecRaw(Isolate* isolate, Handle<JSRegExp> regexp,
         case IrregexpInterpreter::EXCEPTION:
         case IrregexpInterpreter::FAILURE:
           return result;
+        // ------- mod_mcl_2020 -------
+        case IrregexpInterpreter::TERMINATED:
+          return IrregexpInterpreter::EXCEPTION;
+        // ------- (end) mod_mcl_2020 -------
         case IrregexpInterpreter::RETRY:
           // The string has changed representation, and we must restart the
           // match.
@@ -688,24 +676,17 @@ int RegExpImpl::IrregexpExecRaw(Isolate* isolate, Handle<JSRegExp> regexp,
 MaybeHandle<Object> RegExpImpl::IrregexpExec(
     Isolate* isolate, Handle<JSRegExp> regexp, Handle<String> subject,
     int previous_index, Handle<RegExpMatchInfo> last_match_info) {
-
-  auto coverage_tracker = std::make_unique<regulator::fuzz::CoverageTracker>(0);
-
   return IrregexpExec(
     isolate, regexp, subject, previous_index, last_match_info, -1,
-#if defined REG_COUNT_PATHLENGTH
-    UINT64_MAX,
-#endif
-    coverage_tracker.get()
+    regulator::fuzz::kInstrumentNone,
+    nullptr
   );
 }
 
 MaybeHandle<Object> RegExpImpl::IrregexpExec(
     Isolate* isolate, Handle<JSRegExp> regexp, Handle<String> subject,
     int previous_index, Handle<RegExpMatchInfo> last_match_info, int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-    uint64_t max_path,
-#endif
+    regulator::fuzz::Instrumentation instrumentation,
     regulator::fuzz::CoverageTracker *coverage_tracker) {
   DCHECK_EQ(regexp->TypeTag(), JSRegExp::IRREGEXP);
 
@@ -741,21 +722,23 @@ MaybeHandle<Object> RegExpImpl::IrregexpExec(
     return MaybeHandle<Object>();
   }
 
-  int32_t* output_registers = nullptr;
+  // Regexps with many captures don't fit the isolate's static vector. Rather
+  // than allocating an array for every execution, keep one per thread and
+  // grow it as needed (like the static vector, it is only in use for the
+  // duration of this call).
+  static thread_local std::vector<int32_t> register_pool;
+  int32_t* output_registers = isolate->jsregexp_static_offsets_vector();
   if (required_registers > Isolate::kJSRegexpStaticOffsetsVectorSize) {
-    output_registers = NewArray<int32_t>(required_registers);
-  }
-  std::unique_ptr<int32_t[]> auto_release(output_registers);
-  if (output_registers == nullptr) {
-    output_registers = isolate->jsregexp_static_offsets_vector();
+    if (register_pool.size() < static_cast<size_t>(required_registers)) {
+      register_pool.resize(required_registers);
+    }
+    output_registers = register_pool.data();
   }
 
   int res =
       RegExpImpl::IrregexpExecRaw(isolate, regexp, subject, previous_index,
                                   output_registers, required_registers, max_total,
-#if defined REG_COUNT_PATHLENGTH
-                                  max_path,
-#endif
+                                  instrumentation,
                                   coverage_tracker);
 
   if (res == RegExp::RE_SUCCESS) {
@@ -765,7 +748,7 @@ MaybeHandle<Object> RegExpImpl::IrregexpExec(
                                     capture_count, output_registers);
   }
   if (res == RegExp::RE_EXCEPTION) {
-    DCHECK((max_total >= 0 && coverage_tracker->Total() >= max_total) || isolate->has_pending_exception());
+    DCHECK(max_total >= 0 || isolate->has_pending_exception());
     return MaybeHandle<Object>();
   }
   DCHECK(res == RegExp::RE_FAILURE);
@@ -8,6 +8,7 @@
 #include "src/objects/js-regexp.h"
 #include "src/regexp/regexp-error.h"
 #include "fuzz/coverage-tracker.hpp"
+#include "fuzz/instrumentation.hpp"
 
 namespace v8 {
 namespace internal {
@@ -88,9 +89,7 @@ class RegExp final : public AllStatic {
       int index,
       Handle<RegExpMatchInfo> last_match_info,
       int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-      uint64_t max_path,
-#endif
+      regulator::fuzz::Instrumentation instrumentation,
       regulator::fuzz::CoverageTracker *coverage_tracker
   );
   // ------- (end) mod_mcl_2020 -------
@@ -0,0 +1,92 @@
+#!/usr/bin/python3
+"""
+node_config_defines.py
+
+Prints which of the given configuration-dependent macros a target
+of Node's gyp build defined for one build type, as compiler flags.
+
+The patched V8 / ICU sources (mod/) are linked into Node's own
+libraries, so they must be compiled with the same configuration
+defines as the rest of them; this reads those defines from the
+target's generated makefile instead of repeating them by hand.
+"""
+
+import argparse
+import re
+import sys
+
+
+def read_defs(target_mk, build_type):
+    """
+    Returns the -D flags of DEFS_<build_type> in `target_mk`, or None if
+    the makefile has no such variable
+    """
+    with open(target_mk) as f:
+        lines = f.read().splitlines()
+
+    header = 'DEFS_{} :='.format(build_type)
+    for i, line in enumerate(lines):
+        if line.strip() != header + ' \\' and line.strip() != header:
+            continue
+
+        defs = []
+        continued = line.endswith('\\')
+        for line in lines[i + 1:]:
+            if not continued:
+                break
+            continued = line.endswith('\\')
+            flag = line.rstrip('\\').strip().strip("'")
+            if flag.startswith('-D'):
+                defs.append(flag)
+        return defs
+
+    return None
+
+
+def main():
+    parser = argparse.ArgumentParser()
+
+    parser.add_argument(
+        'TARGET_MK',
+        help='The generated makefile of a target (eg out/tools/v8_gypfiles/v8_base_without_compiler.target.mk)',
+        type=str
+    )
+
+    parser.add_argument(
+        'BUILD_TYPE',
+        help='Debug or Release',
+        type=str
+    )
+
+    parser.add_argument(
+        'MACROS',
+        help='The configuration-dependent macros to look for',
+        nargs='+',
+        type=str
+    )
+
+    args = parser.parse_args()
+
+    try:
+        defs = read_defs(args.TARGET_MK, args.BUILD_TYPE)
+    except OSError as e:
+        print('ERROR: could not read {}: {}'.format(args.TARGET_MK, e), file=sys.stderr)
+        sys.exit(1)
+
+    if defs is None:
+        print('ERROR: {} has no {} defines'.format(args.TARGET_MK, args.BUILD_TYPE), file=sys.stderr)
+        sys.exit(1)
+
+    wanted = set(args.MACROS)
+    found = [d for d in defs if re.split('=', d[2:], 1)[0] in wanted]
+    # spliced into compiler command lines by the shell, unquoted: none of
+    # these macros' values contain spaces or shell metacharacters
+    for d in found:
+        if re.search(r'[\s\'"\\$`]', d):
+            print('ERROR: can not pass {} unquoted'.format(d), file=sys.stderr)
+            sys.exit(1)
+    print(' '.join(found))
+
+
+if __name__ == '__main__':
+    main()
@@ -15,17 +15,18 @@ using namespace std;
 namespace regulator
 {
 
-ParsedArguments ParsedArguments::Parse(int argc, char **argv)
+/**
+ * The body of ParsedArguments::TryParse, which may throw on malformed
+ * arguments
+ */
+static int parse_arguments(int argc, char **argv, ParsedArguments &ret)
 {
-    ParsedArguments ret;
-
     cxxopts::Options options(argv[0], "Regexp catastrophic backtracking fuzzer");
     options.add_options()
         ("v,version", "Print version", cxxopts::value<bool>()->default_value("False"))
-#if defined REG_COUNT_PATHLENGTH
+        ("zygote", "Initialize once, then run jobs read from stdin in forked children (see zygote.hpp)", cxxopts::value<bool>()->default_value("False"))
         ("count-paths", "base64 subjects line-by-line from stdin continuously, recording max path", cxxopts::value<bool>()->default_value("False"))
-        ("maxpath", "the maximum path length when testing continuously", cxxopts::value<uint64_t>())
-#endif
+        ("maxpath", "Ignored; path lengths are not capped (kept for older scripts)", cxxopts::value<uint64_t>())
         ("f,flags", "Regexp flags", cxxopts::value<std::string>()->default_value(""))
         ("r,regexp", "The regexp to fuzz, as an ascii string", cxxopts::value<std::string>())
         ("b,bregexp", "The regexp to fuzz, as a base64 utf8 string", cxxopts::value<std::string>())
@@ -37,6 +38,10 @@ ParsedArguments ParsedArguments::Parse(int argc, char **argv)
         ("m,threads", "How many threads to use", cxxopts::value<uint16_t>()->default_value("1"))
         ("maxtot", "Maximum Total value before bailing on fuzzing", cxxopts::value<int32_t>()->default_value("-1"))
         ("textseed", "Text seeds for the fuzzer, separated by |||", cxxopts::value<std::string>()->default_value(""))
+        ("dense-edges", "Give each bytecode edge its own coverage slot (no hash collisions)", cxxopts::value<bool>()->default_value("False"))
+        ("fresh-subjects", "Allocate a new V8 string for every execution (slower)", cxxopts::value<bool>()->default_value("False"))
+        ("exec-budget", "Without --maxtot, stop any one execution after this many branches (0: no limit)", cxxopts::value<int32_t>()->default_value("1000000000"))
+        ("exec-timeout", "Stop any one execution after this many milliseconds (0: no limit)", cxxopts::value<uint32_t>()->default_value("0"))
         ("debug", "Enable debug mode", cxxopts::value<bool>()->default_value("False"))
         ("h,help", "Print help", cxxopts::value<bool>()->default_value("False"));
 
@@ -45,13 +50,21 @@ ParsedArguments ParsedArguments::Parse(int argc, char **argv)
     if (parsed["help"].as<bool>())
     {
         std::cout << options.help() << std::endl;
-        exit(0);
+        return 0;
     }
 
     if (parsed["version"].as<bool>())
     {
         std::cout << "Regulator v" << VERSION << std::endl;
-        exit(0);
+        return 0;
+    }
+
+    ret.zygote = parsed["zygote"].as<bool>();
+    if (ret.zygote)
+    {
+        // everything else comes with each job
+        regulator::flags::FLAG_debug = parsed["debug"].as<bool>();
+        return PARSE_CONTINUE;
     }
 
     if (parsed["regexp"].count() > 0)
@@ -71,7 +84,7 @@ ParsedArguments ParsedArguments::Parse(int argc, char **argv)
             std::cerr << "Could not decode base64" << std::endl;
             std::cerr << std::endl;
             std::cerr << options.help() << std::endl;
-            exit(1);
+            return 1;
         }
     }
     else
@@ -79,7 +92,7 @@ ParsedArguments ParsedArguments::Parse(int argc, char **argv)
         std::cerr << "Found neither --regexp nor --bregexp" << std::endl;
         std::cerr << std::endl;
         std::cerr << options.help() << std::endl;
-        exit(1);
+        return 1;
     }
 
     std::string byte_widths = parsed["widths"].as<std::string>();
@@ -101,36 +114,25 @@ ParsedArguments ParsedArguments::Parse(int argc, char **argv)
     else
     {
         std::cerr << "ERROR: unknown widths argument: " << byte_widths << std::endl;
-        exit(1);
+        return 1;
     }
 
     ret.flags = parsed["flags"].as<std::string>();
 
-#if defined REG_COUNT_PATHLENGTH
     if (parsed["count-paths"].as<bool>())
     {
         ret.count_paths = true;
         if (ret.fuzz_one_byte && ret.fuzz_two_byte)
         {
             std::cerr << "Cannot handle one AND two byte read continuously" << std::endl;
-            exit(1);
-        }
-        if (parsed["maxpath"].count() > 0)
-        {
-            ret.max_path = parsed["maxpath"].as<uint64_t>();
+            return 1;
         }
-        else
-        {
-            std::cerr << "maxpath required when reading continuously" << std::endl;
-            exit(1);
-        }
-        return ret;
+        return PARSE_CONTINUE;
     }
     else
     {
         ret.count_paths = false;
     }
-#endif
 
     ret.num_threads = parsed["threads"].as<uint16_t>();
     ret.max_total = parsed["maxtot"].as<int32_t>();
@@ -145,7 +147,7 @@ ParsedArguments ParsedArguments::Parse(int argc, char **argv)
             std::cerr << "ERROR: timeout must be positive" << std::endl;
             std::cerr << std::endl;
             std::cerr << options.help() << std::endl;
-            exit(1);
+            return 1;
         }
     }
 
@@ -180,11 +182,21 @@ ParsedArguments ParsedArguments::Parse(int argc, char **argv)
             std::cerr << "ERROR: etimeout must be positive" << std::endl;
             std::cerr << std::endl;
             std::cerr << options.help() << std::endl;
-            exit(1);
+            return 1;
         }
     }
 
     regulator::flags::FLAG_debug = parsed["debug"].as<bool>();
+    regulator::flags::FLAG_dense_edges = parsed["dense-edges"].as<bool>();
+    regulator::flags::FLAG_fresh_subjects = parsed["fresh-subjects"].as<bool>();
+    regulator::flags::FLAG_exec_budget = parsed["exec-budget"].as<int32_t>();
+    regulator::flags::FLAG_exec_timeout_ms = parsed["exec-timeout"].as<uint32_t>();
+
+    if (regulator::flags::FLAG_exec_budget < 0)
+    {
+        std::cerr << "ERROR: exec-budget must not be negative" << std::endl;
+        return 1;
+    }
 
     std::string lengths = parsed["lengths"].as<std::string>();
     size_t next_search_idx = 0;
@@ -214,7 +226,7 @@ ParsedArguments ParsedArguments::Parse(int argc, char **argv)
         std::cerr << "ERROR: regexp is required" << std::endl;
         std::cerr << std::endl;
         std::cerr << options.help() << std::endl;
-        exit(1);
+        return 1;
     }
 
     if (ret.strlens.size() == 0)
@@ -222,7 +234,7 @@ ParsedArguments ParsedArguments::Parse(int argc, char **argv)
         std::cerr << "ERROR: lengths was missing" << std::endl;
         std::cerr << std::endl;
         std::cerr << options.help() << std::endl;
-        exit(1);
+        return 1;
     }
 
     // ensure that the lengths are reasonable
@@ -233,20 +245,42 @@ ParsedArguments ParsedArguments::Parse(int argc, char **argv)
             std::cerr << "ERROR: the length is not supported: " << ret.strlens[i] << std::endl;
             std::cerr << std::endl;
             std::cerr << options.help() << std::endl;
-            exit(1);
+            return 1;
         }
     }
 
-    uint32_t seed = parsed["seed"].as<uint32_t>();
-    if (seed > 0)
+    ret.seed = parsed["seed"].as<uint32_t>();
+    if (regulator::flags::FLAG_debug)
     {
-        if (regulator::flags::FLAG_debug)
-        {
-            std::cout << "DEBUG Seeding random number generator with " << seed << std::endl;
-        }
-        srand(seed);
+        std::cout << "DEBUG Seeding random number generators with " << ret.seed << std::endl;
     }
 
+    return PARSE_CONTINUE;
+}
+
+
+int ParsedArguments::TryParse(int argc, char **argv, ParsedArguments &out)
+{
+    try
+    {
+        return parse_arguments(argc, argv, out);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "ERROR: could not parse arguments: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+
+ParsedArguments ParsedArguments::Parse(int argc, char **argv)
+{
+    ParsedArguments ret;
+    const int status = TryParse(argc, argv, ret);
+    if (status != PARSE_CONTINUE)
+    {
+        exit(status);
+    }
     return ret;
 }
 
@@ -14,6 +14,11 @@
 namespace regulator
 {
 
+/**
+ * Returned by ParsedArguments::TryParse when the program should go on
+ */
+static const int PARSE_CONTINUE = -1;
+
 /**
  * Holds details about parsed command-line arguments
  */
@@ -34,10 +39,17 @@ public:
      */
     std::string flags;
 
-#if defined REG_COUNT_PATHLENGTH
+    /**
+     * Serve jobs from stdin instead of running one (see zygote.hpp);
+     * no other field is set
+     */
+    bool zygote;
+
+    /**
+     * Read base64 subjects from stdin and print each one's path length,
+     * instead of fuzzing
+     */
     bool count_paths;
-    uint64_t max_path;
-#endif
 
     /**
      * The string length to fuzz
@@ -64,6 +76,12 @@ public:
      */
     uint16_t num_threads;
 
+    /**
+     * Seed for the random number generators; each fuzz campaign
+     * derives its own generator from this
+     */
+    uint32_t seed;
+
     /**
      * Timeout, in number of seconds, for the entire fuzz campaign.
      * 
@@ -87,9 +105,17 @@ public:
     int32_t individual_timeout_secs;
 
     /**
-     * Parses command-line arguments
+     * Parses command-line arguments; exits if the program should not go on
+     * (on --help, --version, or malformed arguments)
      */
     static ParsedArguments Parse(int argc, char **argv);
+
+    /**
+     * Parses command-line arguments into `out` without exiting. Returns
+     * PARSE_CONTINUE, or else the status the program should exit with
+     * (its messages already printed).
+     */
+    static int TryParse(int argc, char **argv, ParsedArguments &out);
 };
 
 
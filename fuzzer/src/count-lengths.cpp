@@ -5,11 +5,8 @@
 using namespace std;
 using namespace regulator::executor;
 
-#if defined REG_COUNT_PATHLENGTH
-
 void regulator::loop_count_lengths(regulator::ParsedArguments &args, regulator::executor::V8RegExp &regexp, int width)
 {
-    args.count_paths;
     V8RegExpResult result;
     for (std::string line; std::getline(std::cin, line);)
     {
@@ -30,8 +27,8 @@ void regulator::loop_count_lengths(regulator::ParsedArguments &args, regulator::
                 buflen,
                 result,
                 -1,
-                args.max_path,
-                kOnlyOneByte
+                kOnlyOneByte,
+                regulator::fuzz::kInstrumentPathLength
             );
             std::cout << "TOTCOUNT " << result.coverage_tracker->PathLength() << std::endl;
             delete[] buf;
@@ -53,12 +50,11 @@ void regulator::loop_count_lengths(regulator::ParsedArguments &args, regulator::
                 buflen,
                 result,
                 -1,
-                args.max_path,
-                kOnlyTwoByte
+                kOnlyTwoByte,
+                regulator::fuzz::kInstrumentPathLength
             );
             std::cout << "TOTCOUNT " << result.coverage_tracker->PathLength() << std::endl;
             delete[] buf;
         }
     }
 }
-#endif
@@ -0,0 +1,163 @@
+#include "edge-finder.hpp"
+#include "regexp-executor.hpp"
+#include "flags.hpp"
+
+#include "src/regexp/regexp-bytecodes.h"
+#include "src/objects/fixed-array.h"
+#include "src/objects/fixed-array-inl.h"
+
+#include <vector>
+#include <iostream>
+
+namespace e = regulator::executor;
+
+namespace regulator
+{
+namespace fuzz
+{
+
+bool FindEdges(
+    e::V8RegExp &regexp,
+    bool is_one_byte,
+    edge_list_t &out,
+    size_t &code_length_out)
+{
+    v8::internal::Object bytecode = regexp.regexp->Bytecode(is_one_byte);
+    if (!bytecode.IsByteArray())
+    {
+        std::cerr << "Regexp is not compiled to bytecode, cannot find edges" << std::endl;
+        return false;
+    }
+
+    v8::internal::ByteArray ba = v8::internal::ByteArray::cast(bytecode);
+
+    const uint8_t *code_start = ba.GetDataStartAddress();
+    const uint8_t *code_end = ba.GetDataEndAddress();
+    code_length_out = code_end - code_start;
+
+    // POP_BT may return to any target pushed by PUSH_BT, so collect
+    // those first and connect them at the end
+    std::vector<uint32_t> backtrack_targets;
+    std::vector<uint32_t> pop_bt_sites;
+
+    const uint8_t *pc = code_start;
+
+    while (pc < code_end)
+    {
+#define LOAD32(__off) (*reinterpret_cast<const uint32_t *>(pc + (__off)))
+#define ADD_EDGE(__dst) out.push_back(std::make_pair(offset, static_cast<uint32_t>(__dst)))
+        int32_t instruction = *reinterpret_cast<const int32_t *>(pc);
+        const uint32_t offset = static_cast<uint32_t>(pc - code_start);
+
+        // NOTE: this must mirror the Cover() calls in regexp-interpreter.cc;
+        // a branch which falls through is reported as a self-edge.
+
+        switch (instruction & v8::internal::BYTECODE_MASK)
+        {
+        case v8::internal::BC_GOTO:
+        case v8::internal::BC_ADVANCE_CP_AND_GOTO:
+            ADD_EDGE(LOAD32(4));
+            break;
+        case v8::internal::BC_PUSH_BT:
+            ADD_EDGE(offset);
+            backtrack_targets.push_back(LOAD32(4));
+            break;
+        case v8::internal::BC_POP_BT:
+            pop_bt_sites.push_back(offset);
+            break;
+        case v8::internal::BC_CHECK_GREEDY:
+        case v8::internal::BC_LOAD_CURRENT_CHAR:
+        case v8::internal::BC_LOAD_2_CURRENT_CHARS:
+        case v8::internal::BC_LOAD_4_CURRENT_CHARS:
+        case v8::internal::BC_CHECK_CHAR:
+        case v8::internal::BC_CHECK_NOT_CHAR:
+        case v8::internal::BC_CHECK_BIT_IN_TABLE:
+        case v8::internal::BC_CHECK_LT:
+        case v8::internal::BC_CHECK_GT:
+        case v8::internal::BC_CHECK_REGISTER_EQ_POS:
+        case v8::internal::BC_CHECK_NOT_BACK_REF:
+        case v8::internal::BC_CHECK_NOT_BACK_REF_BACKWARD:
+        case v8::internal::BC_CHECK_NOT_BACK_REF_NO_CASE:
+        case v8::internal::BC_CHECK_NOT_BACK_REF_NO_CASE_BACKWARD:
+        case v8::internal::BC_CHECK_AT_START:
+        case v8::internal::BC_CHECK_NOT_AT_START:
+        case v8::internal::BC_CHECK_CURRENT_POSITION:
+            ADD_EDGE(offset);
+            ADD_EDGE(LOAD32(4));
+            break;
+        case v8::internal::BC_CHECK_4_CHARS:
+        case v8::internal::BC_CHECK_NOT_4_CHARS:
+        case v8::internal::BC_AND_CHECK_CHAR:
+        case v8::internal::BC_AND_CHECK_NOT_CHAR:
+        case v8::internal::BC_MINUS_AND_CHECK_NOT_CHAR:
+        case v8::internal::BC_CHECK_CHAR_IN_RANGE:
+        case v8::internal::BC_CHECK_CHAR_NOT_IN_RANGE:
+        case v8::internal::BC_CHECK_REGISTER_LT:
+        case v8::internal::BC_CHECK_REGISTER_GE:
+        case v8::internal::BC_CHECK_NOT_REGS_EQUAL:
+            ADD_EDGE(offset);
+            ADD_EDGE(LOAD32(8));
+            break;
+        case v8::internal::BC_AND_CHECK_4_CHARS:
+        case v8::internal::BC_AND_CHECK_NOT_4_CHARS:
+            ADD_EDGE(offset);
+            ADD_EDGE(LOAD32(12));
+            break;
+        case v8::internal::BC_SKIP_UNTIL_CHAR:
+            ADD_EDGE(offset);
+            ADD_EDGE(LOAD32(8));
+            ADD_EDGE(LOAD32(12));
+            break;
+        case v8::internal::BC_SKIP_UNTIL_CHAR_AND:
+            ADD_EDGE(offset);
+            ADD_EDGE(LOAD32(16));
+            ADD_EDGE(LOAD32(20));
+            break;
+        case v8::internal::BC_SKIP_UNTIL_CHAR_POS_CHECKED:
+        case v8::internal::BC_SKIP_UNTIL_CHAR_OR_CHAR:
+            ADD_EDGE(offset);
+            ADD_EDGE(LOAD32(12));
+            ADD_EDGE(LOAD32(16));
+            break;
+        case v8::internal::BC_SKIP_UNTIL_BIT_IN_TABLE:
+        case v8::internal::BC_SKIP_UNTIL_GT_OR_NOT_BIT_IN_TABLE:
+            ADD_EDGE(offset);
+            ADD_EDGE(LOAD32(24));
+            ADD_EDGE(LOAD32(28));
+            break;
+        default:
+            break;
+        }
+
+        pc += v8::internal::RegExpBytecodeLength(instruction & v8::internal::BYTECODE_MASK);
+#undef ADD_EDGE
+#undef LOAD32
+    }
+
+    if (pop_bt_sites.size() * backtrack_targets.size() > MAX_BACKTRACK_EDGES)
+    {
+        std::cerr << "Too many backtrack edges (" << pop_bt_sites.size() << " POP_BT x "
+            << backtrack_targets.size() << " PUSH_BT), cannot index edges" << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < pop_bt_sites.size(); i++)
+    {
+        for (size_t j = 0; j < backtrack_targets.size(); j++)
+        {
+            out.push_back(std::make_pair(pop_bt_sites[i], backtrack_targets[j]));
+        }
+    }
+
+    if (regulator::flags::FLAG_debug)
+    {
+        std::cout << "DEBUG found " << out.size() << " edges in "
+            << (is_one_byte ? 1 : 2) << "-byte bytecode ("
+            << code_length_out << " bytes)" << std::endl;
+    }
+
+    return true;
+}
+
+} // namespace fuzz
+} // namespace regulator
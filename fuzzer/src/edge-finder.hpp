@@ -0,0 +1,42 @@
+// edge-finder.hpp
+//
+// Finds all branch transitions (edges) in compiled regexp
+// bytecode, for use with regulator::fuzz::EdgeIndex
+//
+
+#pragma once
+
+#include <vector>
+
+#include "regexp-executor.hpp"
+#include "fuzz/edge-index.hpp"
+
+namespace regulator
+{
+namespace fuzz
+{
+
+/**
+ * Every POP_BT may return to every PUSH_BT target, so the number of
+ * backtrack edges grows quadratically; give up indexing past this many.
+ */
+const size_t MAX_BACKTRACK_EDGES = 1 << 20;
+
+/**
+ * Scans the regexp's compiled bytecode (one-byte or two-byte) and records
+ * every (branch offset, successor offset) pair that the instrumented
+ * interpreter may report to CoverageTracker::Cover().
+ *
+ * The regexp must already be compiled for the requested width.
+ *
+ * Returns True on success, otherwise False
+ */
+bool FindEdges(
+    regulator::executor::V8RegExp &regexp,
+    bool is_one_byte,
+    edge_list_t &out,
+    size_t &code_length_out
+);
+
+}
+}
@@ -6,5 +6,9 @@ namespace flags
 {
 uint64_t FLAG_timeout = 0;
 bool FLAG_debug = false;
+bool FLAG_dense_edges = false;
+bool FLAG_fresh_subjects = false;
+int32_t FLAG_exec_budget = 1000000000;
+uint32_t FLAG_exec_timeout_ms = 0;
 }
 }
\ No newline at end of file
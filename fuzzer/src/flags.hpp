@@ -18,5 +18,29 @@ namespace flags
  */
 extern bool FLAG_debug;
 
+/**
+ * Gives each bytecode edge its own coverage-map slot instead of
+ * hashing branch offsets into a fixed-size map
+ */
+extern bool FLAG_dense_edges;
+
+/**
+ * Allocates a new V8 heap string for every execution instead of
+ * overwriting a reusable external subject string
+ */
+extern bool FLAG_fresh_subjects;
+
+/**
+ * The most branches (coverage Total) one execution may take when no
+ * max_total is given; 0 for no limit
+ */
+extern int32_t FLAG_exec_budget;
+
+/**
+ * Wall-clock limit for one execution while fuzzing, in milliseconds;
+ * 0 for no limit
+ */
+extern uint32_t FLAG_exec_timeout_ms;
+
 }
 }
\ No newline at end of file
@@ -3,20 +3,23 @@
 #include "fuzz-driver.hpp"
 
 #include "fuzz/corpus.hpp"
+#include "fuzz/helper-pool.hpp"
+#include "fuzz/input-cache.hpp"
+#include "fuzz/slice-allocator.hpp"
 #include "fuzz/work-queue.hpp"
+#include "fuzz/work-stealing-deque.hpp"
 
 #include "regexp-executor.hpp"
 #include "interesting-char-finder.hpp"
 #include "flags.hpp"
 
+#include <atomic>
 #include <memory>
 #include <cstring>
 #include <random>
 #include <chrono>
 #include <iostream>
 #include <iomanip>
-#include <mutex>
-#include <condition_variable>
 #include <thread>
 
 
@@ -34,26 +37,102 @@ namespace fuzz
 static const size_t N_CHILDREN_PER_PARENT = 200;
 
 
+/**
+ * The number of children evaluated per task when a campaign's children
+ * are spread over helper threads
+ */
+static const size_t N_CHILDREN_PER_HELPER_TASK = 8;
+
+
+/**
+ * True if `code` means the execution was stopped early -- by the default
+ * execution budget or the watchdog -- with partial coverage. Such an
+ * input is slow by construction, so it is a finding, not a failure.
+ */
+inline bool was_cut_short(regulator::executor::Result code)
+{
+    return code == regulator::executor::kBudgetExhausted ||
+        code == regulator::executor::kTimedOut;
+}
+
+
+/**
+ * The width-independent part of a FuzzCampaign; this is what the
+ * scheduler hands out to worker threads.
+ */
+class FuzzCampaignBase
+{
+public:
+    FuzzCampaignBase()
+        : exec_since_last_progress(std::chrono::seconds(0)),
+          slot(0),
+          slice_reward(0),
+          last_slice(std::chrono::seconds(0))
+        {};
+    virtual ~FuzzCampaignBase()
+    {
+    }
+
+    /**
+     * Works on the campaign for a time slice of length `slice`. Returns
+     * false when fuzzing must stop (see work_on_campaign).
+     */
+    virtual bool WorkSlice(HelperPool *helpers, std::chrono::steady_clock::duration slice) = 0;
+
+    /**
+     * Prints the campaign's status if that is due (see work_interrupt)
+     */
+    virtual void Interrupt() = 0;
+
+    /**
+     * How much active work-time has passed since the last time
+     * the corpus expanded.
+     */
+    std::chrono::steady_clock::duration exec_since_last_progress;
+
+    /**
+     * This campaign's index in the SliceAllocator
+     */
+    size_t slot;
+
+    /**
+     * The progress made during the latest work slice (see
+     * SLICE_REWARD_NEW_ENTRY and SLICE_REWARD_NEW_MAXIMUM)
+     */
+    double slice_reward;
+
+    /**
+     * The length of the latest work slice
+     */
+    std::chrono::steady_clock::duration last_slice;
+};
+
+
 /**
  * Represents the in-progress information about a fuzzing campaign.
  */
 template<typename Char>
-class FuzzCampaign
+class FuzzCampaign : public FuzzCampaignBase
 {
 public:
-    FuzzCampaign(size_t strlen, regulator::executor::V8RegExp *regexp)
+    FuzzCampaign(size_t strlen, regulator::executor::V8RegExp *regexp, uint64_t seed)
         : executions_since_last_render(0),
           num_generations(0),
+          n_cut_short(0),
           regexp(regexp),
           strlen(strlen),
           max_total(0),
+          corpus(regexp->edge_index.get(), seed),
           last_screen_render(std::chrono::steady_clock::now() - std::chrono::hours(100)),
-          exec_since_last_progress(std::chrono::seconds(0)),
           exec_overall(std::chrono::seconds(0))
         {};
     ~FuzzCampaign()
     {
     }
+
+    bool WorkSlice(HelperPool *helpers, std::chrono::steady_clock::duration slice) override;
+
+    void Interrupt() override;
 #ifdef REG_PROFILE
     /**
      * Amount of time spent executing regexp since last render
@@ -71,12 +150,6 @@ public:
     std::chrono::steady_clock::duration econo_dur;
 #endif // REG_PROFILE
 
-    /**
-     * How much active work-time has passed since the last time
-     * the corpus expanded.
-     */
-    std::chrono::steady_clock::duration exec_since_last_progress;
-
     /**
      * How much active work-time has passed in total.
      */
@@ -110,6 +183,11 @@ public:
      */
     uintmax_t num_generations;
 
+    /**
+     * The number of executions stopped early (see was_cut_short)
+     */
+    uintmax_t n_cut_short;
+
     /**
      * The queue of parents to fuzz
      */
@@ -119,35 +197,57 @@ public:
      * When the last screen render occurred
      */
     std::chrono::steady_clock::time_point last_screen_render;
-};
 
+    /**
+     * The children of the parent being evaluated, as edits against it
+     * (see evaluate_children)
+     */
+    ChildEdits<Char> batch_children;
 
-/**
- * A linked-list element which holds a fuzz campaign description.
- */
-struct fuzz_campaign_ll {
     /**
-     * Previous linked-list element
+     * A materialized child, on its way into the corpus
      */
-    struct fuzz_campaign_ll *prev;
+    std::vector<Char> kept_child;
 
     /**
-     * Next linked-list element
+     * Hashes of inputs which recently ran to completion; each batch of
+     * children is rid of repeats and of those before execution
      */
-    struct fuzz_campaign_ll *next;
+    InputCache input_cache;
 
     /**
-     * A pointer to either a FuzzCampaign<uint8_t> or a
-     * FuzzCampaign<uint16_t> ... consult `is_one_byte`
-     * to disambiguate.
+     * Execution outcome of each child in `batch_children`
      */
-    void *campaign;
+    std::vector<regulator::executor::V8RegExpResult> batch_results;
+    std::vector<regulator::executor::Result> batch_result_codes;
 
     /**
-     * True when this is a 8-bit Char, False when it is
-     * 16-bit Char.
+     * Whether each child in `batch_children` survived the helpers'
+     * pre-filter (always 1 without helpers)
      */
-    bool is_one_byte;
+    std::vector<uint8_t> batch_keep;
+};
+
+
+/**
+ * Statistics about one worker thread's scheduling overhead
+ */
+struct scheduler_stats
+{
+    /**
+     * Time spent looking for a campaign to work on
+     */
+    std::chrono::steady_clock::duration acquire_time;
+
+    /**
+     * The number of work slices performed
+     */
+    uint64_t n_slices;
+
+    /**
+     * The number of campaigns taken from another worker's deque
+     */
+    uint64_t n_steals;
 };
 
 
@@ -166,13 +266,21 @@ typedef struct {
     std::chrono::steady_clock::time_point deadline;
 
     /**
-     * A linked-list of campaigns to work on
+     * One deque of campaigns per worker thread. A worker takes campaigns
+     * from its own deque first and steals from the others when that is
+     * empty.
      */
-    struct fuzz_campaign_ll *work_ll;
+    std::vector<std::unique_ptr<WorkStealingDeque<FuzzCampaignBase *>>> deques;
 
-    std::mutex global_mutex;
+    /**
+     * Per-worker scheduling statistics, indexed like `deques`
+     */
+    std::vector<struct scheduler_stats> stats;
 
-    std::condition_variable work_ll_waiter;
+    /**
+     * Decides how long each campaign's work slices are
+     */
+    std::unique_ptr<SliceAllocator> slices;
 
     std::chrono::steady_clock::duration individual_timeout;
 
@@ -183,12 +291,18 @@ typedef struct {
      * to indicate when all worker-threads should quit because
      * no work remains.
      */
-    size_t n_active_campaigns;
+    std::atomic<size_t> n_active_campaigns;
 
     /**
      * When true, the fuzzing loop should exit as soon as possible
      */
     bool exit_requested;
+
+    /**
+     * Threads left over when there are fewer campaigns than threads;
+     * they help evaluate children. Null if there are none.
+     */
+    HelperPool *helpers;
 } fuzz_global_context;
 
 
@@ -257,6 +371,19 @@ inline void work_interrupt(FuzzCampaign<Char> *campaign)
             to_print << "residency=";
             to_print << std::setprecision(4) << std::setw(5) << std::setfill(' ') << residency
                 << "% ";
+
+            to_print << "slice="
+                << std::chrono::duration_cast<std::chrono::milliseconds>(campaign->last_slice).count()
+                << "ms ";
+
+            to_print << "cut-short=" << campaign->n_cut_short << " ";
+
+            const uintmax_t lookups = campaign->input_cache.Lookups();
+            const double hit_rate = lookups == 0
+                ? 0
+                : campaign->input_cache.Hits() * 100.0 / lookups;
+            to_print << "dup-skipped=" << campaign->input_cache.Hits() << "/" << lookups
+                << " (" << std::setprecision(3) << hit_rate << "%) ";
         }
 
         campaign->last_screen_render = now;
@@ -300,23 +427,21 @@ inline bool seed_corpus(
         strlen,
         result,
         -1,
-#if defined REG_COUNT_PATHLENGTH
-        UINT64_MAX,
-#endif
         regulator::executor::kOnlyOneByte
     );
 
-    if (result_code != regulator::executor::kSuccess)
+    if (result_code != regulator::executor::kSuccess && !was_cut_short(result_code))
     {
         std::cout << "Baseline execution failed!!!" << std::endl;
         return false;
     }
 
-    CorpusEntry<Char> *entry = new CorpusEntry<Char>(
+    CorpusEntry<Char> *entry = corpus.NewEntry(
         baseline,
         strlen,
         new CoverageTracker(*result.coverage_tracker.get())
     );
+    delete[] baseline;
 
     corpus.Record(entry);
 
@@ -346,23 +471,21 @@ inline bool seed_corpus(
             strlen,
             result,
             -1,
-#if defined REG_COUNT_PATHLENGTH
-            UINT64_MAX,
-#endif
             regulator::executor::kOnlyOneByte
         );
 
-        if (result_code != regulator::executor::kSuccess)
+        if (result_code != regulator::executor::kSuccess && !was_cut_short(result_code))
         {
             std::cout << "Baseline execution failed!!!" << std::endl;
             return false;
         }
 
-        CorpusEntry<Char> *entry = new CorpusEntry<Char>(
+        CorpusEntry<Char> *entry = corpus.NewEntry(
             buf,
             strlen,
             new CoverageTracker(*result.coverage_tracker.get())
         );
+        delete[] buf;
 
         corpus.Record(entry);
     }
@@ -374,20 +497,20 @@ inline bool seed_corpus(
 
 
 /**
- * Make a FuzzCampaign object, seed it, and add it to the linked-list
- * of campaigns.
+ * Make a FuzzCampaign object, seed it, and add it to `campaigns`.
  *
  * Returns false when creation or seed fails.
  */
 template <typename Char>
 inline bool make_campaign(
-    struct fuzz_campaign_ll *&head,
+    std::vector<FuzzCampaignBase *> &campaigns,
     regulator::executor::V8RegExp *regexp,
     size_t strlen,
     std::vector<std::string> &seeds,
-    int32_t max_total)
+    int32_t max_total,
+    uint64_t rng_seed)
 {
-    FuzzCampaign<Char> *campaign_out = new FuzzCampaign<Char>(strlen, regexp);
+    FuzzCampaign<Char> *campaign_out = new FuzzCampaign<Char>(strlen, regexp, rng_seed);
     campaign_out->max_total = max_total;
 
     if (!seed_corpus(campaign_out->corpus, regexp, strlen, seeds))
@@ -409,126 +532,180 @@ inline bool make_campaign(
     }
     campaign_out->corpus.SetInteresting(interesting);
 
-    struct fuzz_campaign_ll *new_elem = new fuzz_campaign_ll;
-    new_elem->campaign = campaign_out;
-    new_elem->is_one_byte = sizeof(Char) == 1;
-
-    // add the new linked-list elem to the circular linked list
-    if (head == nullptr)
-    {
-        head = new_elem;
-        new_elem->next = new_elem;
-        new_elem->prev = new_elem;
-    }
-    else
-    {
-        //
-        // +-- new_elem <-----+
-        // |                  |
-        // +---> HEAD ---> <stuff>
-        //
-        new_elem->next = head;
-        new_elem->prev = head->prev;
-        head->prev->next = new_elem;
-        head->prev = new_elem;
-    }
+    campaigns.push_back(campaign_out);
 
     return true;
 }
 
 
 /**
- * Evaluate a child solution on a given regexp and evaluate
- * whether it is worth keeping. If so the new CorpusEntry
- * is returned, and the known-worst entry is updated.
+ * Evaluate the children of one parent, which GenerateChildren() put in the
+ * campaign's batch edits, and record those worth keeping in the corpus.
+ * Returns false when the maximum Total was reached.
+ *
+ * The children are executed from their edits with ExecBatch -- on this
+ * thread, or split across the helper threads if there are any. Helpers
+ * only execute children and pre-filter them against the corpus; that is
+ * read-only, because the corpus only changes (at Record(), and at
+ * FlushGeneration()) once the helpers are done. The survivors are then
+ * evaluated and recorded by this thread in child order, so the corpus
+ * ends up exactly as if the children had been evaluated serially. A
+ * child whose path an earlier child already recorded is redundant, so it
+ * gets no entry.
  */
 template<typename Char>
-inline bool evaluate_child(
-    Char *child,
-    size_t strlen,
-    regulator::executor::V8RegExp *regexp,
-    regulator::executor::V8RegExpResult &result, // share this memory to avoid re-allocing all the time
+inline bool evaluate_children(
     FuzzCampaign<Char> *campaign,
-    CorpusEntry<Char> *parent)
+    HelperPool *helpers)
 {
-#ifdef REG_PROFILE
-    std::chrono::steady_clock::time_point exec_start = std::chrono::steady_clock::now();
-#endif
     constexpr auto enforce_encoding =
         sizeof(Char) == 1
         ? regulator::executor::kOnlyOneByte
         : regulator::executor::kOnlyTwoByte;
 
-    regulator::executor::Result result_code = regulator::executor::Exec(
-        regexp,
-        child,
-        strlen,
-        result,
-        campaign->max_total,
-#if defined REG_COUNT_PATHLENGTH
-        UINT64_MAX,
-#endif
-        enforce_encoding
-    );
+    const size_t strlen = campaign->strlen;
+    const size_t n_children = campaign->batch_children.Size();
+
+    while (campaign->batch_results.size() < n_children)
+    {
+        campaign->batch_results.emplace_back(strlen);
+    }
+    campaign->batch_result_codes.resize(n_children);
+    campaign->batch_keep.assign(n_children, 1);
 
 #ifdef REG_PROFILE
-    campaign->exec_dur += (std::chrono::steady_clock::now() - exec_start);
+    std::chrono::steady_clock::time_point exec_start = std::chrono::steady_clock::now();
 #endif
 
-    if (result_code == regulator::executor::kSuccess)
+    if (helpers == nullptr)
     {
-        // Execution succeeded, proceed to analyze how 'good' this was
-        campaign->executions_since_last_render++;
+        regulator::executor::ExecBatch(
+            campaign->regexp,
+            campaign->batch_children,
+            0,
+            n_children,
+            campaign->batch_results.data(),
+            campaign->batch_result_codes.data(),
+            campaign->max_total,
+            enforce_encoding
+        );
+    }
+    else
+    {
+        const size_t n_tasks = (n_children + N_CHILDREN_PER_HELPER_TASK - 1) / N_CHILDREN_PER_HELPER_TASK;
 
-        result.coverage_tracker->Bucketize();
+        helpers->Run(n_tasks, [&](size_t task) {
+            const size_t begin = task * N_CHILDREN_PER_HELPER_TASK;
+            const size_t end = std::min(n_children, begin + N_CHILDREN_PER_HELPER_TASK);
 
-        // If this child uncovered new behavior, then add it to new_children
-        // (later added to corpus, which assumes ownership)
-        if (
-                campaign->corpus.HasNewPath(result.coverage_tracker.get()) &&
-                !campaign->corpus.IsRedundant(result.coverage_tracker.get())
-            )
-        {
-            campaign->corpus.BumpStaleness(result.coverage_tracker.get());
-
-            campaign->corpus.Record(
-                new CorpusEntry<Char>(
-                    child,
-                    strlen,
-                    new CoverageTracker(*result.coverage_tracker.get())
-                )
+            regulator::executor::ExecBatch(
+                campaign->regexp,
+                campaign->batch_children,
+                begin,
+                end,
+                &campaign->batch_results[begin],
+                &campaign->batch_result_codes[begin],
+                campaign->max_total,
+                enforce_encoding
             );
 
-            return true;
-        }
+            for (size_t i = begin; i < end; i++)
+            {
+                CoverageTracker *tracker = campaign->batch_results[i].coverage_tracker.get();
+                campaign->batch_keep[i] =
+                    campaign->batch_result_codes[i] != regulator::executor::kSuccess ||
+                    (
+                        campaign->corpus.HasNewPath(tracker) &&
+                        !campaign->corpus.IsRedundant(tracker)
+                    );
+            }
+        });
     }
-    else if (result_code == regulator::executor::kViolateMaxTotal)
+
+#ifdef REG_PROFILE
+    campaign->exec_dur += (std::chrono::steady_clock::now() - exec_start);
+#endif
+
+    campaign->kept_child.resize(strlen);
+    Char *child = campaign->kept_child.data();
+
+    for (size_t i = 0; i < n_children; i++)
     {
-        std::cout << "Maximum Total reached: " << (
-            new CorpusEntry<Char>(
-                    child,
-                    strlen,
-                    new CoverageTracker(*result.coverage_tracker.get())
-                )
-            )->ToString();
-        return false;
+        std::unique_ptr<CoverageTracker> &tracker = campaign->batch_results[i].coverage_tracker;
+
+        if (campaign->batch_result_codes[i] == regulator::executor::kSuccess)
+        {
+            // Execution succeeded, proceed to analyze how 'good' this was
+            campaign->executions_since_last_render++;
+
+            // running it again would give the same coverage; inputs cut
+            // short are not remembered, they may finish next time
+            campaign->input_cache.Insert(campaign->batch_children.Hash(i));
+
+            if (campaign->batch_keep[i])
+            {
+                // If this child uncovered new behavior, then record it
+                // (the result gets a recycled tracker, or else ExecBatch
+                // gives it a new one next time)
+                struct novelty novelty = campaign->corpus.Evaluate(tracker.get());
+                if (novelty.has_new_path && !novelty.is_redundant)
+                {
+                    campaign->batch_children.Materialize(i, child);
+                    campaign->corpus.Record(
+                        campaign->corpus.NewEntry(child, strlen, tracker.release())
+                    );
+                    tracker.reset(campaign->corpus.TakeSpareTracker(strlen));
+                }
+            }
+        }
+        else if (was_cut_short(campaign->batch_result_codes[i]))
+        {
+            // Stopped early, but with as much coverage as it reached;
+            // keep it if that is new, and report it
+            campaign->n_cut_short++;
+            struct novelty novelty = campaign->corpus.Evaluate(tracker.get());
+            if (novelty.has_new_path && !novelty.is_redundant)
+            {
+                campaign->batch_children.Materialize(i, child);
+                CorpusEntry<Char> *entry = campaign->corpus.NewEntry(child, strlen, tracker.release());
+                tracker.reset(campaign->corpus.TakeSpareTracker(strlen));
+                std::cout << (
+                    campaign->batch_result_codes[i] == regulator::executor::kTimedOut
+                        ? "Execution timed out: "
+                        : "Execution budget exhausted: "
+                    ) << entry->ToString() << std::endl;
+                campaign->corpus.Record(entry);
+            }
+        }
+        else if (campaign->batch_result_codes[i] == regulator::executor::kViolateMaxTotal)
+        {
+            campaign->batch_children.Materialize(i, child);
+            std::cout << "Maximum Total reached: " << (
+                campaign->corpus.NewEntry(
+                        child,
+                        strlen,
+                        tracker.release()
+                    )
+                )->ToString();
+            return false;
+        }
     }
 
-    // No significance found in this child -- toss its memory
-    delete[] child;
     return true;
 }
 
 
 /**
- * Pass over the given Corpus exactly once
+ * Fuzz the campaign for (about) `slice`, tallying the progress made in
+ * `campaign->slice_reward`
  */
 template<typename Char>
-inline bool work_on_campaign(FuzzCampaign<Char> *campaign)
+inline bool work_on_campaign(
+    FuzzCampaign<Char> *campaign,
+    HelperPool *helpers,
+    std::chrono::steady_clock::duration slice)
 {
-    regulator::executor::V8RegExpResult result(campaign->strlen);
-    std::vector<Char *> children_to_eval;
-    auto yield_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    auto yield_deadline = std::chrono::steady_clock::now() + slice;
     auto start_time = std::chrono::steady_clock::now();
     auto last_progress_time_this_try = start_time;
 
@@ -539,6 +716,7 @@ inline bool work_on_campaign(FuzzCampaign<Char> *campaign)
         if (!campaign->work_queue.HasNext())
         {
             size_t prev_corpus_size = campaign->corpus.Size();
+            uint64_t prev_max_total = campaign->corpus.MaxOpcount()->GetCoverage()->Total();
 #ifdef REG_PROFILE
             std::chrono::steady_clock::time_point econo_start = std::chrono::steady_clock::now();
 #endif
@@ -552,6 +730,12 @@ inline bool work_on_campaign(FuzzCampaign<Char> *campaign)
                 // Reset all work-clocks because we added to the corpus and made progress
                 last_progress_time_this_try = std::chrono::steady_clock::now();
                 campaign->exec_since_last_progress = std::chrono::seconds(0);
+
+                campaign->slice_reward += SLICE_REWARD_NEW_ENTRY * (campaign->corpus.Size() - prev_corpus_size);
+                if (prev_max_total < campaign->corpus.MaxOpcount()->GetCoverage()->Total())
+                {
+                    campaign->slice_reward += SLICE_REWARD_NEW_MAXIMUM;
+                }
             }
 
             campaign->num_generations++;
@@ -565,33 +749,20 @@ inline bool work_on_campaign(FuzzCampaign<Char> *campaign)
 #ifdef REG_PROFILE
         std::chrono::steady_clock::time_point gen_start = std::chrono::steady_clock::now();
 #endif
-        children_to_eval.clear();
         campaign->corpus.GenerateChildren(
             parent,
             N_CHILDREN_PER_PARENT,
-            children_to_eval
+            campaign->batch_children
         );
+        campaign->input_cache.DropDuplicates(campaign->batch_children);
 #ifdef REG_PROFILE
         campaign->gen_child_dur += (std::chrono::steady_clock::now() - gen_start);
 #endif
 
         // Evaluate each child
-        for (size_t j = 0; j < children_to_eval.size(); j++)
+        if (!evaluate_children<Char>(campaign, helpers))
         {
-            Char *child = children_to_eval[j];
-
-            bool keep_going = evaluate_child<Char>(
-                child,
-                campaign->strlen,
-                campaign->regexp,
-                result,
-                campaign,
-                parent
-            );
-            if (!keep_going)
-            {
-                return false;
-            }
+            return false;
         }
     }
 
@@ -605,10 +776,55 @@ inline bool work_on_campaign(FuzzCampaign<Char> *campaign)
 }
 
 
+template<typename Char>
+bool FuzzCampaign<Char>::WorkSlice(HelperPool *helpers, std::chrono::steady_clock::duration slice)
+{
+    return work_on_campaign<Char>(this, helpers, slice);
+}
+
+
+template<typename Char>
+void FuzzCampaign<Char>::Interrupt()
+{
+    work_interrupt<Char>(this);
+}
+
+
+/**
+ * Takes a campaign for worker `me` to work on: the oldest one in its own
+ * deque, or else one stolen from another worker. Returns nullptr if no
+ * campaign is available right now.
+ */
+inline FuzzCampaignBase *take_campaign(fuzz_global_context *context, size_t me)
+{
+    FuzzCampaignBase *ret;
+
+    // Take from the top (oldest end) of our own deque, so that a worker
+    // round-robins over its campaigns rather than re-taking the one it
+    // just pushed back
+    if (context->deques[me]->Steal(ret))
+    {
+        return ret;
+    }
+
+    const size_t n_workers = context->deques.size();
+    for (size_t i = 1; i < n_workers; i++)
+    {
+        if (context->deques[(me + i) % n_workers]->Steal(ret))
+        {
+            context->stats[me].n_steals++;
+            return ret;
+        }
+    }
+
+    return nullptr;
+}
+
+
 /**
  * Entry point for a work thread
  */
-void do_work(fuzz_global_context *context)
+void do_work(fuzz_global_context *context, size_t me)
 {
     if (f::FLAG_debug)
     {
@@ -618,108 +834,55 @@ void do_work(fuzz_global_context *context)
 
     regulator::executor::Initialize();
 
+    struct scheduler_stats &stats = context->stats[me];
+
     while (context->deadline > std::chrono::steady_clock::now())
     {
         // get a campaign to work on
-        struct fuzz_campaign_ll *my_work;
-
+        auto acquire_start = std::chrono::steady_clock::now();
+        FuzzCampaignBase *campaign = take_campaign(context, me);
+        while (campaign == nullptr)
         {
-            std::unique_lock<std::mutex> lock(context->global_mutex);
-
-            while (context->work_ll == nullptr && context->n_active_campaigns > 0)
-            {
-                std::cout << "DEBUG thread "
-                    << std::hex << std::this_thread::get_id() << std::dec
-                    << " waiting"
-                    << std::endl;
-                context->work_ll_waiter.wait(lock);
-            }
-
-            if (context->n_active_campaigns == 0)
+            if (context->n_active_campaigns.load() == 0 ||
+                context->deadline <= std::chrono::steady_clock::now())
             {
                 // there's no more work to do, quit
+                stats.acquire_time += std::chrono::steady_clock::now() - acquire_start;
                 return;
             }
 
-
-            // take an item off the head
-            my_work = context->work_ll;
-
-            if (context->work_ll->next == context->work_ll)
-            {
-                // if this is the last thing in the work-list then set null
-                context->work_ll = nullptr;
-            }
-            else
-            {
-                // otherwise just re-rig the linked-list to delete head
-                context->work_ll = context->work_ll->next;
-                context->work_ll->prev = my_work->prev;
-                my_work->prev->next = my_work->next;
-            }
+            // every campaign is being worked on by someone else
+            std::this_thread::yield();
+            campaign = take_campaign(context, me);
         }
+        stats.acquire_time += std::chrono::steady_clock::now() - acquire_start;
+        stats.n_slices++;
+
+        // we have our campaign to work on, perform one unit of work,
+        // sized by how much progress the campaign has been making
+        campaign->last_slice = context->slices->SliceLength(campaign->slot);
+        campaign->slice_reward = 0;
+
+        auto slice_start = std::chrono::steady_clock::now();
+        bool keep_going = campaign->WorkSlice(context->helpers, campaign->last_slice);
+        context->slices->Report(
+            campaign->slot,
+            campaign->slice_reward,
+            std::chrono::steady_clock::now() - slice_start
+        );
+        campaign->Interrupt();
 
-        // we have our campaign to work on, perform one unit of work
-        bool should_quit_campaign;
-        if (my_work->is_one_byte)
-        {
-            auto campaign = reinterpret_cast<regulator::fuzz::FuzzCampaign<uint8_t> *>(my_work->campaign);
-            bool keep_going = work_on_campaign<uint8_t>(campaign);
-            work_interrupt(campaign);
+        bool should_quit_campaign = !keep_going || campaign->exec_since_last_progress > context->individual_timeout;
 
-            should_quit_campaign = !keep_going || campaign->exec_since_last_progress > context->individual_timeout;
-        }
-        else
+        // work completed, put the campaign back ONLY IF WE SHOULD NOT QUIT
+        if (!should_quit_campaign)
         {
-            auto campaign = reinterpret_cast<regulator::fuzz::FuzzCampaign<uint16_t> *>(my_work->campaign);
-            bool keep_going = work_on_campaign<uint16_t>(campaign);
-            work_interrupt(campaign);
-
-            should_quit_campaign = !keep_going || campaign->exec_since_last_progress > context->individual_timeout;
-        }
-
-        // work completed, put my_work back on the work_ll ONLY IF WE SHOULD NOT QUIT
-        if (!should_quit_campaign) {
-            std::unique_lock<std::mutex> lock(context->global_mutex);
-
-            if (context->work_ll == nullptr)
-            {
-                context->work_ll = my_work;
-                my_work->next = my_work;
-                my_work->prev = my_work;
-            }
-            else
-            {
-                // put my_work in head->prev
-                my_work->prev = context->work_ll->prev;
-                my_work->next = context->work_ll;
-                context->work_ll->prev->next = my_work;
-                context->work_ll->prev = my_work;
-            }
-
-            context->work_ll_waiter.notify_one();
+            context->deques[me]->Push(campaign);
         }
         else
         {
-            // [branch] should_quit_campaign == true
-
-            std::unique_lock<std::mutex> lock(context->global_mutex);
-            context->n_active_campaigns--;
-
-            if (context->n_active_campaigns == 0)
-            {
-                // if there's no more work to do, tell everyone
-                context->work_ll_waiter.notify_all();
-            }
-
-            if (my_work->is_one_byte)
-            {
-                delete reinterpret_cast<regulator::fuzz::FuzzCampaign<uint8_t> *>(my_work->campaign);
-            }
-            else
-            {
-                delete reinterpret_cast<regulator::fuzz::FuzzCampaign<uint16_t> *>(my_work->campaign);
-            }
+            delete campaign;
+            context->n_active_campaigns.fetch_sub(1);
         }
     }
 
@@ -740,12 +903,12 @@ uint64_t Fuzz(
     int32_t max_total,
     bool fuzz_one_byte,
     bool fuzz_two_byte,
-    uint16_t n_threads)
+    uint16_t n_threads,
+    uint32_t seed)
 {
     fuzz_global_context context;
 
     context.begin = std::chrono::steady_clock::now();
-    context.work_ll = nullptr;
     context.max_total = max_total;
 
     if (timeout_secs > 0)
@@ -768,6 +931,25 @@ uint64_t Fuzz(
         context.individual_timeout = std::chrono::seconds(60ul * 60ul * 24ul * 365ul * 10ul);
     }
 
+    // stop executions which run past the per-execution timeout or the
+    // deadline: the exec budget alone does not keep an execution within
+    // --timeout (a billion branches take minutes in a debug build). Arming
+    // costs two uncontended atomics, plus a clock read with --exec-timeout.
+    std::unique_ptr<regulator::executor::ExecWatchdog> watchdog;
+    if (timeout_secs > 0 || f::FLAG_exec_timeout_ms > 0)
+    {
+        watchdog = std::make_unique<regulator::executor::ExecWatchdog>(
+            std::chrono::milliseconds(f::FLAG_exec_timeout_ms),
+            context.deadline
+        );
+    }
+
+    std::vector<FuzzCampaignBase *> campaigns;
+
+    // each campaign gets its own generator, seeded from `seed` and the
+    // order in which campaigns are created
+    uint64_t campaign_id = 0;
+
     for (const size_t strlen : strlens)
     {
         if (fuzz_one_byte)
@@ -777,7 +959,8 @@ uint64_t Fuzz(
                 std::cout << "DEBUG adding 1-byte campaign for strlen " << std::dec << strlen << std::endl;
             }
 
-            if (!make_campaign<uint8_t>(context.work_ll, regexp, strlen, seeds, max_total))
+            uint64_t rng_seed = (static_cast<uint64_t>(seed) << 32) | campaign_id++;
+            if (!make_campaign<uint8_t>(campaigns, regexp, strlen, seeds, max_total, rng_seed))
             {
                 return 0;
             }
@@ -790,31 +973,69 @@ uint64_t Fuzz(
                 std::cout << "DEBUG adding 2-byte campaign for strlen " << std::dec << strlen << std::endl;
             }
 
-            if (!make_campaign<uint16_t>(context.work_ll, regexp, strlen, seeds, max_total))
+            uint64_t rng_seed = (static_cast<uint64_t>(seed) << 32) | campaign_id++;
+            if (!make_campaign<uint16_t>(campaigns, regexp, strlen, seeds, max_total, rng_seed))
             {
                 return 0;
             }
         }
     }
 
-    // count how many campaigns we have
-    context.n_active_campaigns = 1;
-    struct fuzz_campaign_ll *curr = context.work_ll;
-    for (; curr->next != context.work_ll; curr = curr->next, context.n_active_campaigns++);
+    context.n_active_campaigns = campaigns.size();
+
+    context.slices = std::make_unique<SliceAllocator>(campaigns.size());
+    for (size_t i=0; i < campaigns.size(); i++)
+    {
+        campaigns[i]->slot = i;
+    }
 
     if (f::FLAG_debug)
     {
-        std::cout << "DEBUG We have " << std::dec << context.n_active_campaigns << " fuzz campaigns" << std::endl;
+        std::cout << "DEBUG We have " << std::dec << campaigns.size() << " fuzz campaigns" << std::endl;
         std::cout << "DEBUG Baseline established. Proceeding to main work loop." << std::endl;
     }
 
-    // More threads than campaigns is meaningless
-    size_t threads_to_make = std::min(context.n_active_campaigns, static_cast<size_t>(n_threads));
+    // Each thread works on one campaign at a time, so any threads beyond
+    // the number of campaigns help evaluate children instead
+    size_t threads_to_make = std::min(campaigns.size(), static_cast<size_t>(n_threads));
+
+    std::unique_ptr<HelperPool> helpers;
+    context.helpers = nullptr;
+    if (n_threads > threads_to_make)
+    {
+        if (f::FLAG_debug)
+        {
+            std::cout << "DEBUG Using " << (n_threads - threads_to_make) << " helper threads" << std::endl;
+        }
+        helpers = std::make_unique<HelperPool>(
+            n_threads - threads_to_make,
+            []() { regulator::executor::Initialize(); }
+        );
+        context.helpers = helpers.get();
+    }
+
+    // deal the campaigns out over the workers' deques; any deque may
+    // end up holding every campaign
+    for (size_t i=0; i < threads_to_make; i++)
+    {
+        context.deques.push_back(
+            std::make_unique<WorkStealingDeque<FuzzCampaignBase *>>(campaigns.size())
+        );
+        struct scheduler_stats stats;
+        stats.acquire_time = std::chrono::steady_clock::duration::zero();
+        stats.n_slices = 0;
+        stats.n_steals = 0;
+        context.stats.push_back(stats);
+    }
+    for (size_t i=0; i < campaigns.size(); i++)
+    {
+        context.deques[i % threads_to_make]->Push(campaigns[i]);
+    }
 
     std::vector<std::thread *> work_threads;
     for (size_t i=0; i < threads_to_make; i++)
     {
-        std::thread *t = new std::thread(do_work, &context);
+        std::thread *t = new std::thread(do_work, &context, i);
         work_threads.push_back(t);
     }
 
@@ -823,6 +1044,30 @@ uint64_t Fuzz(
         work_threads[i]->join();
     }
 
+    if (f::FLAG_debug)
+    {
+        for (size_t i=0; i < context.stats.size(); i++)
+        {
+            double acquire_ms = std::chrono::duration_cast<std::chrono::microseconds>(
+                context.stats[i].acquire_time
+            ).count() / 1000.0;
+            std::cout << "DEBUG scheduler worker " << i << ": "
+                << context.stats[i].n_slices << " slices, "
+                << context.stats[i].n_steals << " steals, "
+                << std::setprecision(4) << acquire_ms << " ms acquiring work" << std::endl;
+        }
+    }
+
+    // campaigns which were still running at the deadline
+    for (size_t i=0; i < context.deques.size(); i++)
+    {
+        FuzzCampaignBase *campaign;
+        while (context.deques[i]->Pop(campaign))
+        {
+            delete campaign;
+        }
+    }
+
     return 1;
 }
 
@@ -21,6 +21,9 @@ namespace fuzz
  * @param individual_timeout_secs maximum time to spend on an individual string length without making progress
  * @param fuzz_one_byte when true, fuzz one-byte strings
  * @param fuzz_two_byte when true, fuzz two-byte strings
+ * @param n_threads the number of worker threads
+ * @param seed seed for the random number generators (each campaign
+ *             derives its own from this and its campaign id)
  * 
  * @returns the worst-case opcount
  */
@@ -34,7 +37,8 @@ uint64_t Fuzz(
     int32_t max_total,
     bool fuzz_one_byte = true,
     bool fuzz_two_byte = true,
-    uint16_t n_threads = 1
+    uint16_t n_threads = 1,
+    uint32_t seed = 0
 );
 
 }
@@ -0,0 +1,44 @@
+#include "backtrack-arena.hpp"
+
+#include <cstring>
+
+
+namespace regulator
+{
+namespace fuzz
+{
+
+BacktrackArena::BacktrackArena(size_t initial_capacity)
+{
+    this->capacity = initial_capacity;
+    if (initial_capacity > 0)
+    {
+        this->data.reset(new int[initial_capacity]);
+    }
+}
+
+
+void BacktrackArena::Grow(size_t min_capacity, size_t keep)
+{
+    if (min_capacity <= this->capacity)
+    {
+        return;
+    }
+
+    size_t new_capacity = this->capacity > 0 ? this->capacity : 64;
+    while (new_capacity < min_capacity)
+    {
+        new_capacity *= 2;
+    }
+
+    std::unique_ptr<int[]> new_data(new int[new_capacity]);
+    if (keep > 0)
+    {
+        memcpy(new_data.get(), this->data.get(), keep * sizeof(int));
+    }
+    this->data = std::move(new_data);
+    this->capacity = new_capacity;
+}
+
+}
+}
@@ -0,0 +1,55 @@
+// backtrack-arena.hpp
+//
+// Storage for the regexp interpreter's backtrack stack which
+// outlives a single execution.
+//
+// Catastrophic inputs push deep backtrack stacks. A stack
+// built afresh for each execution re-grows (and re-copies)
+// its storage every time; instead, each thread keeps one
+// arena and hands it to every execution. The arena never
+// shrinks, so it only grows while the deepest stack seen so
+// far keeps increasing -- in practice once per campaign.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+class BacktrackArena
+{
+public:
+    /**
+     * Creates an arena with room for `initial_capacity` entries; an
+     * empty arena allocates nothing until it first grows
+     */
+    BacktrackArena(size_t initial_capacity = 1024);
+
+    inline int *Data()
+    {
+        return this->data.get();
+    };
+
+    inline size_t Capacity() const
+    {
+        return this->capacity;
+    };
+
+    /**
+     * Grows to hold at least `min_capacity` entries, keeping the first
+     * `keep` of them. Invalidates Data().
+     */
+    void Grow(size_t min_capacity, size_t keep);
+
+private:
+    std::unique_ptr<int[]> data;
+    size_t capacity;
+};
+
+}
+}
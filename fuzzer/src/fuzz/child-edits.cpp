@@ -0,0 +1,147 @@
+#include "child-edits.hpp"
+#include "input-cache.hpp"
+
+#include <cstring>
+
+
+namespace regulator
+{
+namespace fuzz
+{
+
+template<typename Char>
+ChildEdits<Char>::ChildEdits()
+{
+    this->parent = nullptr;
+    this->buflen = 0;
+    this->parent_hash = 0;
+}
+
+
+template<typename Char>
+void ChildEdits<Char>::Reset(const Char *parent, size_t buflen)
+{
+    this->parent = parent;
+    this->buflen = buflen;
+    this->parent_hash = input_hash(parent, buflen);
+    this->draft.assign(parent, parent + buflen);
+    this->runs.clear();
+    this->chars.clear();
+    this->child_ends.clear();
+}
+
+
+template<typename Char>
+void ChildEdits<Char>::Commit(size_t begin, size_t end)
+{
+    Char *draft = this->draft.data();
+
+    size_t i = begin;
+    while (i < end)
+    {
+        if (draft[i] == this->parent[i])
+        {
+            i++;
+            continue;
+        }
+
+        struct run r;
+        r.pos = static_cast<uint32_t>(i);
+        r.offset = this->chars.size();
+        while (i < end && draft[i] != this->parent[i])
+        {
+            this->chars.push_back(draft[i]);
+            draft[i] = this->parent[i];
+            i++;
+        }
+        r.len = static_cast<uint32_t>(i - r.pos);
+        this->runs.push_back(r);
+    }
+
+    this->child_ends.push_back(this->runs.size());
+}
+
+
+template<typename Char>
+void ChildEdits<Char>::Apply(size_t i, Char *work) const
+{
+    for (size_t j = this->first_run(i); j < this->child_ends[i]; j++)
+    {
+        const struct run &r = this->runs[j];
+        memcpy(work + r.pos, &this->chars[r.offset], r.len * sizeof(Char));
+    }
+}
+
+
+template<typename Char>
+void ChildEdits<Char>::Revert(size_t i, Char *work) const
+{
+    for (size_t j = this->first_run(i); j < this->child_ends[i]; j++)
+    {
+        const struct run &r = this->runs[j];
+        memcpy(work + r.pos, this->parent + r.pos, r.len * sizeof(Char));
+    }
+}
+
+
+template<typename Char>
+void ChildEdits<Char>::Materialize(size_t i, Char *out) const
+{
+    memcpy(out, this->parent, this->buflen * sizeof(Char));
+    this->Apply(i, out);
+}
+
+
+template<typename Char>
+uint64_t ChildEdits<Char>::Hash(size_t i) const
+{
+    uint64_t ret = this->parent_hash;
+    for (size_t j = this->first_run(i); j < this->child_ends[i]; j++)
+    {
+        const struct run &r = this->runs[j];
+        for (size_t k = 0; k < r.len; k++)
+        {
+            ret ^= input_hash_term(r.pos + k, this->parent[r.pos + k]);
+            ret ^= input_hash_term(r.pos + k, this->chars[r.offset + k]);
+        }
+    }
+    return ret;
+}
+
+
+template<typename Char>
+void ChildEdits<Char>::Retain(const std::vector<uint8_t> &keep)
+{
+    size_t n_children = 0;
+    size_t n_runs = 0;
+    size_t n_chars = 0;
+    for (size_t i = 0; i < this->child_ends.size(); i++)
+    {
+        const size_t first = this->first_run(i);
+        const size_t end = this->child_ends[i];
+        if (keep[i])
+        {
+            // only ever moves entries towards the front
+            for (size_t j = first; j < end; j++)
+            {
+                struct run r = this->runs[j];
+                memmove(&this->chars[n_chars], &this->chars[r.offset], r.len * sizeof(Char));
+                r.offset = n_chars;
+                n_chars += r.len;
+                this->runs[n_runs++] = r;
+            }
+            this->child_ends[n_children++] = n_runs;
+        }
+    }
+
+    this->child_ends.resize(n_children);
+    this->runs.resize(n_runs);
+    this->chars.resize(n_chars);
+}
+
+
+template class ChildEdits<uint8_t>;
+template class ChildEdits<uint16_t>;
+
+}
+}
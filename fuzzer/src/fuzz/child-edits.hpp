@@ -0,0 +1,137 @@
+// child-edits.hpp
+//
+// The children of one parent, stored as edits against it.
+//
+// Most mutations change one or two characters, so copying the
+// whole parent for every child makes generation cost grow with
+// the string length. Instead, a child is mutated in a draft copy
+// of the parent and only the runs of characters which differ are
+// recorded; the draft is then restored for the next child.
+//
+// To execute the children, a worker keeps its own copy of the
+// parent, applies a child's edits, runs it, and reverts them.
+// Only children worth keeping are materialized into buffers of
+// their own.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+template<typename Char>
+class ChildEdits
+{
+public:
+    ChildEdits();
+
+    /**
+     * Starts over with no children of `parent`, which must stay alive and
+     * unmodified until the next Reset()
+     */
+    void Reset(const Char *parent, size_t buflen);
+
+    /**
+     * The buffer to mutate the next child in; holds the parent
+     */
+    inline Char *Draft()
+    {
+        return this->draft.data();
+    };
+
+    /**
+     * Records the draft as the next child, given that it only differs from
+     * the parent in [begin, end), and restores the draft to the parent
+     */
+    void Commit(size_t begin, size_t end);
+
+    /**
+     * The number of children
+     */
+    inline size_t Size() const
+    {
+        return this->child_ends.size();
+    };
+
+    inline const Char *Parent() const
+    {
+        return this->parent;
+    };
+
+    inline size_t Length() const
+    {
+        return this->buflen;
+    };
+
+    /**
+     * Turns `work`, which holds the parent, into child i
+     */
+    void Apply(size_t i, Char *work) const;
+
+    /**
+     * Turns `work`, which holds child i, back into the parent
+     */
+    void Revert(size_t i, Char *work) const;
+
+    /**
+     * Writes child i to `out`, which has room for Length() chars
+     */
+    void Materialize(size_t i, Char *out) const;
+
+    /**
+     * The content hash (see input-cache.hpp) of the parent
+     */
+    inline uint64_t ParentHash() const
+    {
+        return this->parent_hash;
+    };
+
+    /**
+     * The content hash of child i, in time proportional to its edits
+     */
+    uint64_t Hash(size_t i) const;
+
+    /**
+     * Drops every child i for which `keep[i]` is zero; the others keep
+     * their order
+     */
+    void Retain(const std::vector<uint8_t> &keep);
+
+private:
+    /**
+     * `len` chars at `pos` become `chars[offset...]`
+     */
+    struct run
+    {
+        uint32_t pos;
+        uint32_t len;
+        size_t offset;
+    };
+
+    const Char *parent;
+    size_t buflen;
+    uint64_t parent_hash;
+    std::vector<Char> draft;
+
+    std::vector<struct run> runs;
+    std::vector<Char> chars;
+
+    /**
+     * Child i's runs are [child_ends[i - 1], child_ends[i])
+     */
+    std::vector<size_t> child_ends;
+
+    inline size_t first_run(size_t i) const
+    {
+        return i == 0 ? 0 : this->child_ends[i - 1];
+    };
+};
+
+}
+}
@@ -3,6 +3,7 @@
 #include "mutations.hpp"
 
 #include <cstring>
+#include <new>
 #include <vector>
 #include <random>
 #include <iostream>
@@ -27,28 +28,43 @@ CorpusEntry<Char>::CorpusEntry(
     Char *buf,
     size_t buflen,
     CoverageTracker *coverage_tracker)
+    : CorpusEntry(buf, buflen, *coverage_tracker)
+{
+    delete coverage_tracker;
+}
+
+
+template <typename Char>
+CorpusEntry<Char>::CorpusEntry(
+    Char *buf,
+    size_t buflen,
+    const CoverageTracker &coverage_tracker)
+    : coverage(coverage_tracker)
 {
     this->buflen = buflen;
     this->buf = buf;
-    this->coverage_tracker = coverage_tracker;
+    this->pool = nullptr;
 }
 
 
 template <typename Char>
 CorpusEntry<Char>::CorpusEntry(CorpusEntry<Char> &other)
+    : coverage(other.coverage)
 {
     this->buflen = other.buflen;
     this->buf = new Char[other.buflen];
     memcpy(this->buf, other.buf, other.buflen * sizeof(Char));
-    this->coverage_tracker = new CoverageTracker(*other.coverage_tracker);
+    this->pool = nullptr;
 }
 
 
 template <typename Char>
 CorpusEntry<Char>::~CorpusEntry()
 {
-    delete[] this->buf;
-    delete this->coverage_tracker;
+    if (this->pool == nullptr)
+    {
+        delete[] this->buf;
+    }
 }
 
 
@@ -101,11 +117,11 @@ std::string CorpusEntry<Char>::ToString() const
         }
     }
     out << std::dec;
-    out << "\" Total=" << this->coverage_tracker->Total();
-    out << " MaxObservation=" << this->coverage_tracker->MaxObservation();
+    out << "\" Total=" << this->coverage.Total();
+    out << " MaxObservation=" << this->coverage.MaxObservation();
 
     // shorten path hash into 32 bits (from 128) by XOR-ing the parts
-    path_hash_t hash = this->coverage_tracker->PathHash();
+    path_hash_t hash = this->coverage.PathHash();
     uint32_t hash_out = 0;
     hash_out ^= hash & (0xFFFFFFFF);
     hash >>= 32;
@@ -123,12 +139,16 @@ std::string CorpusEntry<Char>::ToString() const
 
 
 template<typename Char>
-Corpus<Char>::Corpus()
+Corpus<Char>::Corpus(const EdgeIndex *edge_index, uint64_t seed)
+    : rng(seed)
 {
-    this->coverage_upper_bound = new CoverageTracker(0);
+    this->coverage_upper_bound = new CoverageTracker(0, edge_index);
     this->maximizing_entry = nullptr;
+    this->maximizing_entry_discarded = false;
     this->extra_interesting = new std::vector<Char>();
-    memset(this->staleness, 0, sizeof(this->staleness));
+    this->staleness = new uint32_t[this->coverage_upper_bound->MapSize()]();
+    this->maximizers.resize(this->coverage_upper_bound->MapSize());
+    this->entry_pool_buflen = 0;
 }
 
 
@@ -137,33 +157,139 @@ Corpus<Char>::~Corpus()
 {
     while (this->new_entries.size() > 0)
     {
-        delete this->new_entries.at(this->new_entries.size() - 1);
+        this->Discard(this->new_entries.at(this->new_entries.size() - 1));
         this->new_entries.pop_back();
     }
 
     while (this->flushed_entries.size() > 0)
     {
-        delete this->flushed_entries.at(this->flushed_entries.size() - 1);
+        this->Discard(this->flushed_entries.at(this->flushed_entries.size() - 1));
         this->flushed_entries.pop_back();
     }
 
+    // the maximizing entry was among the above, so it has been discarded
+    if (this->maximizing_entry_discarded)
+    {
+        this->Free(this->maximizing_entry);
+    }
+
+    for (size_t i = 0; i < this->spare_trackers.size(); i++)
+    {
+        delete this->spare_trackers[i];
+    }
+
     delete this->coverage_upper_bound;
-    delete this->maximizing_entry;
     delete this->extra_interesting;
+    delete[] this->staleness;
+}
+
+
+template<typename Char>
+CorpusEntry<Char> *Corpus<Char>::NewEntry(const Char *buf, size_t buflen, CoverageTracker *coverage_tracker)
+{
+    if (this->entry_pool == nullptr)
+    {
+        // aim for slabs of about 64 KiB
+        const size_t block_size = sizeof(CorpusEntry<Char>) + buflen * sizeof(Char);
+        this->entry_pool.reset(new SlabPool(block_size, std::max(static_cast<size_t>(16), 65536 / block_size)));
+        this->entry_pool_buflen = buflen;
+    }
+
+    CorpusEntry<Char> *ret;
+    if (buflen != this->entry_pool_buflen)
+    {
+        Char *copy = new Char[buflen];
+        memcpy(copy, buf, buflen * sizeof(Char));
+        ret = new CorpusEntry<Char>(copy, buflen, *coverage_tracker);
+    }
+    else
+    {
+        void *block = this->entry_pool->Allocate();
+        Char *inline_buf = reinterpret_cast<Char *>(
+            reinterpret_cast<uint8_t *>(block) + sizeof(CorpusEntry<Char>)
+        );
+        memcpy(inline_buf, buf, buflen * sizeof(Char));
+
+        ret = new (block) CorpusEntry<Char>(inline_buf, buflen, *coverage_tracker);
+        ret->pool = this->entry_pool.get();
+    }
+
+    // the entry keeps a snapshot, so the tracker is free for reuse
+    this->spare_trackers.push_back(coverage_tracker);
+    return ret;
+}
+
+
+template<typename Char>
+void Corpus<Char>::Discard(CorpusEntry<Char> *entry)
+{
+    if (entry == this->maximizing_entry)
+    {
+        // still reported by MaxOpcount(); freed once superseded
+        this->maximizing_entry_discarded = true;
+        return;
+    }
+
+    this->Free(entry);
+}
+
+
+template<typename Char>
+void Corpus<Char>::Free(CorpusEntry<Char> *entry)
+{
+    if (entry->pool == nullptr)
+    {
+        delete entry;
+    }
+    else
+    {
+        SlabPool *pool = entry->pool;
+        entry->~CorpusEntry<Char>();
+        pool->Free(entry);
+    }
+}
+
+
+template<typename Char>
+CoverageTracker *Corpus<Char>::TakeSpareTracker(uint32_t string_length)
+{
+    while (!this->spare_trackers.empty())
+    {
+        CoverageTracker *ret = this->spare_trackers.back();
+        this->spare_trackers.pop_back();
+        if (ret->StringLength() == string_length)
+        {
+            return ret;
+        }
+        delete ret;
+    }
+    return nullptr;
 }
 
 
 template<typename Char>
 void Corpus<Char>::Record(CorpusEntry<Char> *entry)
 {
+    if (this->path_hashes.InsertOrFind(entry->coverage.PathHash()))
+    {
+        // this path is already in the corpus (or on its way there)
+        this->Discard(entry);
+        return;
+    }
+
     this->new_entries.push_back(entry);
 
     if (this->maximizing_entry == nullptr ||
-        this->maximizing_entry->GetCoverageTracker()->Total() < entry->GetCoverageTracker()->Total())
+        this->maximizing_entry->GetCoverage()->Total() < entry->GetCoverage()->Total())
     {
-        // this is the new maximizing entry
-        delete this->maximizing_entry;
-        this->maximizing_entry = new CorpusEntry<Char>(*entry);
+        // this is the new maximizing entry; entries are immutable, so it
+        // is shared with new_entries rather than copied
+        if (this->maximizing_entry_discarded)
+        {
+            this->Free(this->maximizing_entry);
+            this->maximizing_entry_discarded = false;
+        }
+        this->maximizing_entry = entry;
         // TODO remove me
         auto now = std::chrono::high_resolution_clock::now();
         std::cout << "NEW_MAXIMIZING_ENTRY " <<
@@ -177,56 +303,51 @@ template<typename Char>
 void Corpus<Char>::Add(CorpusEntry<Char> *entry)
 {
     this->flushed_entries.push_back(entry);
+    const uint32_t entry_idx = static_cast<uint32_t>(this->flushed_entries.size() - 1);
 
-    // Reset staleness for any edges which were just exceeded
-    for (size_t i=0; i<MAP_SIZE; i++)
-    {
-        if (entry->GetCoverageTracker()->EdgeIsGreater(this->coverage_upper_bound, i))
-        {
-            this->staleness[i] = 0;
-        }
-    }
+    // Compare against the upper bound before raising it
+    this->comparison_scratch.clear();
+    this->coverage_upper_bound->Compare(entry->coverage, this->comparison_scratch);
+    this->coverage_upper_bound->Union(entry->coverage);
 
-    this->coverage_upper_bound->Union(entry->coverage_tracker);
+    for (size_t i=0; i<this->comparison_scratch.size(); i++)
+    {
+        const struct block_comparison &cmp = this->comparison_scratch[i];
 
-    // Record the path hash in the hashtable
+        // Edges which were just exceeded: reset staleness, and this entry
+        // becomes the only maximizer
+        uint64_t bits = cmp.greater;
+        while (bits != 0)
+        {
+            const size_t edge = cmp.base + __builtin_ctzll(bits);
+            bits &= bits - 1;
 
-    path_hash_t path_hash = entry->coverage_tracker->PathHash();
-    size_t hashtable_slot = static_cast<path_hash_t>(path_hash & (CORPUS_PATH_HASHTABLE_SIZE - 1));
+            this->staleness[edge] = 0;
+            if (this->maximizers[edge].empty())
+            {
+                this->covered_edges.push_back(static_cast<uint32_t>(edge));
+            }
+            this->maximizers[edge].clear();
+            this->maximizers[edge].push_back(entry_idx);
+        }
 
-    auto slot = &(this->hashtable[hashtable_slot]);
-    for (size_t i=0; i<slot->size(); i++)
-    {
-        if (slot->at(i) == path_hash)
+        // Edges which were tied: this entry joins the maximizers
+        bits = cmp.equal;
+        while (bits != 0)
         {
-            goto already_seen_hash;
+            const size_t edge = cmp.base + __builtin_ctzll(bits);
+            bits &= bits - 1;
+
+            this->maximizers[edge].push_back(entry_idx);
         }
     }
-
-    // hash has not been seen before, so append
-    slot->push_back(path_hash);
-
-    already_seen_hash:
-    // do not add the hash a second time
-    ;
 }
 
 
 template<typename Char>
 bool Corpus<Char>::IsRedundant(CoverageTracker *coverage_tracker) const
 {
-    path_hash_t path_hash = coverage_tracker->PathHash();
-    size_t hashtable_slot = static_cast<size_t>(path_hash & (CORPUS_PATH_HASHTABLE_SIZE - 1));
-
-    auto slot = &(this->hashtable[hashtable_slot]);
-    for (size_t i=0; i<slot->size(); i++)
-    {
-        if (slot->at(i) == path_hash)
-        {
-            return true;
-        }
-    }
-    return false;
+    return this->path_hashes.Contains(coverage_tracker->PathHash());
 }
 
 
@@ -234,17 +355,16 @@ template<typename Char>
 void Corpus<Char>::GenerateChildren(
     const CorpusEntry<Char> *parent,
     size_t n_children,
-    std::vector<Char *> &out
+    ChildEdits<Char> &out
 )
 {
     // NOTE: for PerfFuzz, each child is a mutation OF THE PREVIOUS GENERATED CHILD
-    // ... but I've commented that bit out below
-    const Char *last_buf = parent->buf;
+    // ... but we mutate each child from the parent
     size_t buflen = parent->buflen;
 
     // Get the mutation suggestions
     std::vector<struct suggestion> suggestions;
-    parent->coverage_tracker->GetSuggestions(
+    parent->coverage.GetSuggestions(
         suggestions
     );
 
@@ -252,65 +372,64 @@ void Corpus<Char>::GenerateChildren(
     // BUT stop after the first MAX_SUGGESTIONS slots
     for (size_t i=0; i + 2 <= std::min(MAX_SUGGESTIONS, suggestions.size()); i++)
     {
-        size_t j = (static_cast<size_t>(random()) % (suggestions.size() - i)) + i;
+        size_t j = this->rng.Below(suggestions.size() - i) + i;
         struct suggestion tmp = suggestions[i];
         suggestions[i] = suggestions[j];
         suggestions[j] = tmp;
     }
 
-    for (size_t i=0; i < std::min(MAX_SUGGESTIONS, suggestions.size()); i++)
+    out.Reset(parent->buf, buflen);
+    Char *newbuf = out.Draft();
+
+    const size_t n_suggested = std::min(std::min(MAX_SUGGESTIONS, suggestions.size()), n_children);
+    for (size_t i=0; i < n_suggested; i++)
     {
-        Char *newbuf = new Char[buflen];
-        memcpy(newbuf, parent->buf, buflen * sizeof(Char));
-        take_a_suggestion(newbuf, buflen, suggestions[i]);
-        out.push_back(newbuf);
-        n_children--;
+        struct mutated_range changed = take_a_suggestion(newbuf, buflen, suggestions[i]);
+        out.Commit(changed.begin, changed.end);
     }
 
-    for (size_t i = 0; i < n_children; i++)
+    for (size_t i = n_suggested; i < n_children; i++)
     {
-        Char *newbuf = new Char[buflen];
-        memcpy(newbuf, last_buf, buflen * sizeof(Char));
+        struct mutated_range changed;
 
         // select a mutation to apply
-        switch (random() % 16)
+        switch (this->rng.Below(16))
         {
         case 0:
-            mutate_random_char(newbuf, buflen);
+            changed = mutate_random_char(newbuf, buflen, this->rng);
             break;
         case 1:
         case 2:
-            arith_random_char(newbuf, buflen);
+            changed = arith_random_char(newbuf, buflen, this->rng);
             break;
         case 3:
         case 4:
-            swap_random_char(newbuf, buflen);
+            changed = swap_random_char(newbuf, buflen, this->rng);
             break;
         case 6:
         case 7:
-            crossover(newbuf, buflen, this->GetCoparent());
+            changed = crossover(newbuf, buflen, this->GetCoparent(), this->rng);
             break;
         case 8:
         case 9:
-            duplicate_subsequence(newbuf, buflen);
+            changed = duplicate_subsequence(newbuf, buflen, this->rng);
             break;
         case 10:
         case 11:
         case 12:
         case 13:
-            replace_with_special(newbuf, buflen, *this->extra_interesting);
+            changed = replace_with_special(newbuf, buflen, *this->extra_interesting, this->rng);
             break;
         case 5:
         case 14:
         case 15:
-            rotate_once(newbuf, buflen);
+            changed = rotate_once(newbuf, buflen, this->rng);
             break;
         default:
             throw "Unreachable";
         }
 
-        // last_buf = newbuf;
-        out.push_back(newbuf);
+        out.Commit(changed.begin, changed.end);
     }
 }
 
@@ -329,7 +448,7 @@ CorpusEntry<Char> *Corpus<Char>::Get(size_t i)
 template<typename Char>
 void Corpus<Char>::BumpStaleness(CoverageTracker *coverage_tracker)
 {
-    for (size_t i=0; i < MAP_SIZE; i++)
+    for (size_t i=0; i < this->coverage_upper_bound->MapSize(); i++)
     {
         if  (
                 this->staleness[i] < UINT32_MAX &&
@@ -348,8 +467,7 @@ template<typename Char>
 size_t Corpus<Char>::GetStalenessScore(CoverageTracker *coverage_tracker)
 {
     // Maximum staleness seen across all components
-    // = 1 to avoid div-by-zero when staleness is in initial state (all zero)
-    uint32_t global_max_staleness = 1;
+    uint32_t global_max_staleness = 0;
 
     // Minimum staleness seen across all components
     uint32_t global_min_staleness = UINT32_MAX;
@@ -357,7 +475,7 @@ size_t Corpus<Char>::GetStalenessScore(CoverageTracker *coverage_tracker)
     // Minimum staleness seen on a component maximized by `coverage_tracker`
     uint32_t my_min_staleness = UINT32_MAX;
 
-    for (size_t i=0; i < MAP_SIZE; i++)
+    for (size_t i=0; i < this->coverage_upper_bound->MapSize(); i++)
     {
         if (this->coverage_upper_bound->EdgeIsCovered(i))
         {
@@ -372,11 +490,33 @@ size_t Corpus<Char>::GetStalenessScore(CoverageTracker *coverage_tracker)
         }
     }
 
-    // This can occur if the entry is not maximizing -- staleness has no practical meaning,
-    // so just set this here
-    my_min_staleness = std::min(my_min_staleness, global_min_staleness);
+    return staleness_score(my_min_staleness, global_min_staleness, global_max_staleness);
+}
+
 
-    return (MAX_STALENESS_SCORE * (my_min_staleness - global_min_staleness)) / global_max_staleness;
+template<typename Char>
+size_t Corpus<Char>::GetStalenessScore(const CoverageSnapshot *coverage)
+{
+    uint32_t global_max_staleness = 0;
+    uint32_t global_min_staleness = UINT32_MAX;
+    for (size_t i=0; i < this->covered_edges.size(); i++)
+    {
+        global_max_staleness = std::max(global_max_staleness, this->staleness[this->covered_edges[i]]);
+        global_min_staleness = std::min(global_min_staleness, this->staleness[this->covered_edges[i]]);
+    }
+
+    // only edges the snapshot covers can be maximized by it
+    uint32_t my_min_staleness = UINT32_MAX;
+    for (size_t i=0; i < coverage->NumCovered(); i++)
+    {
+        const uint32_t edge = coverage->CoveredEdge(i);
+        if (this->coverage_upper_bound->EdgeIsEqual(*coverage, edge))
+        {
+            my_min_staleness = std::min(my_min_staleness, this->staleness[edge]);
+        }
+    }
+
+    return staleness_score(my_min_staleness, global_min_staleness, global_max_staleness);
 }
 
 
@@ -399,33 +539,93 @@ bool Corpus<Char>::MaximizesUpperBound(CoverageTracker *coverage_tracker)
 }
 
 
+template<typename Char>
+bool Corpus<Char>::MaximizesUpperBound(const CoverageSnapshot *coverage)
+{
+    if (coverage == nullptr)
+    {
+        return false;
+    }
+
+    return this->coverage_upper_bound->MaximizesAnyEdge(*coverage);
+}
+
+
 template<typename Char>
 bool Corpus<Char>::HasNewPath(CoverageTracker *coverage_tracker)
 {
     return this->coverage_upper_bound->HasNewPath(coverage_tracker);
 }
 
+template<typename Char>
+struct novelty Corpus<Char>::Evaluate(CoverageTracker *coverage_tracker)
+{
+    struct novelty ret;
+    ret.is_redundant = this->IsRedundant(coverage_tracker);
+    ret.has_new_path = false;
+    ret.n_exceeded = 0;
+    ret.n_maximized = 0;
+
+    if (ret.is_redundant)
+    {
+        return ret;
+    }
+
+    this->comparison_scratch.clear();
+    this->coverage_upper_bound->Compare(coverage_tracker, this->comparison_scratch);
+
+    for (size_t i=0; i<this->comparison_scratch.size(); i++)
+    {
+        ret.n_exceeded += __builtin_popcountll(this->comparison_scratch[i].greater);
+        ret.n_maximized += __builtin_popcountll(this->comparison_scratch[i].equal);
+    }
+
+    // By the pigeonhole principle, more total CFG transitions
+    // MUST explore some new behavior (see CoverageTracker::HasNewPath)
+    ret.has_new_path = ret.n_exceeded > 0 ||
+        coverage_tracker->Total() > this->coverage_upper_bound->Total();
+
+    if (ret.has_new_path)
+    {
+        // Bump staleness of every edge this ties. (Edges where both are
+        // zero need no bump: their staleness is reset when first covered.)
+        for (size_t i=0; i<this->comparison_scratch.size(); i++)
+        {
+            uint64_t bits = this->comparison_scratch[i].equal;
+            while (bits != 0)
+            {
+                const size_t edge = this->comparison_scratch[i].base + __builtin_ctzll(bits);
+                bits &= bits - 1;
+                if (this->staleness[edge] < UINT32_MAX)
+                {
+                    this->staleness[edge]++;
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
 template<typename Char>
 bool Corpus<Char>::MaximizesEdge(CoverageTracker *coverage_tracker, size_t edge_idx) const
 {
     return this->coverage_upper_bound->EdgeIsEqual(coverage_tracker, edge_idx);
 }
 
+template<typename Char>
+bool Corpus<Char>::MaximizesEdge(const CoverageSnapshot *coverage, size_t edge_idx) const
+{
+    return this->coverage_upper_bound->EdgeIsEqual(*coverage, edge_idx);
+}
+
 template<typename Char>
 void Corpus<Char>::FlushGeneration()
 {
     for (size_t i=0; i<this->new_entries.size(); i++)
     {
-        CorpusEntry<Char> *entry = this->new_entries[i];
-
-        if (!this->IsRedundant(entry->GetCoverageTracker()))
-        {
-            this->Add(entry);
-        }
-        else
-        {
-            delete entry;
-        }
+        // Record() already turned away duplicates
+        this->Add(this->new_entries[i]);
     }
 
     this->new_entries.clear();
@@ -440,9 +640,9 @@ inline void Corpus<Char>::SetInteresting(std::vector<Char> *interesting)
 }
 
 template<typename Char>
-const Char * const Corpus<Char>::GetCoparent() const
+const Char * const Corpus<Char>::GetCoparent()
 {
-    size_t coparent_idx = static_cast<size_t>(random()) % (this->flushed_entries.size());
+    size_t coparent_idx = this->rng.Below(this->flushed_entries.size());
     const CorpusEntry<Char> *coparent = this->flushed_entries[coparent_idx];
 
     return coparent->buf;
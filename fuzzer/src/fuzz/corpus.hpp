@@ -7,13 +7,20 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 
 
+#include "child-edits.hpp"
+#include "coverage-snapshot.hpp"
 #include "coverage-tracker.hpp"
 #include "mutations.hpp"
+#include "path-hash-set.hpp"
+#include "random.hpp"
+#include "slab-pool.hpp"
 
 
 namespace regulator
@@ -21,44 +28,97 @@ namespace regulator
 namespace fuzz
 {
 
-// The number of hashtable slots to have for tracking corpus
-// entry path hashes.
-//
-// Keep a multiple of 2.
-const size_t CORPUS_PATH_HASHTABLE_SIZE = 4096;
-
-
 // The maximum staleness score achievable by an entry
 const uint32_t MAX_STALENESS_SCORE = 4096;
 
+/**
+ * Computes the staleness score of an entry whose least-stale maximized
+ * edge has staleness `my_min` (UINT32_MAX if it maximizes no edge), given
+ * the least and greatest staleness across all covered edges.
+ */
+inline uint32_t staleness_score(uint32_t my_min, uint32_t global_min, uint32_t global_max)
+{
+    // the entry is not maximizing -- staleness has no practical meaning
+    if (my_min == UINT32_MAX || global_min == UINT32_MAX)
+    {
+        return 0;
+    }
+
+    // avoid div-by-zero when staleness is in initial state (all zero)
+    global_max = std::max(global_max, static_cast<uint32_t>(1));
+
+    return static_cast<uint32_t>(
+        (static_cast<uint64_t>(MAX_STALENESS_SCORE) * (my_min - global_min)) / global_max
+    );
+}
+
+/**
+ * The verdict of Corpus::Evaluate() on one execution
+ */
+struct novelty
+{
+    // the path hash is already known to the corpus
+    bool is_redundant;
+    // the execution exceeds the coverage upper bound somewhere
+    bool has_new_path;
+    // the number of edges where the execution exceeds the upper bound
+    uint32_t n_exceeded;
+    // the number of covered edges where the execution ties the upper bound
+    uint32_t n_maximized;
+};
+
 /**
  * A single entry in the corpus, ie, a string.
  * Also contains some meta-information about past
  * executions against this string.
  */
+template <typename Char>
+class Corpus;
+
 template <typename Char>
 class CorpusEntry
 {
 public:
     /**
-     * Construct a CorpusEntry
+     * Construct a CorpusEntry, with a snapshot of `coverage_tracker`.
      * Takes ownership of the params.
+     *
+     * See also Corpus::NewEntry(), which pools entries.
      */
     CorpusEntry(Char *buf, size_t buflen, CoverageTracker *coverage_tracker);
+
+    /**
+     * Like the above, but leaves `coverage_tracker` to the caller
+     */
+    CorpusEntry(Char *buf, size_t buflen, const CoverageTracker &coverage_tracker);
     CorpusEntry(CorpusEntry<Char> &other);
 
     ~CorpusEntry();
 
-    inline CoverageTracker *GetCoverageTracker()
+    inline const CoverageSnapshot *GetCoverage() const
     {
-        return this->coverage_tracker;
+        return &this->coverage;
     };
 
     std::string ToString() const;
 
     Char *buf;
     size_t buflen;
-    regulator::fuzz::CoverageTracker *coverage_tracker;
+
+    /**
+     * The coverage of this string, frozen when the entry was made
+     */
+    const CoverageSnapshot coverage;
+
+private:
+    friend class Corpus<Char>;
+
+    /**
+     * The pool this entry came from (its buffer is stored right after
+     * it, in the same block), or null if the entry and its buffer are
+     * on the heap
+     */
+    SlabPool *pool;
 };
 
 
@@ -69,12 +129,40 @@ template <typename Char>
 class Corpus
 {
 public:
-    Corpus();
+    /**
+     * Creates an empty corpus. If `edge_index` is non-null, coverage is
+     * tracked per indexed edge (see CoverageTracker).
+     *
+     * All random choices made for this corpus (mutations, coparents, queue
+     * selection) are drawn from a generator seeded with `seed`.
+     */
+    Corpus(const EdgeIndex *edge_index = nullptr, uint64_t seed = 0);
     ~Corpus();
 
+    /**
+     * Makes an entry holding a copy of `buf`, to be given to Record().
+     * Takes ownership of `coverage_tracker`, which is kept as a spare
+     * once the entry has its snapshot.
+     *
+     * Entries of the first length asked for (a campaign only fuzzes one)
+     * come from a pool which lives as long as the corpus, along with
+     * their buffers.
+     */
+    CorpusEntry<Char> *NewEntry(const Char *buf, size_t buflen, CoverageTracker *coverage_tracker);
+
+    /**
+     * Gets a coverage tracker given to NewEntry(), for reuse with subjects
+     * of length `string_length`; nullptr if there is none. The caller
+     * assumes ownership.
+     */
+    CoverageTracker *TakeSpareTracker(uint32_t string_length);
+
     /**
      * Store the results of a run into the corpus.
      * Ownership of the `entry` object is transferred to the Corpus.
+     *
+     * An entry whose path was already recorded (even in this generation)
+     * is dropped right away.
      * 
      * NOTE: This will not increase the corpus Size() until
      *       FlushGeneration() is called.
@@ -83,11 +171,14 @@ public:
 
     /**
      * Generate children from the given parent byte pattern.
+     *
+     * The children replace whatever `out` held, as edits against
+     * `parent->buf`; so `parent` must outlive them.
      */
     void GenerateChildren(
         const CorpusEntry<Char> *parent,
         size_t n_children,
-        std::vector<Char *> &out
+        ChildEdits<Char> &out
     );
 
     /**
@@ -113,6 +204,34 @@ public:
      * Seel also: MAX_STALENESS_SCORE
      */
     size_t GetStalenessScore(CoverageTracker *coverage_tracker);
+    size_t GetStalenessScore(const CoverageSnapshot *coverage);
+
+    /**
+     * Gets the raw staleness counter of the given edge index
+     */
+    inline uint32_t GetStaleness(size_t edge_idx) const
+    {
+        return this->staleness[edge_idx];
+    };
+
+    /**
+     * Gets the indices (see Get()) of every entry which currently
+     * maximizes the upper bound at the given edge index, in the order
+     * they were flushed. Empty iff the edge is not covered.
+     */
+    inline const std::vector<uint32_t> &Maximizers(size_t edge_idx) const
+    {
+        return this->maximizers[edge_idx];
+    };
+
+    /**
+     * Gets every edge index covered by the upper bound, in the order
+     * they were first covered
+     */
+    inline const std::vector<uint32_t> &CoveredEdges() const
+    {
+        return this->covered_edges;
+    };
 
     /**
      * Gets the maximum opcount entry known in this corpus
@@ -124,6 +243,7 @@ public:
      * maximize the current known upper bound
      */
     bool MaximizesUpperBound(CoverageTracker *coverage_tracker);
+    bool MaximizesUpperBound(const CoverageSnapshot *coverage);
 
     /**
      * Returns True if this tracker object exceeds the known upper bound.
@@ -132,21 +252,34 @@ public:
      */
     bool HasNewPath(CoverageTracker *coverage_tracker);
 
+    /**
+     * Evaluates an execution against the corpus in a single sweep of its
+     * coverage map. Equivalent to (but cheaper than) checking HasNewPath()
+     * and IsRedundant(), then calling BumpStaleness() if the execution is
+     * new and not redundant.
+     *
+     * Callers should Record() the execution iff the result is new and
+     * not redundant.
+     */
+    struct novelty Evaluate(CoverageTracker *coverage_tracker);
+
     /**
      * Returns True if this tracker object maximizes the known upper
      * bound of executions at the given edge index
      */
     bool MaximizesEdge(CoverageTracker *coverage_tracker, size_t edge_idx) const;
+    bool MaximizesEdge(const CoverageSnapshot *coverage, size_t edge_idx) const;
 
     /**
-     * Mark the current generation sweep as complete. Flushes the pending,
-     * non-redundant entries.
+     * Mark the current generation sweep as complete. Flushes the pending
+     * entries.
      */
     void FlushGeneration();
 
     /**
-     * Returns true if we likely already have an entry
-     * in the corpus for the given execution's trace.
+     * Returns true if we likely already have an entry in the
+     * corpus for the given execution's trace (including entries
+     * recorded but not yet flushed).
      */
     bool IsRedundant(CoverageTracker *coverage_tracker) const;
 
@@ -170,6 +303,23 @@ public:
      */
     size_t Size() const;
 
+    /**
+     * Gets this corpus' random number generator
+     */
+    inline Random &GetRandom()
+    {
+        return this->rng;
+    };
+
+    /**
+     * The number of slots in the coverage map (the number of
+     * valid edge indices)
+     */
+    inline uint32_t MapSize() const
+    {
+        return this->coverage_upper_bound->MapSize();
+    };
+
 private:
 
     /**
@@ -177,7 +327,7 @@ private:
      * 
      * NOTE: DO NOT MOIDIFY THE COPARENT
      */
-    const Char * const GetCoparent() const;
+    const Char * const GetCoparent();
 
     /**
      * Adds one CorpusEntry to the heap. Performs no bounds checks
@@ -185,12 +335,27 @@ private:
      */
     void Add(CorpusEntry<Char> *entry);
 
+    /**
+     * Frees an entry, unless it is the maximizing entry (which is then
+     * freed once superseded)
+     */
+    void Discard(CorpusEntry<Char> *entry);
+
+    /**
+     * Frees an entry
+     */
+    void Free(CorpusEntry<Char> *entry);
+
+
     CoverageTracker *coverage_upper_bound;
 
     /**
-     * The entry with the highest-known Total()
+     * The entry with the highest-known Total(). It is one of the recorded
+     * entries, unless that entry has since been discarded (eg as
+     * redundant) -- in which case the corpus still owns it here.
      */
     CorpusEntry<Char> *maximizing_entry;
+    bool maximizing_entry_discarded;
 
     /**
      * Entries which are recorded for a current generation
@@ -214,12 +379,44 @@ private:
      */
     std::vector<CorpusEntry<Char> *> flushed_entries;
 
-    std::vector<path_hash_t> hashtable[CORPUS_PATH_HASHTABLE_SIZE];
+    /**
+     * The path hash of every recorded entry
+     */
+    PathHashSet path_hashes;
+
+    /**
+     * A record of how "stale" each component is (one per map slot)
+     */
+    uint32_t *staleness;
+
+    /**
+     * For each map slot, the indices of the flushed entries which
+     * maximize the upper bound there. Maintained by Add().
+     */
+    std::vector<std::vector<uint32_t>> maximizers;
+
+    /**
+     * Every map slot which is non-zero in the upper bound
+     */
+    std::vector<uint32_t> covered_edges;
 
     /**
-     * A record of how "stale" each component is
+     * Scratch space for Evaluate() and Add(), kept to avoid reallocation
      */
-    uint32_t staleness[MAP_SIZE];
+    std::vector<struct block_comparison> comparison_scratch;
+
+    /**
+     * Where NewEntry() allocates entries of length `entry_pool_buflen`
+     */
+    std::unique_ptr<SlabPool> entry_pool;
+    size_t entry_pool_buflen;
+
+    /**
+     * Coverage trackers given to NewEntry() (see TakeSpareTracker)
+     */
+    std::vector<CoverageTracker *> spare_trackers;
+
+    Random rng;
 };
 
 }
@@ -0,0 +1,469 @@
+#include "coverage-kernels.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define REGULATOR_HAVE_X86_KERNELS
+#endif
+
+namespace regulator
+{
+namespace fuzz
+{
+
+/**
+ * bucketization lookup
+ */
+static const uint8_t count_class_lookup8[256] = {
+    0,
+
+    1,
+
+    2,
+
+    4,
+
+    8,8,8,8,
+
+    16,16,16,16,16,16,16,16,
+
+    32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
+
+    64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
+    64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
+    64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
+    64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
+    64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
+    64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
+
+    128,128,128,128,128,128,128,128,128,128,128,128,
+    128,128,128,128,128,128,128,128,128,128,128,128,
+    128,128,128,128,128,128,128,128,128,128,128,128,
+    128,128,128,128,128,128,128,128,128,128,128,128,
+    128,128,128,128,128,128,128,128,128,128,128,128,
+    128,128,128,128,128,128,128,128,128,128,128,128,
+    128,128,128,128,128,128,128,128,128,128,128,128,
+    128,128,128,128,128,128,128,128,128,128,128,128,
+    128,128,128,128,128,128,128,128,128,128,128,128,
+    128,128,128,128,128,128,128,128,128,128,128,128,
+    128,128,128,128,128,128,128,128,
+};
+
+
+//
+// Scalar
+//
+
+static void scalar_bucketize(uint8_t *block)
+{
+    uint64_t *words = reinterpret_cast<uint64_t *>(block);
+    for (size_t i = 0; i < MAP_BLOCK_SIZE / sizeof(uint64_t); i++)
+    {
+        if (words[i] != 0)
+        {
+            uint8_t *curr = reinterpret_cast<uint8_t *>(&words[i]);
+            curr[0] = count_class_lookup8[curr[0]];
+            curr[1] = count_class_lookup8[curr[1]];
+            curr[2] = count_class_lookup8[curr[2]];
+            curr[3] = count_class_lookup8[curr[3]];
+            curr[4] = count_class_lookup8[curr[4]];
+            curr[5] = count_class_lookup8[curr[5]];
+            curr[6] = count_class_lookup8[curr[6]];
+            curr[7] = count_class_lookup8[curr[7]];
+        }
+    }
+}
+
+static void scalar_max_into(uint8_t *dst, const uint8_t *src)
+{
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i++)
+    {
+        dst[i] = dst[i] > src[i] ? dst[i] : src[i];
+    }
+}
+
+static uint64_t scalar_greater_mask(const uint8_t *a, const uint8_t *b)
+{
+    uint64_t ret = 0;
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i++)
+    {
+        ret |= static_cast<uint64_t>(a[i] > b[i]) << i;
+    }
+    return ret;
+}
+
+static uint64_t scalar_maximizes_mask(const uint8_t *upper_bound, const uint8_t *x)
+{
+    uint64_t ret = 0;
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i++)
+    {
+        ret |= static_cast<uint64_t>(upper_bound[i] != 0 && x[i] >= upper_bound[i]) << i;
+    }
+    return ret;
+}
+
+static uint64_t scalar_nonzero_mask(const uint8_t *a)
+{
+    uint64_t ret = 0;
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i++)
+    {
+        ret |= static_cast<uint64_t>(a[i] != 0) << i;
+    }
+    return ret;
+}
+
+static const struct coverage_kernels scalar_kernels = {
+    "scalar",
+    nullptr,
+    scalar_bucketize,
+    scalar_max_into,
+    scalar_greater_mask,
+    scalar_maximizes_mask,
+    scalar_nonzero_mask,
+};
+
+
+#if defined REGULATOR_HAVE_X86_KERNELS
+
+//
+// Bucketization is done with two nibble lookups (pshufb): counts below 16
+// are classified by their low nibble, all others by their high nibble.
+//
+//   low  nibble: 0 1 2 4 8 8 8 8 16 16 16 16 16 16 16 16
+//   high nibble: - 32 64 64 64 64 64 64 128 128 128 128 128 128 128 128
+//
+
+#define REGULATOR_BUCKET_LO 0, 1, 2, 4, 8, 8, 8, 8, 16, 16, 16, 16, 16, 16, 16, 16
+#define REGULATOR_BUCKET_HI 0, 32, 64, 64, 64, 64, 64, 64, \
+    static_cast<char>(128), static_cast<char>(128), static_cast<char>(128), static_cast<char>(128), \
+    static_cast<char>(128), static_cast<char>(128), static_cast<char>(128), static_cast<char>(128)
+
+//
+// SSE4.2
+//
+
+__attribute__((target("sse4.2")))
+static inline __m128i sse42_bucketize_vec(__m128i x)
+{
+    const __m128i lo_table = _mm_setr_epi8(REGULATOR_BUCKET_LO);
+    const __m128i hi_table = _mm_setr_epi8(REGULATOR_BUCKET_HI);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    const __m128i lo = _mm_and_si128(x, nibble);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), nibble);
+    const __m128i from_lo = _mm_shuffle_epi8(lo_table, lo);
+    const __m128i from_hi = _mm_shuffle_epi8(hi_table, hi);
+    const __m128i hi_is_zero = _mm_cmpeq_epi8(hi, _mm_setzero_si128());
+    return _mm_or_si128(from_hi, _mm_and_si128(from_lo, hi_is_zero));
+}
+
+__attribute__((target("sse4.2")))
+static void sse42_bucketize(uint8_t *block)
+{
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i += 16)
+    {
+        __m128i *p = reinterpret_cast<__m128i *>(block + i);
+        const __m128i x = _mm_loadu_si128(p);
+        if (!_mm_testz_si128(x, x))
+        {
+            _mm_storeu_si128(p, sse42_bucketize_vec(x));
+        }
+    }
+}
+
+__attribute__((target("sse4.2")))
+static void sse42_max_into(uint8_t *dst, const uint8_t *src)
+{
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i += 16)
+    {
+        __m128i *d = reinterpret_cast<__m128i *>(dst + i);
+        const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_si128(d, _mm_max_epu8(_mm_loadu_si128(d), s));
+    }
+}
+
+__attribute__((target("sse4.2")))
+static uint64_t sse42_greater_mask(const uint8_t *a, const uint8_t *b)
+{
+    uint64_t ret = 0;
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i += 16)
+    {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        // a <= b  <=>  max(a, b) == b
+        const __m128i le = _mm_cmpeq_epi8(_mm_max_epu8(va, vb), vb);
+        const uint64_t bits = static_cast<uint16_t>(~_mm_movemask_epi8(le));
+        ret |= bits << i;
+    }
+    return ret;
+}
+
+__attribute__((target("sse4.2")))
+static uint64_t sse42_maximizes_mask(const uint8_t *upper_bound, const uint8_t *x)
+{
+    uint64_t ret = 0;
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i += 16)
+    {
+        const __m128i vu = _mm_loadu_si128(reinterpret_cast<const __m128i *>(upper_bound + i));
+        const __m128i vx = _mm_loadu_si128(reinterpret_cast<const __m128i *>(x + i));
+        // x >= ub  <=>  max(x, ub) == x
+        const __m128i ge = _mm_cmpeq_epi8(_mm_max_epu8(vx, vu), vx);
+        const __m128i ub_zero = _mm_cmpeq_epi8(vu, _mm_setzero_si128());
+        const uint64_t bits = static_cast<uint16_t>(_mm_movemask_epi8(_mm_andnot_si128(ub_zero, ge)));
+        ret |= bits << i;
+    }
+    return ret;
+}
+
+__attribute__((target("sse4.2")))
+static uint64_t sse42_nonzero_mask(const uint8_t *a)
+{
+    uint64_t ret = 0;
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i += 16)
+    {
+        const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        const __m128i zero = _mm_cmpeq_epi8(va, _mm_setzero_si128());
+        const uint64_t bits = static_cast<uint16_t>(~_mm_movemask_epi8(zero));
+        ret |= bits << i;
+    }
+    return ret;
+}
+
+static const struct coverage_kernels sse42_kernels = {
+    "sse4.2",
+    "sse4.2",
+    sse42_bucketize,
+    sse42_max_into,
+    sse42_greater_mask,
+    sse42_maximizes_mask,
+    sse42_nonzero_mask,
+};
+
+
+//
+// AVX2
+//
+
+__attribute__((target("avx2")))
+static inline __m256i avx2_bucketize_vec(__m256i x)
+{
+    const __m256i lo_table = _mm256_setr_epi8(REGULATOR_BUCKET_LO, REGULATOR_BUCKET_LO);
+    const __m256i hi_table = _mm256_setr_epi8(REGULATOR_BUCKET_HI, REGULATOR_BUCKET_HI);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i lo = _mm256_and_si256(x, nibble);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble);
+    const __m256i from_lo = _mm256_shuffle_epi8(lo_table, lo);
+    const __m256i from_hi = _mm256_shuffle_epi8(hi_table, hi);
+    const __m256i hi_is_zero = _mm256_cmpeq_epi8(hi, _mm256_setzero_si256());
+    return _mm256_or_si256(from_hi, _mm256_and_si256(from_lo, hi_is_zero));
+}
+
+__attribute__((target("avx2")))
+static void avx2_bucketize(uint8_t *block)
+{
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i += 32)
+    {
+        __m256i *p = reinterpret_cast<__m256i *>(block + i);
+        const __m256i x = _mm256_loadu_si256(p);
+        if (!_mm256_testz_si256(x, x))
+        {
+            _mm256_storeu_si256(p, avx2_bucketize_vec(x));
+        }
+    }
+}
+
+__attribute__((target("avx2")))
+static void avx2_max_into(uint8_t *dst, const uint8_t *src)
+{
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i += 32)
+    {
+        __m256i *d = reinterpret_cast<__m256i *>(dst + i);
+        const __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        _mm256_storeu_si256(d, _mm256_max_epu8(_mm256_loadu_si256(d), s));
+    }
+}
+
+__attribute__((target("avx2")))
+static uint64_t avx2_greater_mask(const uint8_t *a, const uint8_t *b)
+{
+    uint64_t ret = 0;
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i += 32)
+    {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+        const __m256i le = _mm256_cmpeq_epi8(_mm256_max_epu8(va, vb), vb);
+        const uint64_t bits = static_cast<uint32_t>(~_mm256_movemask_epi8(le));
+        ret |= bits << i;
+    }
+    return ret;
+}
+
+__attribute__((target("avx2")))
+static uint64_t avx2_maximizes_mask(const uint8_t *upper_bound, const uint8_t *x)
+{
+    uint64_t ret = 0;
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i += 32)
+    {
+        const __m256i vu = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(upper_bound + i));
+        const __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(x + i));
+        const __m256i ge = _mm256_cmpeq_epi8(_mm256_max_epu8(vx, vu), vx);
+        const __m256i ub_zero = _mm256_cmpeq_epi8(vu, _mm256_setzero_si256());
+        const uint64_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_andnot_si256(ub_zero, ge)));
+        ret |= bits << i;
+    }
+    return ret;
+}
+
+__attribute__((target("avx2")))
+static uint64_t avx2_nonzero_mask(const uint8_t *a)
+{
+    uint64_t ret = 0;
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i += 32)
+    {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        const __m256i zero = _mm256_cmpeq_epi8(va, _mm256_setzero_si256());
+        const uint64_t bits = static_cast<uint32_t>(~_mm256_movemask_epi8(zero));
+        ret |= bits << i;
+    }
+    return ret;
+}
+
+static const struct coverage_kernels avx2_kernels = {
+    "avx2",
+    "avx2",
+    avx2_bucketize,
+    avx2_max_into,
+    avx2_greater_mask,
+    avx2_maximizes_mask,
+    avx2_nonzero_mask,
+};
+
+
+//
+// AVX-512 (BW); one block is exactly one zmm register
+//
+
+__attribute__((target("avx512f,avx512bw")))
+static void avx512_bucketize(uint8_t *block)
+{
+    const __m512i x = _mm512_loadu_si512(block);
+    const __mmask64 nonzero = _mm512_test_epi8_mask(x, x);
+    if (nonzero == 0)
+    {
+        return;
+    }
+    const __m512i lo_table = _mm512_broadcast_i32x4(_mm_setr_epi8(REGULATOR_BUCKET_LO));
+    const __m512i hi_table = _mm512_broadcast_i32x4(_mm_setr_epi8(REGULATOR_BUCKET_HI));
+    const __m512i nibble = _mm512_set1_epi8(0x0f);
+    const __m512i lo = _mm512_and_si512(x, nibble);
+    const __m512i hi = _mm512_and_si512(_mm512_srli_epi16(x, 4), nibble);
+    const __mmask64 hi_is_zero = _mm512_testn_epi8_mask(hi, hi);
+    const __m512i from_hi = _mm512_shuffle_epi8(hi_table, hi);
+    const __m512i ret = _mm512_mask_shuffle_epi8(from_hi, hi_is_zero, lo_table, lo);
+    _mm512_storeu_si512(block, ret);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void avx512_max_into(uint8_t *dst, const uint8_t *src)
+{
+    const __m512i d = _mm512_loadu_si512(dst);
+    const __m512i s = _mm512_loadu_si512(src);
+    _mm512_storeu_si512(dst, _mm512_max_epu8(d, s));
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static uint64_t avx512_greater_mask(const uint8_t *a, const uint8_t *b)
+{
+    return _mm512_cmpgt_epu8_mask(_mm512_loadu_si512(a), _mm512_loadu_si512(b));
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static uint64_t avx512_maximizes_mask(const uint8_t *upper_bound, const uint8_t *x)
+{
+    const __m512i vu = _mm512_loadu_si512(upper_bound);
+    const __m512i vx = _mm512_loadu_si512(x);
+    const __mmask64 ub_nonzero = _mm512_test_epi8_mask(vu, vu);
+    return _mm512_mask_cmpge_epu8_mask(ub_nonzero, vx, vu);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static uint64_t avx512_nonzero_mask(const uint8_t *a)
+{
+    const __m512i va = _mm512_loadu_si512(a);
+    return _mm512_test_epi8_mask(va, va);
+}
+
+static const struct coverage_kernels avx512_kernels = {
+    "avx512bw",
+    "avx512bw",
+    avx512_bucketize,
+    avx512_max_into,
+    avx512_greater_mask,
+    avx512_maximizes_mask,
+    avx512_nonzero_mask,
+};
+
+#undef REGULATOR_BUCKET_LO
+#undef REGULATOR_BUCKET_HI
+
+#endif // REGULATOR_HAVE_X86_KERNELS
+
+
+static bool is_supported(const struct coverage_kernels &kernels)
+{
+    if (kernels.cpu_feature == nullptr)
+    {
+        return true;
+    }
+#if defined REGULATOR_HAVE_X86_KERNELS
+    __builtin_cpu_init();
+    // __builtin_cpu_supports requires a string literal
+    if (strcmp(kernels.cpu_feature, "sse4.2") == 0)
+    {
+        return __builtin_cpu_supports("sse4.2");
+    }
+    if (strcmp(kernels.cpu_feature, "avx2") == 0)
+    {
+        return __builtin_cpu_supports("avx2");
+    }
+    if (strcmp(kernels.cpu_feature, "avx512bw") == 0)
+    {
+        return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    }
+#endif
+    return false;
+}
+
+
+std::vector<const struct coverage_kernels *> SupportedCoverageKernels()
+{
+    const struct coverage_kernels *all[] = {
+        &scalar_kernels,
+#if defined REGULATOR_HAVE_X86_KERNELS
+        &sse42_kernels,
+        &avx2_kernels,
+        &avx512_kernels,
+#endif
+    };
+
+    std::vector<const struct coverage_kernels *> ret;
+    for (size_t i = 0; i < sizeof(all) / sizeof(all[0]); i++)
+    {
+        if (is_supported(*all[i]))
+        {
+            ret.push_back(all[i]);
+        }
+    }
+    return ret;
+}
+
+
+const struct coverage_kernels &ActiveCoverageKernels()
+{
+    // the last supported entry is the widest
+    static const struct coverage_kernels *active = SupportedCoverageKernels().back();
+    return *active;
+}
+
+}
+}
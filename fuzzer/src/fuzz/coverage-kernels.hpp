@@ -0,0 +1,84 @@
+// coverage-kernels.hpp
+//
+// Vectorized kernels for the coverage-map sweeps done by
+// CoverageTracker, with a scalar fallback.
+//
+// Every kernel works on one MAP_BLOCK_SIZE (64-byte) block
+// of a coverage map. Implementations exist for SSE4.2, AVX2
+// and AVX-512BW; the best one supported by the running CPU
+// is selected once, at first use, via cpuid.
+//
+// All implementations are bit-exact with the scalar one.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+/**
+ * The number of coverage-map slots processed by one kernel call
+ */
+constexpr uint32_t MAP_BLOCK_SIZE = 64;
+
+/**
+ * A set of kernel implementations for one instruction set
+ */
+struct coverage_kernels
+{
+    /**
+     * Human-readable name of the instruction set
+     */
+    const char *name;
+
+    /**
+     * The feature name given to __builtin_cpu_supports(), or nullptr
+     * if always supported
+     */
+    const char *cpu_feature;
+
+    /**
+     * In-place AFL bucketization of each slot in the block
+     */
+    void (*bucketize)(uint8_t *block);
+
+    /**
+     * dst[i] = max(dst[i], src[i]) for each slot in the block
+     */
+    void (*max_into)(uint8_t *dst, const uint8_t *src);
+
+    /**
+     * Bit i of the return is set iff a[i] > b[i]
+     */
+    uint64_t (*greater_mask)(const uint8_t *a, const uint8_t *b);
+
+    /**
+     * Bit i of the return is set iff upper_bound[i] != 0 and
+     * x[i] >= upper_bound[i]
+     */
+    uint64_t (*maximizes_mask)(const uint8_t *upper_bound, const uint8_t *x);
+
+    /**
+     * Bit i of the return is set iff a[i] != 0
+     */
+    uint64_t (*nonzero_mask)(const uint8_t *a);
+};
+
+/**
+ * Gets the fastest kernels supported by this CPU
+ */
+const struct coverage_kernels &ActiveCoverageKernels();
+
+/**
+ * Gets every kernel implementation supported by this CPU, scalar first
+ */
+std::vector<const struct coverage_kernels *> SupportedCoverageKernels();
+
+}
+}
@@ -0,0 +1,180 @@
+#include "coverage-snapshot.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+
+namespace regulator
+{
+namespace fuzz
+{
+
+CoverageSnapshot::CoverageSnapshot(const CoverageTracker &tracker, bool keep_observations)
+{
+    this->total = tracker.total;
+    this->path_length = tracker.path_length;
+    this->path_hash = tracker.path_hash;
+    this->map_size = tracker.map_size;
+    this->string_length = tracker.string_length;
+    this->max_observation = tracker.MaxObservation();
+
+    // Size everything first, so that it all fits in one allocation
+    this->n_covered = 0;
+    for (size_t i = 0; i < tracker.dirty_len; i++)
+    {
+        uint64_t bits = tracker.dirty[i];
+        while (bits != 0)
+        {
+            const size_t block = i * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            this->n_covered += __builtin_popcountll(
+                tracker.kernels->nonzero_mask(tracker.covmap + block * MAP_BLOCK_SIZE)
+            );
+        }
+    }
+
+    this->n_suggestions = static_cast<uint32_t>(tracker.suggestions.size());
+
+    this->n_observation_runs = 0;
+    const uint16_t *counts = tracker.char_observation_counts;
+    const bool has_counts = keep_observations && counts != nullptr && this->string_length > 0;
+    if (has_counts)
+    {
+        for (uint32_t i = 0; i < this->string_length; i++)
+        {
+            if (i == 0 || counts[i] != counts[i - 1] || (i % UINT16_MAX) == 0)
+            {
+                this->n_observation_runs++;
+            }
+        }
+    }
+
+    this->Layout();
+
+    // Now fill it in
+    size_t n = 0;
+    for (size_t i = 0; i < tracker.dirty_len; i++)
+    {
+        uint64_t bits = tracker.dirty[i];
+        while (bits != 0)
+        {
+            const size_t block = i * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+
+            const size_t base = block * MAP_BLOCK_SIZE;
+            uint64_t nonzero = tracker.kernels->nonzero_mask(tracker.covmap + base);
+            while (nonzero != 0)
+            {
+                const size_t edge = base + __builtin_ctzll(nonzero);
+                nonzero &= nonzero - 1;
+                this->edges[n] = static_cast<uint32_t>(edge);
+                this->buckets[n] = tracker.covmap[edge];
+                n++;
+            }
+        }
+    }
+
+    if (this->n_suggestions > 0)
+    {
+        memcpy(this->suggestions, tracker.suggestions.data(), this->n_suggestions * sizeof(struct suggestion));
+    }
+
+    if (has_counts)
+    {
+        struct observation_run *run = this->observations - 1;
+        for (uint32_t i = 0; i < this->string_length; i++)
+        {
+            if (i == 0 || counts[i] != counts[i - 1] || (i % UINT16_MAX) == 0)
+            {
+                run++;
+                run->count = counts[i];
+                run->length = 0;
+            }
+            run->length++;
+        }
+    }
+}
+
+
+CoverageSnapshot::CoverageSnapshot(const CoverageSnapshot &other)
+{
+    this->total = other.total;
+    this->path_length = other.path_length;
+    this->path_hash = other.path_hash;
+    this->map_size = other.map_size;
+    this->string_length = other.string_length;
+    this->max_observation = other.max_observation;
+    this->n_covered = other.n_covered;
+    this->n_suggestions = other.n_suggestions;
+    this->n_observation_runs = other.n_observation_runs;
+
+    // the layout only depends on the counts, so the storage copies as-is
+    this->Layout();
+    if (this->storage_len > 0)
+    {
+        memcpy(this->storage, other.storage, this->storage_len);
+    }
+}
+
+
+CoverageSnapshot::~CoverageSnapshot()
+{
+    delete[] this->storage;
+}
+
+
+void CoverageSnapshot::Layout()
+{
+    const size_t suggestions_len = this->n_suggestions * sizeof(struct suggestion);
+    const size_t edges_len = this->n_covered * sizeof(uint32_t);
+    const size_t observations_len = this->n_observation_runs * sizeof(struct observation_run);
+    const size_t buckets_len = this->n_covered * sizeof(cov_t);
+
+    this->storage_len = suggestions_len + edges_len + observations_len + buckets_len;
+    this->storage = this->storage_len == 0 ? nullptr : new uint8_t[this->storage_len];
+
+    uint8_t *next = this->storage;
+    this->suggestions = reinterpret_cast<struct suggestion *>(next);
+    next += suggestions_len;
+    this->edges = reinterpret_cast<uint32_t *>(next);
+    next += edges_len;
+    this->observations = reinterpret_cast<struct observation_run *>(next);
+    next += observations_len;
+    this->buckets = reinterpret_cast<cov_t *>(next);
+}
+
+
+cov_t CoverageSnapshot::Edge(size_t edge_id) const
+{
+    const uint32_t *begin = this->edges;
+    const uint32_t *end = begin + this->n_covered;
+    const uint32_t *found = std::lower_bound(begin, end, edge_id);
+    if (found == end || *found != edge_id)
+    {
+        return 0;
+    }
+    return this->buckets[found - begin];
+}
+
+
+void CoverageSnapshot::GetSuggestions(std::vector<struct suggestion> &out) const
+{
+    out.insert(out.end(), this->suggestions, this->suggestions + this->n_suggestions);
+}
+
+
+uint16_t CoverageSnapshot::Observation(uint32_t i) const
+{
+    for (uint32_t j = 0; j < this->n_observation_runs; j++)
+    {
+        if (i < this->observations[j].length)
+        {
+            return this->observations[j].count;
+        }
+        i -= this->observations[j].length;
+    }
+    return 0;
+}
+
+}
+}
@@ -0,0 +1,171 @@
+// coverage-snapshot.hpp
+//
+// A frozen, compact copy of one execution's coverage.
+//
+// A CoverageTracker is built to be written to: its map is as
+// large as the program (MAP_SIZE slots when hashed) and it keeps
+// a counter per subject character. Corpus entries only ever
+// read their coverage, and typically touch a few dozen edges,
+// so they store a CoverageSnapshot instead: the covered edges
+// as sorted (edge, bucket) pairs, the suggestions, and the
+// tracker's scalar counters -- all in one allocation.
+//
+// The per-character observation counts are reduced to their
+// maximum unless asked for, in which case they are kept
+// run-length encoded.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "coverage-tracker.hpp"
+#include "path-hash.hpp"
+
+namespace regulator
+{
+namespace fuzz
+{
+
+class CoverageSnapshot
+{
+public:
+    /**
+     * Freezes the current state of `tracker`. The observation counts are
+     * only kept (see Observation) if `keep_observations` is set.
+     */
+    CoverageSnapshot(const CoverageTracker &tracker, bool keep_observations = false);
+    CoverageSnapshot(const CoverageSnapshot &other);
+    ~CoverageSnapshot();
+
+    CoverageSnapshot &operator=(const CoverageSnapshot &other) = delete;
+
+    inline uint64_t Total() const
+    {
+        return this->total;
+    };
+
+    inline path_hash_t PathHash() const
+    {
+        return this->path_hash;
+    };
+
+    inline uint64_t PathLength() const
+    {
+        return this->path_length;
+    };
+
+    inline uint16_t MaxObservation() const
+    {
+        return this->max_observation;
+    };
+
+    inline uint32_t StringLength() const
+    {
+        return this->string_length;
+    };
+
+    /**
+     * The number of slots in the coverage map this was taken from
+     */
+    inline uint32_t MapSize() const
+    {
+        return this->map_size;
+    };
+
+    /**
+     * The number of covered (non-zero) edges
+     */
+    inline uint32_t NumCovered() const
+    {
+        return this->n_covered;
+    };
+
+    /**
+     * The ith covered edge, in increasing order of edge id
+     */
+    inline uint32_t CoveredEdge(size_t i) const
+    {
+        return this->edges[i];
+    };
+
+    /**
+     * The (bucketized) count of the ith covered edge
+     */
+    inline cov_t CoveredBucket(size_t i) const
+    {
+        return this->buckets[i];
+    };
+
+    /**
+     * The count of edge `edge_id`, which is zero if it was not covered
+     */
+    cov_t Edge(size_t edge_id) const;
+
+    inline bool EdgeIsCovered(size_t edge_id) const
+    {
+        return this->Edge(edge_id) > 0;
+    };
+
+    /**
+     * Appends the suggested mutations to `out`
+     */
+    void GetSuggestions(std::vector<struct suggestion> &out) const;
+
+    /**
+     * Whether the observation counts were kept
+     */
+    inline bool HasObservations() const
+    {
+        return this->n_observation_runs > 0;
+    };
+
+    /**
+     * The observation count of character `i`; needs HasObservations()
+     */
+    uint16_t Observation(uint32_t i) const;
+
+private:
+    /**
+     * `length` consecutive characters observed `count` times each
+     */
+    struct observation_run
+    {
+        uint16_t count;
+        uint16_t length;
+    };
+
+    /**
+     * Carves the arrays out of `storage`, which must already be sized
+     * for the counts
+     */
+    void Layout();
+
+    uint64_t total;
+    uint64_t path_length;
+    path_hash_t path_hash;
+    uint32_t map_size;
+    uint32_t string_length;
+    uint16_t max_observation;
+
+    uint32_t n_covered;
+    uint32_t n_suggestions;
+    uint32_t n_observation_runs;
+
+    /**
+     * One allocation holding the arrays below, in decreasing order of
+     * alignment
+     */
+    uint8_t *storage;
+    size_t storage_len;
+
+    struct suggestion *suggestions;
+    uint32_t *edges;
+    struct observation_run *observations;
+    cov_t *buckets;
+};
+
+}
+}
@@ -1,8 +1,6 @@
 #include "coverage-tracker.hpp"
-
-extern "C" {
-    #include "murmur3.h"
-}
+#include "coverage-snapshot.hpp"
+#include "path-hash.hpp"
 
 #include <iostream>
 #include <iomanip>
@@ -16,10 +14,39 @@ namespace regulator
 namespace fuzz
 {
 
-CoverageTracker::CoverageTracker(uint32_t string_length)
+/**
+ * Calls `fn(block_index)` for each map block marked in the dirty bitmap
+ * `dirty` (of `dirty_len` entries). If `fn` returns true the iteration
+ * stops early and this returns true.
+ */
+template<typename Fn>
+static inline bool for_each_dirty_block(const uint64_t *dirty, size_t dirty_len, Fn fn)
+{
+    for (size_t i = 0; i < dirty_len; i++)
+    {
+        uint64_t bits = dirty[i];
+        while (bits != 0)
+        {
+            const size_t block = i * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (fn(block))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+CoverageTracker::CoverageTracker(uint32_t string_length, const EdgeIndex *edge_index)
 {
     this->string_length = string_length;
-    this->covmap = new cov_t[MAP_SIZE];
+    this->covmap = nullptr;
+    this->dirty = nullptr;
+    this->is_one_byte = true;
+    this->kernels = &ActiveCoverageKernels();
+    this->Allocate(edge_index);
     if (string_length == 0)
     {
         this->char_observation_counts = nullptr;
@@ -34,8 +61,22 @@ CoverageTracker::CoverageTracker(uint32_t string_length)
 
 CoverageTracker::CoverageTracker(const CoverageTracker &other)
 {
-    this->covmap = new cov_t[MAP_SIZE];
-    memcpy(this->covmap, other.covmap, MAP_SIZE * sizeof(cov_t));
+    // only the dirty blocks can be non-zero, copy just those
+    this->covmap = nullptr;
+    this->dirty = nullptr;
+    this->is_one_byte = other.is_one_byte;
+    this->kernels = other.kernels;
+    this->Allocate(other.edge_index);
+    memcpy(this->dirty, other.dirty, this->dirty_len * sizeof(uint64_t));
+    for_each_dirty_block(this->dirty, this->dirty_len, [&](size_t block) {
+        memcpy(
+            this->covmap + block * MAP_BLOCK_SIZE,
+            other.covmap + block * MAP_BLOCK_SIZE,
+            MAP_BLOCK_SIZE
+        );
+        return false;
+    });
+
     if (other.string_length == 0 || other.char_observation_counts == nullptr)
     {
         this->char_observation_counts = nullptr;
@@ -49,50 +90,61 @@ CoverageTracker::CoverageTracker(const CoverageTracker &other)
     this->path_hash = other.path_hash;
     this->suggestions = other.suggestions;
     this->string_length = other.string_length;
+    this->path_length = other.path_length;
 }
 
 
 CoverageTracker::~CoverageTracker()
 {
     delete[] this->covmap;
+    delete[] this->dirty;
     delete[] this->char_observation_counts;
 }
 
 
-struct hash_data
+void CoverageTracker::Allocate(const EdgeIndex *edge_index)
 {
-    path_hash_t prev_hash;
-    uintptr_t src_addr;
-    uintptr_t dst_addr;
-};
+    delete[] this->covmap;
+    delete[] this->dirty;
 
+    this->edge_index = edge_index;
+    this->map_size = edge_index == nullptr ? MAP_SIZE : edge_index->Size();
 
-void CoverageTracker::Cover(uintptr_t src_addr, uintptr_t dst_addr)
+    // round the allocation up so that sweeps never need a partial word
+    this->dirty_len = (this->map_size + DIRTY_BITMAP_WORD_SLOTS - 1) / DIRTY_BITMAP_WORD_SLOTS;
+    this->covmap = new cov_t[this->dirty_len * DIRTY_BITMAP_WORD_SLOTS]();
+    this->dirty = new uint64_t[this->dirty_len]();
+}
+
+
+void CoverageTracker::UseEdgeIndex(const EdgeIndex *edge_index)
 {
-    // AFL-style --
-    src_addr *= 2;
+    if (edge_index == this->edge_index)
+    {
+        return;
+    }
+    this->Allocate(edge_index);
+    this->Clear();
+}
+
 
+void CoverageTracker::Cover(uintptr_t src_addr, uintptr_t dst_addr)
+{
     if (this->total < UINT64_MAX)
     {
         this->total++;
     }
-    const uint32_t byte_to_set = REGULATOR_FUZZ_TRANSFORM_ADDR(src_addr) ^
-                                REGULATOR_FUZZ_TRANSFORM_ADDR(dst_addr);
+    const uint32_t byte_to_set = this->Slot(src_addr, dst_addr);
 
     // protect from overflow by setting to MAX
     if (this->covmap[byte_to_set] < COV_MAX)
     {
         this->covmap[byte_to_set]++;
     }
+    this->MarkDirty(byte_to_set);
 
     // mix into path hash
-    struct hash_data data;
-    data.prev_hash = this->path_hash;
-    data.src_addr = src_addr;
-    data.dst_addr = dst_addr;
-    path_hash_t out;
-    MurmurHash3_x64_128(&data, sizeof(data), 0xDEADBEEF /* seed */, &out);
-    this->path_hash = out;
+    this->path_hash = REGULATOR_FUZZ_PATH_HASH(this->path_hash, src_addr * 2, dst_addr);
 }
 
 
@@ -110,11 +162,15 @@ uint64_t CoverageTracker::Total()
 void CoverageTracker::Clear()
 {
     this->path_hash = 0;
-#if defined REG_COUNT_PATHLENGTH
     this->path_length = 0;
-#endif
     this->total = 0;
-    memset(this->covmap, 0, MAP_SIZE * sizeof(cov_t));
+
+    for_each_dirty_block(this->dirty, this->dirty_len, [&](size_t block) {
+        memset(this->covmap + block * MAP_BLOCK_SIZE, 0, MAP_BLOCK_SIZE);
+        return false;
+    });
+    memset(this->dirty, 0, this->dirty_len * sizeof(uint64_t));
+
     if (this->char_observation_counts != nullptr)
     {
         memset(this->char_observation_counts, 0, this->string_length * sizeof(uint16_t));
@@ -122,73 +178,37 @@ void CoverageTracker::Clear()
     this->suggestions.clear();
 }
 
-/**
- * bucketization lookup
- */
-static const uint8_t count_class_lookup8[256] = {
-    0,
-
-    1,
-
-    2,
-
-    4,
-
-    8,8,8,8,
-
-    16,16,16,16,16,16,16,16,
-
-    32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,32,
-
-    64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
-    64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
-    64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
-    64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
-    64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
-    64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,64,
-
-    128,128,128,128,128,128,128,128,128,128,128,128,
-    128,128,128,128,128,128,128,128,128,128,128,128,
-    128,128,128,128,128,128,128,128,128,128,128,128,
-    128,128,128,128,128,128,128,128,128,128,128,128,
-    128,128,128,128,128,128,128,128,128,128,128,128,
-    128,128,128,128,128,128,128,128,128,128,128,128,
-    128,128,128,128,128,128,128,128,128,128,128,128,
-    128,128,128,128,128,128,128,128,128,128,128,128,
-    128,128,128,128,128,128,128,128,128,128,128,128,
-    128,128,128,128,128,128,128,128,128,128,128,128,
-    128,128,128,128,128,128,128,128,
-};
-
 void CoverageTracker::Bucketize()
 {
-    uint64_t *slot_ptr = reinterpret_cast<uint64_t *>(this->covmap);
-    uint8_t *curr;
+    for_each_dirty_block(this->dirty, this->dirty_len, [&](size_t block) {
+        this->kernels->bucketize(this->covmap + block * MAP_BLOCK_SIZE);
+        return false;
+    });
+}
 
-    for (size_t i=0; i<MAP_SIZE / sizeof(slot_ptr); i++)
+void CoverageTracker::Union(CoverageTracker *other)
+{
+    for_each_dirty_block(other->dirty, other->dirty_len, [&](size_t block) {
+        const size_t base = block * MAP_BLOCK_SIZE;
+        this->kernels->max_into(this->covmap + base, other->covmap + base);
+        return false;
+    });
+    for (size_t i = 0; i < other->dirty_len; i++)
     {
-        if (slot_ptr[i] != 0)
-        {
-            curr = reinterpret_cast<uint8_t *>(&slot_ptr[i]);
-            curr[0] = count_class_lookup8[curr[0]];
-            curr[1] = count_class_lookup8[curr[1]];
-            curr[2] = count_class_lookup8[curr[2]];
-            curr[3] = count_class_lookup8[curr[3]];
-            curr[4] = count_class_lookup8[curr[4]];
-            curr[5] = count_class_lookup8[curr[5]];
-            curr[6] = count_class_lookup8[curr[6]];
-            curr[7] = count_class_lookup8[curr[7]];
-        }
+        this->dirty[i] |= other->dirty[i];
     }
+    this->total = std::max(this->total, other->total);
 }
 
-void CoverageTracker::Union(CoverageTracker *other)
+void CoverageTracker::Union(const CoverageSnapshot &other)
 {
-    for (size_t i=0; i < MAP_SIZE; i++)
+    for (size_t i = 0; i < other.NumCovered(); i++)
     {
-        this->covmap[i] = std::max(this->covmap[i], other->covmap[i]);
+        const uint32_t edge = other.CoveredEdge(i);
+        this->covmap[edge] = std::max(this->covmap[edge], other.CoveredBucket(i));
+        this->MarkDirty(edge);
     }
-    this->total = std::max(this->total, other->total);
+    this->total = std::max(this->total, other.Total());
 }
 
 bool CoverageTracker::HasNewPath(CoverageTracker *other)
@@ -200,28 +220,88 @@ bool CoverageTracker::HasNewPath(CoverageTracker *other)
         return true;
     }
 
-    // Check if `other` has ANY more coverage on an individual
-    for (size_t i=0; i < MAP_SIZE; i++)
+    // Check if `other` has ANY more coverage on an individual edge;
+    // only the blocks `other` touched can hold such an edge
+    return for_each_dirty_block(other->dirty, other->dirty_len, [&](size_t block) {
+        const size_t base = block * MAP_BLOCK_SIZE;
+        return this->kernels->greater_mask(other->covmap + base, this->covmap + base) != 0;
+    });
+}
+
+bool CoverageTracker::MaximizesAnyEdge(CoverageTracker *other) const
+{
+    // an edge maximized by `other` must be non-zero in `this`
+    return for_each_dirty_block(this->dirty, this->dirty_len, [&](size_t block) {
+        const size_t base = block * MAP_BLOCK_SIZE;
+        return this->kernels->maximizes_mask(this->covmap + base, other->covmap + base) != 0;
+    });
+}
+
+void CoverageTracker::Compare(CoverageTracker *other, std::vector<struct block_comparison> &out) const
+{
+    for_each_dirty_block(other->dirty, other->dirty_len, [&](size_t block) {
+        const size_t base = block * MAP_BLOCK_SIZE;
+        const uint64_t greater = this->kernels->greater_mask(other->covmap + base, this->covmap + base);
+        const uint64_t maximizes = this->kernels->maximizes_mask(this->covmap + base, other->covmap + base);
+        if ((greater | maximizes) != 0)
+        {
+            struct block_comparison cmp;
+            cmp.base = static_cast<uint32_t>(base);
+            cmp.greater = greater;
+            cmp.equal = maximizes & ~greater;
+            out.push_back(cmp);
+        }
+        return false;
+    });
+}
+
+bool CoverageTracker::MaximizesAnyEdge(const CoverageSnapshot &other) const
+{
+    // a maximized edge is non-zero in both, so only `other`'s edges matter
+    for (size_t i = 0; i < other.NumCovered(); i++)
     {
-        if (other->covmap[i] > this->covmap[i])
+        if (this->covmap[other.CoveredEdge(i)] == other.CoveredBucket(i))
         {
             return true;
         }
     }
-
     return false;
 }
 
-bool CoverageTracker::MaximizesAnyEdge(CoverageTracker *other) const
+void CoverageTracker::Compare(const CoverageSnapshot &other, std::vector<struct block_comparison> &out) const
 {
-    for (size_t i=0; i < MAP_SIZE; i++)
+    // the snapshot's edges are sorted, so each block's edges are adjacent
+    struct block_comparison cmp;
+    cmp.base = UINT32_MAX;
+    for (size_t i = 0; i < other.NumCovered(); i++)
     {
-        if (this->covmap[i] != 0 && other->covmap[i] >= this->covmap[i])
+        const uint32_t edge = other.CoveredEdge(i);
+        const uint32_t base = edge - edge % MAP_BLOCK_SIZE;
+        if (base != cmp.base)
         {
-            return true;
+            if (cmp.base != UINT32_MAX && (cmp.greater | cmp.equal) != 0)
+            {
+                out.push_back(cmp);
+            }
+            cmp.base = base;
+            cmp.greater = 0;
+            cmp.equal = 0;
+        }
+
+        const uint64_t bit = static_cast<uint64_t>(1) << (edge - base);
+        if (other.CoveredBucket(i) > this->covmap[edge])
+        {
+            cmp.greater |= bit;
+        }
+        else if (other.CoveredBucket(i) == this->covmap[edge])
+        {
+            cmp.equal |= bit;
         }
     }
-    return false;
+    if (cmp.base != UINT32_MAX && (cmp.greater | cmp.equal) != 0)
+    {
+        out.push_back(cmp);
+    }
 }
 
 bool CoverageTracker::EdgeIsEqual(CoverageTracker *other, size_t edge_id) const
@@ -229,6 +309,11 @@ bool CoverageTracker::EdgeIsEqual(CoverageTracker *other, size_t edge_id) const
     return this->covmap[edge_id] == other->covmap[edge_id];
 }
 
+bool CoverageTracker::EdgeIsEqual(const CoverageSnapshot &other, size_t edge_id) const
+{
+    return this->covmap[edge_id] == other.Edge(edge_id);
+}
+
 bool CoverageTracker::EdgeIsGreater(CoverageTracker *other, size_t edge_id) const
 {
     return this->covmap[edge_id] > other->covmap[edge_id];
@@ -241,9 +326,7 @@ bool CoverageTracker::EdgeIsCovered(size_t edge_id) const
 
 void CoverageTracker::Suggest(uintptr_t src, uintptr_t dst, uint16_t c, int pos)
 {
-    src *= 2;
-    const uint32_t byte_to_set = REGULATOR_FUZZ_TRANSFORM_ADDR(src) ^
-                            REGULATOR_FUZZ_TRANSFORM_ADDR(dst);
+    const uint32_t byte_to_set = this->Slot(src, dst);
 
     // see if we already have a suggestion for this component
     for (size_t i=0; i < this->suggestions.size(); i++)
@@ -273,16 +356,13 @@ void CoverageTracker::GetSuggestions(std::vector<struct suggestion> &out) const
 double CoverageTracker::Residency() const
 {
     size_t num_occupied_slots = 0;
-    for (size_t i=0; i < MAP_SIZE; i++)
-    {
-        // todo: do some loop unrolling here
-        if (this->covmap[i] != 0)
-        {
-            num_occupied_slots++;
-        }
-    }
+    for_each_dirty_block(this->dirty, this->dirty_len, [&](size_t block) {
+        const size_t base = block * MAP_BLOCK_SIZE;
+        num_occupied_slots += __builtin_popcountll(this->kernels->nonzero_mask(this->covmap + base));
+        return false;
+    });
 
-    return num_occupied_slots / static_cast<double>(MAP_SIZE);
+    return num_occupied_slots / static_cast<double>(this->map_size);
 }
 
 void CoverageTracker::Observe(uint32_t i)
@@ -309,7 +389,6 @@ uint16_t CoverageTracker::MaxObservation() const
     return max;
 }
 
-#if defined REG_COUNT_PATHLENGTH
 uint64_t CoverageTracker::PathLength() const
 {
     return this->path_length;
@@ -323,7 +402,6 @@ void CoverageTracker::IncPathLength()
     auto prev = this->path_length;
     this->path_length = std::max((uint64_t)(prev + 1), prev);
 }
-#endif
 
 }
 }
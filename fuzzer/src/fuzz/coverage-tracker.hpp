@@ -13,8 +13,14 @@
 // such that upon execution of an instruction
 // which has two or more successors, the engine
 // calls CoverageTracker::Cover(src, dst), where
-// `src` is the address of the branching statement,
-// and `dst` is the address of the chosen successor.
+// `src` is the bytecode offset of the branching statement,
+// and `dst` is the offset of the chosen successor.
+//
+// By default (src, dst) is hashed into a fixed-size
+// map of MAP_SIZE slots. When the tracker is given
+// an EdgeIndex (see edge-index.hpp), every edge instead
+// gets its own slot and the map is exactly as large
+// as the program's edge count.
 //
 // AFL also "bucketizes" the coverage map's cells,
 // so that small variations in iteration count of
@@ -22,6 +28,15 @@
 // Calling CoverageTracker::Bucketize() will in-place
 // modify the coverage map to replicate this behavior.
 //
+// Most executions only touch a small fraction of the
+// coverage map, so the tracker also keeps a bitmap of
+// "dirty" 64-byte blocks of the map which may be non-zero.
+// Sweeps over the map (Clear, Bucketize, Union, ...) only
+// visit those blocks, so per-execution work scales with
+// the number of edges touched rather than with MAP_SIZE.
+// Each block is processed with the vectorized kernels of
+// coverage-kernels.hpp.
+//
 
 #pragma once
 
@@ -29,13 +44,15 @@
 #include <cstring>
 #include <vector>
 
+#include "path-hash.hpp"
+#include "edge-index.hpp"
+#include "coverage-kernels.hpp"
+
 namespace regulator
 {
 namespace fuzz
 {
 
-typedef __int128_t path_hash_t;
-
 /**
  * Tracks coverage of a single cfg edge
  */
@@ -62,6 +79,25 @@ constexpr uint32_t CODE_MASK = (1 << MAX_CODE_SIZE) - 1;
 // KEEP A MULTIPLE OF TWO
 constexpr uint32_t MAP_SIZE = 1 << MAX_CODE_SIZE;
 
+/**
+ * The number of map slots tracked by one uint64_t of the dirty bitmap
+ */
+constexpr uint32_t DIRTY_BITMAP_WORD_SLOTS = MAP_BLOCK_SIZE * 64;
+
+/**
+ * The result of comparing one map block of a tracker against an
+ * upper bound (see CoverageTracker::Compare)
+ */
+struct block_comparison
+{
+    // the index of the first slot in the block
+    uint32_t base;
+    // bit i is set iff slot base + i exceeds the upper bound
+    uint64_t greater;
+    // bit i is set iff slot base + i equals the (non-zero) upper bound
+    uint64_t equal;
+};
+
 struct suggestion
 {
     // the suggested char (if 1-byte, use lower half)
@@ -73,6 +109,8 @@ struct suggestion
     uint32_t component;
 };
 
+class CoverageSnapshot;
+
 /**
  * AFL-style coverage tracker.
  * 
@@ -81,11 +119,45 @@ struct suggestion
  */
 class CoverageTracker {
 public:
-    CoverageTracker(uint32_t string_length);
+    /**
+     * Creates a tracker for subjects of length `string_length`.
+     *
+     * If `edge_index` is non-null then each edge of the indexed program
+     * gets its own slot; otherwise edges are hashed into MAP_SIZE slots.
+     */
+    CoverageTracker(uint32_t string_length, const EdgeIndex *edge_index = nullptr);
     CoverageTracker(const CoverageTracker &other);
     ~CoverageTracker();
 
 
+    /**
+     * Switches this tracker to the given edge index (or to hashed
+     * coverage, if null). Clears the tracker if the index changed.
+     */
+    void UseEdgeIndex(const EdgeIndex *edge_index);
+
+
+    /**
+     * Selects which of the regexp's programs (one-byte or two-byte)
+     * subsequent calls to Cover() refer to. Only meaningful with an
+     * edge index.
+     */
+    inline void SelectProgram(bool is_one_byte)
+    {
+        this->is_one_byte = is_one_byte;
+    };
+
+
+    /**
+     * The number of slots in the coverage map; valid edge ids are
+     * 0 ... MapSize() - 1
+     */
+    inline uint32_t MapSize() const
+    {
+        return this->map_size;
+    };
+
+
     /**
      * Mark a branch from src_addr to dst_addr as covered
      */
@@ -109,6 +181,16 @@ public:
      * tracker.
      */
     void Union(CoverageTracker *other);
+    void Union(const CoverageSnapshot &other);
+
+
+    /**
+     * Compares `other` against `this` (normally an upper bound) in a
+     * single sweep over the blocks `other` touched. Appends one entry to
+     * `out` for each block where `other` exceeds or ties any non-zero edge.
+     */
+    void Compare(CoverageTracker *other, std::vector<struct block_comparison> &out) const;
+    void Compare(const CoverageSnapshot &other, std::vector<struct block_comparison> &out) const;
 
 
     /**
@@ -124,6 +206,7 @@ public:
      * corresponding edge in `this`.
      */
     bool MaximizesAnyEdge(CoverageTracker *other) const;
+    bool MaximizesAnyEdge(const CoverageSnapshot &other) const;
 
 
     /**
@@ -131,6 +214,7 @@ public:
      * in both `this` and `other`.
      */
     bool EdgeIsEqual(CoverageTracker *other, size_t edge_id) const;
+    bool EdgeIsEqual(const CoverageSnapshot &other, size_t edge_id) const;
 
 
     /**
@@ -188,6 +272,15 @@ public:
     };
 
 
+    /**
+     * The subject length this tracker observes characters of
+     */
+    inline uint32_t StringLength() const
+    {
+        return this->string_length;
+    };
+
+
     /**
      * Gets the percentage of slots which are non-zero.
      * 
@@ -226,7 +319,6 @@ public:
      */
     uint16_t MaxObservation() const;
 
-#if defined REG_COUNT_PATHLENGTH
     /**
      * Get the number of instructions executed
      */
@@ -236,18 +328,56 @@ public:
      * Increment the path length count
      */
     void IncPathLength();
-#endif
 
 private:
+    friend class CoverageSnapshot;
+
+    /**
+     * Gets the coverage map slot for the transition `src` -> `dst`
+     */
+    inline uint32_t Slot(uintptr_t src, uintptr_t dst) const
+    {
+        if (this->edge_index != nullptr)
+        {
+            return this->edge_index->Lookup(this->is_one_byte, src, dst);
+        }
+        // AFL-style --
+        return REGULATOR_FUZZ_TRANSFORM_ADDR(src * 2) ^
+               REGULATOR_FUZZ_TRANSFORM_ADDR(dst);
+    };
+
+    /**
+     * (Re-)allocates the coverage map and dirty bitmap for `edge_index`
+     */
+    void Allocate(const EdgeIndex *edge_index);
+
+    /**
+     * Marks the map block holding slot `slot` as possibly non-zero
+     */
+    inline void MarkDirty(uint32_t slot)
+    {
+        const uint32_t block = slot / MAP_BLOCK_SIZE;
+        this->dirty[block / 64] |= static_cast<uint64_t>(1) << (block % 64);
+    };
+
     cov_t *covmap;
+
+    /**
+     * One bit per block of `covmap`; a block whose bit is clear is
+     * guaranteed to be all-zero. Has dirty_len entries.
+     */
+    uint64_t *dirty;
+    uint32_t dirty_len;
+    uint32_t map_size;
+    const EdgeIndex *edge_index;
+    bool is_one_byte;
+    const struct coverage_kernels *kernels;
     std::vector<struct suggestion> suggestions;
     uint64_t total;
     path_hash_t path_hash;
     uint32_t string_length;
     uint16_t *char_observation_counts;
-#if defined REG_COUNT_PATHLENGTH
     uint64_t path_length;
-#endif
 };
 
 }
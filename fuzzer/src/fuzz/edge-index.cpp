@@ -0,0 +1,72 @@
+#include "edge-index.hpp"
+
+#include <algorithm>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+EdgeIndex::EdgeIndex(
+    const edge_list_t &one_byte_edges,
+    size_t one_byte_code_length,
+    const edge_list_t &two_byte_edges,
+    size_t two_byte_code_length)
+{
+    Build(this->one_byte, one_byte_edges, one_byte_code_length, 0);
+    const uint32_t n_one_byte = this->one_byte.first[this->one_byte.n_units];
+    Build(this->two_byte, two_byte_edges, two_byte_code_length, n_one_byte);
+    const uint32_t n_two_byte = this->two_byte.first[this->two_byte.n_units];
+
+    // plus one id reserved for unknown transitions
+    this->n_ids = n_one_byte + n_two_byte + 1;
+}
+
+
+EdgeIndex::~EdgeIndex()
+{
+    delete[] this->one_byte.first;
+    delete[] this->one_byte.targets;
+    delete[] this->two_byte.first;
+    delete[] this->two_byte.targets;
+}
+
+
+void EdgeIndex::Build(
+    struct program &out,
+    const edge_list_t &edges,
+    size_t code_length,
+    uint32_t base_id)
+{
+    edge_list_t sorted;
+    for (size_t i = 0; i < edges.size(); i++)
+    {
+        if (edges[i].first < code_length)
+        {
+            sorted.push_back(edges[i]);
+        }
+    }
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+    out.n_units = (code_length + BYTECODE_ALIGNMENT - 1) / BYTECODE_ALIGNMENT;
+    out.first = new uint32_t[out.n_units + 1];
+    out.targets = new uint32_t[std::max(sorted.size(), static_cast<size_t>(1))];
+    out.base_id = base_id;
+
+    // counting pass, then prefix-sum into `first`
+    size_t edge_idx = 0;
+    for (size_t unit = 0; unit < out.n_units; unit++)
+    {
+        out.first[unit] = static_cast<uint32_t>(edge_idx);
+        while (edge_idx < sorted.size() && sorted[edge_idx].first / BYTECODE_ALIGNMENT == unit)
+        {
+            out.targets[edge_idx] = sorted[edge_idx].second;
+            edge_idx++;
+        }
+    }
+    out.first[out.n_units] = static_cast<uint32_t>(edge_idx);
+}
+
+}
+}
@@ -0,0 +1,172 @@
+// edge-index.hpp
+//
+// Maps the branch transitions of a compiled regexp to
+// dense, collision-free coverage-map slots.
+//
+// The hashed coverage map (see REGULATOR_FUZZ_TRANSFORM_ADDR)
+// lets distinct branches alias onto one slot, and large
+// programs collide heavily in the fixed MAP_SIZE map. When
+// the bytecode is known ahead of time we can instead scan it
+// once (see edge-finder.hpp), enumerate every (branch offset,
+// successor offset) pair the interpreter may report, and give
+// each one its own slot. The coverage map is then exactly as
+// large as the program's edge count.
+//
+// A regexp has separate bytecode for one-byte and two-byte
+// subjects; both programs share one index (and so one map),
+// the two-byte program's ids following the one-byte ones.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+/**
+ * A list of (branch offset, successor offset) pairs
+ */
+typedef std::vector<std::pair<uint32_t, uint32_t>> edge_list_t;
+
+/**
+ * Bytecode instructions are aligned to this many bytes
+ */
+const uint32_t BYTECODE_ALIGNMENT = 4;
+
+/**
+ * Lookups which scan at most this many successors linearly before
+ * falling back to binary search (only POP_BT has many successors)
+ */
+const uint32_t EDGE_LINEAR_SCAN_MAX = 8;
+
+
+class EdgeIndex
+{
+public:
+    /**
+     * Builds the index from the edges of the one-byte and two-byte
+     * bytecode programs. `*_code_length` is the program length in bytes.
+     */
+    EdgeIndex(
+        const edge_list_t &one_byte_edges,
+        size_t one_byte_code_length,
+        const edge_list_t &two_byte_edges,
+        size_t two_byte_code_length
+    );
+    ~EdgeIndex();
+
+    EdgeIndex(const EdgeIndex &other) = delete;
+
+    /**
+     * Gets the dense id of the transition `src` -> `dst` (both bytecode
+     * offsets) in the one-byte or two-byte program.
+     *
+     * Transitions not found by the pre-scan all share the id UnknownId().
+     */
+    inline uint32_t Lookup(bool is_one_byte, uintptr_t src, uintptr_t dst) const
+    {
+        const struct program &prog = is_one_byte ? this->one_byte : this->two_byte;
+        const uintptr_t unit = src / BYTECODE_ALIGNMENT;
+        if (unit >= prog.n_units)
+        {
+            return this->UnknownId();
+        }
+
+        uint32_t lo = prog.first[unit];
+        uint32_t hi = prog.first[unit + 1];
+
+        if (hi - lo > EDGE_LINEAR_SCAN_MAX)
+        {
+            // binary search the (sorted) successors
+            while (lo < hi)
+            {
+                const uint32_t mid = lo + (hi - lo) / 2;
+                if (prog.targets[mid] < dst)
+                {
+                    lo = mid + 1;
+                }
+                else
+                {
+                    hi = mid;
+                }
+            }
+            hi = prog.first[unit + 1];
+            if (lo < hi && prog.targets[lo] == dst)
+            {
+                return prog.base_id + lo;
+            }
+            return this->UnknownId();
+        }
+
+        for (uint32_t i = lo; i < hi; i++)
+        {
+            if (prog.targets[i] == dst)
+            {
+                return prog.base_id + i;
+            }
+        }
+        return this->UnknownId();
+    };
+
+    /**
+     * The id shared by all transitions not found during the pre-scan
+     */
+    inline uint32_t UnknownId() const
+    {
+        return this->n_ids - 1;
+    };
+
+    /**
+     * The number of distinct ids (including UnknownId())
+     */
+    inline uint32_t Size() const
+    {
+        return this->n_ids;
+    };
+
+private:
+    struct program
+    {
+        /**
+         * Indexed by (src offset / BYTECODE_ALIGNMENT); the successors of
+         * src are targets[first[unit]] ... targets[first[unit + 1] - 1].
+         * Has n_units + 1 entries.
+         */
+        uint32_t *first;
+
+        /**
+         * Successor offsets, grouped by source and sorted within a group
+         */
+        uint32_t *targets;
+
+        /**
+         * The number of addressable source units
+         */
+        size_t n_units;
+
+        /**
+         * Added to a position in `targets` to get the edge id
+         */
+        uint32_t base_id;
+    };
+
+    static void Build(
+        struct program &out,
+        const edge_list_t &edges,
+        size_t code_length,
+        uint32_t base_id
+    );
+
+    struct program one_byte;
+    struct program two_byte;
+    uint32_t n_ids;
+};
+
+}
+}
@@ -0,0 +1,119 @@
+#include "helper-pool.hpp"
+
+#include <algorithm>
+
+
+namespace regulator
+{
+namespace fuzz
+{
+
+HelperPool::HelperPool(size_t n_helpers, std::function<void()> thread_init)
+{
+    this->shutting_down = false;
+    for (size_t i = 0; i < n_helpers; i++)
+    {
+        this->threads.emplace_back(&HelperPool::HelperMain, this, thread_init);
+    }
+}
+
+
+HelperPool::~HelperPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->shutting_down = true;
+    }
+    this->work_available.notify_all();
+
+    for (size_t i = 0; i < this->threads.size(); i++)
+    {
+        this->threads[i].join();
+    }
+}
+
+
+void HelperPool::Run(size_t n_tasks, const std::function<void(size_t)> &task)
+{
+    struct batch b;
+    b.task = &task;
+    b.n_tasks = n_tasks;
+    b.next = 0;
+    b.n_helpers_attached = 0;
+
+    if (this->threads.size() > 0 && n_tasks > 1)
+    {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->batches.push_back(&b);
+        }
+        this->work_available.notify_all();
+    }
+
+    Drain(&b);
+
+    // every task is claimed; wait for helpers still running one to let go
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->Retire(&b);
+    this->helper_detached.wait(lock, [&b] { return b.n_helpers_attached == 0; });
+}
+
+
+void HelperPool::Drain(struct batch *b)
+{
+    size_t i;
+    while ((i = b->next.fetch_add(1)) < b->n_tasks)
+    {
+        (*b->task)(i);
+    }
+}
+
+
+void HelperPool::Retire(struct batch *b)
+{
+    auto it = std::find(this->batches.begin(), this->batches.end(), b);
+    if (it != this->batches.end())
+    {
+        this->batches.erase(it);
+    }
+}
+
+
+void HelperPool::HelperMain(std::function<void()> thread_init)
+{
+    if (thread_init)
+    {
+        thread_init();
+    }
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (true)
+    {
+        this->work_available.wait(lock, [this] {
+            return this->shutting_down || !this->batches.empty();
+        });
+
+        if (this->shutting_down)
+        {
+            return;
+        }
+
+        struct batch *b = this->batches.front();
+        b->n_helpers_attached++;
+
+        lock.unlock();
+        Drain(b);
+        lock.lock();
+
+        // the batch is exhausted, so no other helper should pick it up
+        this->Retire(b);
+        b->n_helpers_attached--;
+        if (b->n_helpers_attached == 0)
+        {
+            this->helper_detached.notify_all();
+        }
+    }
+}
+
+}
+}
@@ -0,0 +1,102 @@
+// helper-pool.hpp
+//
+// A pool of helper threads which fan out the work of a
+// single fuzz campaign.
+//
+// Normally each worker thread works on one campaign at a
+// time, so a fuzz run with fewer campaigns than threads
+// leaves cores idle. The spare threads instead join a
+// HelperPool: a worker hands a batch of independent tasks
+// (e.g. evaluating a parent's children) to Run(), and the
+// helpers work through it alongside the calling thread.
+//
+// Several workers may Run() batches at once; idle helpers
+// take tasks from the oldest outstanding batch.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+class HelperPool
+{
+public:
+    /**
+     * Starts `n_helpers` helper threads. Each one calls `thread_init`
+     * (if given) once before taking any work -- use it to set up
+     * thread-local state such as a V8 isolate.
+     */
+    HelperPool(size_t n_helpers, std::function<void()> thread_init = nullptr);
+
+    /**
+     * Stops and joins all helpers. No batch may be running.
+     */
+    ~HelperPool();
+
+    /**
+     * The number of helper threads (not counting callers of Run())
+     */
+    inline size_t Size() const
+    {
+        return this->threads.size();
+    };
+
+    /**
+     * Calls `task(i)` once for each i in [0, n_tasks), on the calling
+     * thread and on any idle helpers, and returns once all calls have
+     * returned. Tasks may run in any order and concurrently.
+     */
+    void Run(size_t n_tasks, const std::function<void(size_t)> &task);
+
+private:
+    struct batch
+    {
+        const std::function<void(size_t)> *task;
+        size_t n_tasks;
+
+        // the next task index to hand out
+        std::atomic<size_t> next;
+
+        // the number of helpers currently holding a pointer to this
+        // batch; guarded by `mutex`
+        size_t n_helpers_attached;
+    };
+
+    /**
+     * Entry point of a helper thread
+     */
+    void HelperMain(std::function<void()> thread_init);
+
+    /**
+     * Runs tasks of `b` until none remain unclaimed
+     */
+    static void Drain(struct batch *b);
+
+    /**
+     * Removes `b` from the outstanding batches, if present. Requires
+     * `mutex` to be held.
+     */
+    void Retire(struct batch *b);
+
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable helper_detached;
+    std::deque<struct batch *> batches;
+    bool shutting_down;
+    std::vector<std::thread> threads;
+};
+
+}
+}
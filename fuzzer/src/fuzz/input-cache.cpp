@@ -0,0 +1,92 @@
+#include "input-cache.hpp"
+
+#include <algorithm>
+
+
+namespace regulator
+{
+namespace fuzz
+{
+
+InputCache::InputCache(size_t n_slots)
+{
+    size_t capacity = 1;
+    while (capacity < n_slots)
+    {
+        capacity *= 2;
+    }
+    this->slots.assign(capacity, 0);
+    this->mask = capacity - 1;
+    this->n_lookups = 0;
+    this->n_hits = 0;
+}
+
+
+bool InputCache::Lookup(uint64_t hash)
+{
+    const uint64_t key = this->Key(hash);
+
+    this->n_lookups++;
+    if (this->slots[key & this->mask] == key)
+    {
+        this->n_hits++;
+        return true;
+    }
+    return false;
+}
+
+
+void InputCache::Insert(uint64_t hash)
+{
+    const uint64_t key = this->Key(hash);
+    this->slots[key & this->mask] = key;
+}
+
+
+template<typename Char>
+void InputCache::DropDuplicates(ChildEdits<Char> &children)
+{
+    const size_t n_children = children.Size();
+    this->batch.resize(n_children);
+    for (size_t i = 0; i < n_children; i++)
+    {
+        this->batch[i] = std::make_pair(children.Hash(i), i);
+    }
+
+    // identical children end up next to each other, the first one first
+    std::sort(this->batch.begin(), this->batch.end());
+
+    bool any_dropped = false;
+    this->keep.assign(n_children, 0);
+    for (size_t j = 0; j < n_children; j++)
+    {
+        const uint64_t hash = this->batch[j].first;
+        if (j > 0 && this->batch[j - 1].first == hash)
+        {
+            // a repeat within the batch
+            this->n_lookups++;
+            this->n_hits++;
+            any_dropped = true;
+        }
+        else if (this->Lookup(hash))
+        {
+            any_dropped = true;
+        }
+        else
+        {
+            this->keep[this->batch[j].second] = 1;
+        }
+    }
+
+    if (any_dropped)
+    {
+        children.Retain(this->keep);
+    }
+}
+
+
+template void InputCache::DropDuplicates(ChildEdits<uint8_t> &children);
+template void InputCache::DropDuplicates(ChildEdits<uint16_t> &children);
+
+}
+}
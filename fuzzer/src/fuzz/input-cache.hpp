@@ -0,0 +1,136 @@
+// input-cache.hpp
+//
+// Remembers which inputs a campaign executed recently, so that
+// a child identical to one of them need not run again. Only
+// executions which completed are remembered: one stopped early
+// (by the budget or the watchdog) may well finish next time.
+//
+// Many children turn out identical to their parent or to a
+// sibling (eg rotating a uniform string, or swapping equal
+// characters). A batch of children is therefore first reduced
+// to its distinct children -- which drops all but the first of
+// any identical siblings, or of the children which left the
+// parent unchanged -- and those are then checked against the
+// cache, which catches inputs from earlier batches.
+//
+// Each input is identified by a 64-bit content hash: the XOR
+// of a mix of every (position, char) pair. A child's hash then
+// follows from its parent's in time proportional to its edits
+// (see ChildEdits::Hash).
+//
+// The cache is direct-mapped: a newer hash evicts whichever
+// hash held its slot. It has no false positives beyond hash
+// collisions, unlike a Bloom filter, so a genuinely new child
+// is never skipped in practice.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "child-edits.hpp"
+
+namespace regulator
+{
+namespace fuzz
+{
+
+/**
+ * The default number of hashes an InputCache holds
+ */
+const size_t INPUT_CACHE_SLOTS = 1 << 14;
+
+/**
+ * The contribution of char `c` at position `pos` to an input's hash
+ */
+inline uint64_t input_hash_term(size_t pos, uint32_t c)
+{
+    // SplitMix64's finalizer; a bijection, so every pair mixes differently
+    uint64_t x = (static_cast<uint64_t>(pos) << 16) ^ c;
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * The content hash of `buf`
+ */
+template<typename Char>
+inline uint64_t input_hash(const Char *buf, size_t buflen)
+{
+    uint64_t ret = 0;
+    for (size_t i = 0; i < buflen; i++)
+    {
+        ret ^= input_hash_term(i, buf[i]);
+    }
+    return ret;
+}
+
+class InputCache
+{
+public:
+    /**
+     * Creates a cache of `n_slots` hashes (rounded up to a power of two)
+     */
+    InputCache(size_t n_slots = INPUT_CACHE_SLOTS);
+
+    /**
+     * Returns true if the input with hash `hash` was inserted recently.
+     * Counted in Lookups() and Hits().
+     */
+    bool Lookup(uint64_t hash);
+
+    /**
+     * Remembers the input with hash `hash`
+     */
+    void Insert(uint64_t hash);
+
+    /**
+     * Drops the children which are identical to an earlier child of the
+     * batch, or to a remembered input. Every child counts as a lookup, and
+     * every dropped one as a hit.
+     */
+    template<typename Char>
+    void DropDuplicates(ChildEdits<Char> &children);
+
+    inline uintmax_t Lookups() const
+    {
+        return this->n_lookups;
+    };
+
+    inline uintmax_t Hits() const
+    {
+        return this->n_hits;
+    };
+
+private:
+    /**
+     * The slot value for `hash`; zero marks an empty slot
+     */
+    inline uint64_t Key(uint64_t hash) const
+    {
+        return hash == 0 ? 1 : hash;
+    };
+
+    std::vector<uint64_t> slots;
+    size_t mask;
+
+    /**
+     * Scratch for DropDuplicates: each child's hash and index, and
+     * whether to keep it
+     */
+    std::vector<std::pair<uint64_t, size_t>> batch;
+    std::vector<uint8_t> keep;
+
+    uintmax_t n_lookups;
+    uintmax_t n_hits;
+};
+
+}
+}
@@ -0,0 +1,50 @@
+// instrumentation.hpp
+//
+// Selects how much bookkeeping the instrumented regexp
+// interpreter performs on each execution.
+//
+// The interpreter loop is instantiated once per tier, with
+// the tier's policy as a template argument, so a tier which
+// does not need (say) observations pays nothing for them:
+// the guarded calls are constant-folded away.
+//
+//   kInstrumentNone        -- plain matching, no tracker required
+//   kInstrumentPathLength  -- count executed bytecodes only
+//   kInstrumentEdges       -- edge coverage and Total (for max_total)
+//   kInstrumentFull        -- edges, plus character observations and
+//                             mutation suggestions (what fuzzing uses)
+//
+
+#pragma once
+
+namespace regulator
+{
+namespace fuzz
+{
+
+enum Instrumentation
+{
+    kInstrumentNone,
+    kInstrumentPathLength,
+    kInstrumentEdges,
+    kInstrumentFull,
+};
+
+/**
+ * Compile-time description of what one tier records
+ */
+template<bool PathLength, bool Edges, bool Observations>
+struct instrumentation_policy
+{
+    static constexpr bool kPathLength = PathLength;
+    static constexpr bool kEdges = Edges;
+    static constexpr bool kObservations = Observations;
+};
+
+typedef instrumentation_policy<false, false, false> InstrumentNonePolicy;
+typedef instrumentation_policy<true, false, false> InstrumentPathLengthPolicy;
+typedef instrumentation_policy<false, true, false> InstrumentEdgesPolicy;
+typedef instrumentation_policy<false, true, true> InstrumentFullPolicy;
+
+}
+}
@@ -1,6 +1,7 @@
 #include "mutations.hpp"
 #include "coverage-tracker.hpp"
 
+#include <algorithm>
 #include <cstdint>
 #include <random>
 #include <cmath>
@@ -41,61 +42,66 @@ const uint16_t interesting_two_byte[] = {
 };
 
 
-inline size_t pick_random_index(const size_t &exclusive_max)
+inline size_t pick_random_index(const size_t &exclusive_max, Random &rng)
 {
-    return random() % exclusive_max;
+    return rng.Below(exclusive_max);
 }
 
 
 template<typename Char>
-inline void mutate_random_char(Char *buf, size_t buflen)
+inline struct mutated_range mutate_random_char(Char *buf, size_t buflen, Random &rng)
 {
-    size_t addr = pick_random_index(buflen);
-    buf[addr] = static_cast<Char>(random());
+    size_t addr = pick_random_index(buflen, rng);
+    buf[addr] = static_cast<Char>(rng.Next());
+    return {addr, addr + 1};
 }
 
 template<typename Char>
-inline void arith_random_char(Char *buf, size_t buflen)
+inline struct mutated_range arith_random_char(Char *buf, size_t buflen, Random &rng)
 {
-    size_t addr = pick_random_index(buflen);
-    int8_t to_add = static_cast<int8_t>(static_cast<uint8_t>(random())) & 0xf - 8;
+    size_t addr = pick_random_index(buflen, rng);
+    int8_t to_add = static_cast<int8_t>(static_cast<uint8_t>(rng.Next())) & 0xf - 8;
     if (to_add == 0)
     {
         to_add = 8;
     }
 
     buf[addr] += to_add;
+    return {addr, addr + 1};
 }
 
 template<typename Char>
-inline void swap_random_char(Char *buf, size_t buflen)
+inline struct mutated_range swap_random_char(Char *buf, size_t buflen, Random &rng)
 {
-    size_t src = static_cast<size_t>(random()) % buflen;
+    size_t src = rng.Below(buflen);
     size_t dst;
     do
     {
-        dst = static_cast<size_t>(random()) % buflen;
+        dst = rng.Below(buflen);
     } while (dst == src);
 
     Char tmp = buf[src];
     buf[src] = buf[dst];
-    buf[dst] = buf[src];
+    buf[dst] = tmp;
+
+    return {std::min(src, dst), std::max(src, dst) + 1};
 }
 
 template<typename Char>
-inline void bit_flip(Char *buf, size_t buflen)
+inline struct mutated_range bit_flip(Char *buf, size_t buflen, Random &rng)
 {
-    size_t addr = pick_random_index(buflen);
-    Char bit = static_cast<uint8_t>(random()) % (sizeof(Char) * 8);
+    size_t addr = pick_random_index(buflen, rng);
+    Char bit = static_cast<uint8_t>(rng.Next()) % (sizeof(Char) * 8);
     buf[addr] ^= static_cast<size_t>(1) << bit;
+    return {addr, addr + 1};
 }
 
 template<typename Char>
-inline void crossover(Char *buf, size_t buflen, const Char * const &coparent)
+inline struct mutated_range crossover(Char *buf, size_t buflen, const Char * const &coparent, Random &rng)
 {
-    size_t src = static_cast<size_t>(random()) % buflen;
+    size_t src = rng.Below(buflen);
     // end is exclusive
-    size_t end = static_cast<size_t>(random()) % buflen;
+    size_t end = rng.Below(buflen);
 
     // if src & end are out-of-order then swap them into order
     if (src > end)
@@ -108,40 +114,43 @@ inline void crossover(Char *buf, size_t buflen, const Char * const &coparent)
     // make end exclusive (so end can be `buflen` at most)
     end++;
 
-    for (size_t i = src; i < buflen && i < end; i++)
+    end = std::min(end, buflen);
+    for (size_t i = src; i < end; i++)
     {
         buf[i] = coparent[i];
     }
+    return {src, end};
 }
 
 template<typename Char>
-inline void duplicate_subsequence(Char *buf, size_t buflen)
+inline struct mutated_range duplicate_subsequence(Char *buf, size_t buflen, Random &rng)
 {
     if (buflen == 1)
     {
         // nothing to do
-        return;
+        return {0, 0};
     }
 
     // to avoid selecting the whole thing, ensure the substring
     // length is in the inclusive range [1, buflen-1]
-    size_t substr_len = static_cast<size_t>(random()) % (buflen - 1) + 1;
+    size_t substr_len = rng.Below(buflen - 1) + 1;
 
     // now, select where the substring should start (any index from 0 to
     // buflen - substr_len)
-    size_t src = static_cast<size_t>(random()) % ((buflen - substr_len) + 1);
+    size_t src = rng.Below((buflen - substr_len) + 1);
 
     // select a destination index which isn't src
     size_t dst;
     do
     {
-        dst = static_cast<size_t>(random()) % ((buflen - substr_len) + 1);
+        dst = rng.Below((buflen - substr_len) + 1);
     } while (src == dst);
 
     Char *tmp = new Char[substr_len * sizeof(Char)];
     memcpy(tmp, buf + src, substr_len * sizeof(Char));
     memcpy(buf + dst, tmp, substr_len * sizeof(Char));
     delete[] tmp;
+    return {dst, dst + substr_len};
 }
 
 
@@ -158,10 +167,11 @@ inline void get_interesting_arr(const uint16_t *&ptr, size_t &len)
 }
 
 template<typename Char>
-inline void replace_with_special(
+inline struct mutated_range replace_with_special(
     Char *buf,
     size_t buflen,
-    std::vector<Char> &extra_interesting)
+    std::vector<Char> &extra_interesting,
+    Random &rng)
 {
     // Procedure for character selection:
     // 1. Choose whether to use built-in special chars set (p = 50%)
@@ -169,7 +179,7 @@ inline void replace_with_special(
     //    chars exist, use built-in chars.
     // 2. Choose, with equal probability, a character from the set.
 
-    bool use_builtin = extra_interesting.size() == 0 || ((random() & 0x1) == 1);
+    bool use_builtin = extra_interesting.size() == 0 || ((rng.Next() & 0x1) == 1);
 
     Char c;
 
@@ -179,26 +189,27 @@ inline void replace_with_special(
         size_t num_builtin_interesting;
         get_interesting_arr(interesting_arr, num_builtin_interesting);
 
-        size_t chosen_idx = static_cast<size_t>(random()) % num_builtin_interesting;
+        size_t chosen_idx = rng.Below(num_builtin_interesting);
         c = interesting_arr[chosen_idx];
     }
     else
     {
-        size_t chosen_idx = static_cast<size_t>(random()) % extra_interesting.size();
+        size_t chosen_idx = rng.Below(extra_interesting.size());
         c = extra_interesting[chosen_idx];
     }
 
-    size_t addr = pick_random_index(buflen);
+    size_t addr = pick_random_index(buflen, rng);
     buf[addr] = c;
+    return {addr, addr + 1};
 }
 
 
 template<typename Char>
-inline void rotate_once(Char *buf, size_t buflen)
+inline struct mutated_range rotate_once(Char *buf, size_t buflen, Random &rng)
 {
     // when = +1, rotates left
     // when = -1, rotates right
-    int32_t direction = ((static_cast<int32_t>(random() & 0x1)) * 2) - 1;
+    int32_t direction = ((static_cast<int32_t>(rng.Next() & 0x1)) * 2) - 1;
 
     // which end of the buffer to start on?
     // when rotating left,  0
@@ -216,10 +227,11 @@ inline void rotate_once(Char *buf, size_t buflen)
 
     // restore the end char (now on the opposite side)
     buf[curr] = tmp;
+    return {0, buflen};
 }
 
 template<typename Char>
-void take_a_suggestion(
+struct mutated_range take_a_suggestion(
     Char *buf,
     size_t buflen,
     struct suggestion &suggestion)
@@ -227,29 +239,31 @@ void take_a_suggestion(
     if (suggestion.pos >= 0 && suggestion.pos < buflen)
     {
         buf[suggestion.pos] = static_cast<Char>(suggestion.c);
+        return {static_cast<size_t>(suggestion.pos), static_cast<size_t>(suggestion.pos) + 1};
     }
+    return {0, 0};
 }
 
 
-template void mutate_random_char(uint8_t *buf, size_t buflen);
-template void arith_random_char(uint8_t *buf, size_t buflen);
-template void swap_random_char(uint8_t *buf, size_t buflen);
-template void bit_flip(uint8_t *buf, size_t buflen);
-template void crossover(uint8_t *buf, size_t buflen, const uint8_t * const &coparent);
-template void duplicate_subsequence(uint8_t *buf, size_t buflen);
-template void replace_with_special(uint8_t *buf, size_t buflen, std::vector<uint8_t> &extra_interesting);
-template void rotate_once(uint8_t *buf, size_t buflen);
-template void take_a_suggestion(uint8_t *buf, size_t buflen, struct suggestion &suggestion);
-
-template void mutate_random_char(uint16_t *buf, size_t buflen);
-template void arith_random_char(uint16_t *buf, size_t buflen);
-template void swap_random_char(uint16_t *buf, size_t buflen);
-template void bit_flip(uint16_t *buf, size_t buflen);
-template void crossover(uint16_t *buf, size_t buflen, const uint16_t * const &coparent);
-template void duplicate_subsequence(uint16_t *buf, size_t buflen);
-template void replace_with_special(uint16_t *buf, size_t buflen, std::vector<uint16_t> &extra_interesting);
-template void rotate_once(uint16_t *buf, size_t buflen);
-template void take_a_suggestion(uint16_t *buf, size_t buflen, struct suggestion &suggestion);
+template struct mutated_range mutate_random_char(uint8_t *buf, size_t buflen, Random &rng);
+template struct mutated_range arith_random_char(uint8_t *buf, size_t buflen, Random &rng);
+template struct mutated_range swap_random_char(uint8_t *buf, size_t buflen, Random &rng);
+template struct mutated_range bit_flip(uint8_t *buf, size_t buflen, Random &rng);
+template struct mutated_range crossover(uint8_t *buf, size_t buflen, const uint8_t * const &coparent, Random &rng);
+template struct mutated_range duplicate_subsequence(uint8_t *buf, size_t buflen, Random &rng);
+template struct mutated_range replace_with_special(uint8_t *buf, size_t buflen, std::vector<uint8_t> &extra_interesting, Random &rng);
+template struct mutated_range rotate_once(uint8_t *buf, size_t buflen, Random &rng);
+template struct mutated_range take_a_suggestion(uint8_t *buf, size_t buflen, struct suggestion &suggestion);
+
+template struct mutated_range mutate_random_char(uint16_t *buf, size_t buflen, Random &rng);
+template struct mutated_range arith_random_char(uint16_t *buf, size_t buflen, Random &rng);
+template struct mutated_range swap_random_char(uint16_t *buf, size_t buflen, Random &rng);
+template struct mutated_range bit_flip(uint16_t *buf, size_t buflen, Random &rng);
+template struct mutated_range crossover(uint16_t *buf, size_t buflen, const uint16_t * const &coparent, Random &rng);
+template struct mutated_range duplicate_subsequence(uint16_t *buf, size_t buflen, Random &rng);
+template struct mutated_range replace_with_special(uint16_t *buf, size_t buflen, std::vector<uint16_t> &extra_interesting, Random &rng);
+template struct mutated_range rotate_once(uint16_t *buf, size_t buflen, Random &rng);
+template struct mutated_range take_a_suggestion(uint16_t *buf, size_t buflen, struct suggestion &suggestion);
 
 }
 }
@@ -5,6 +5,10 @@
 // Very simple bytestring mutator for fuzzing fixed-length
 // inputs.
 //
+// Every mutator draws its randomness from the given Random,
+// so that each campaign's mutations are reproducible, and
+// returns the range of positions it touched.
+//
 
 #pragma once
 
@@ -14,59 +18,70 @@
 
 #include "corpus.hpp"
 #include "coverage-tracker.hpp"
+#include "random.hpp"
 
 namespace regulator
 {
 namespace fuzz
 {
 
+/**
+ * The positions [begin, end) which a mutation may have changed
+ */
+struct mutated_range
+{
+    size_t begin;
+    size_t end;
+};
+
 /**
  * Select one char and mutate it to some random value
  */
 template<typename Char>
-void mutate_random_char(Char *buf, size_t buflen);
+struct mutated_range mutate_random_char(Char *buf, size_t buflen, Random &rng);
 
 /**
  * Add (or subtract) some value -8 <= v <= 8, v /= 0
  * at a random position.
  */
 template<typename Char>
-void arith_random_char(Char *buf, size_t buflen);
+struct mutated_range arith_random_char(Char *buf, size_t buflen, Random &rng);
 
 /**
  * Swap a char with another one.
  */
 template<typename Char>
-void swap_random_char(Char *buf, size_t buflen);
+struct mutated_range swap_random_char(Char *buf, size_t buflen, Random &rng);
 
 /**
  * Flip one random bit.
  */
 template<typename Char>
-void bit_flip(Char *buf, size_t buflen);
+struct mutated_range bit_flip(Char *buf, size_t buflen, Random &rng);
 
 /**
  * Copy a random substring from coparent into buf
  */
 template<typename Char>
-void crossover(Char *buf, size_t buflen, const Char * const &coparent);
+struct mutated_range crossover(Char *buf, size_t buflen, const Char * const &coparent, Random &rng);
 
 /**
  * Select a substring of `buf` at random and replicate it elsewhere
  * in `buf` (potentially overlapping)
  */
 template<typename Char>
-void duplicate_subsequence(Char *buf, size_t buflen);
+struct mutated_range duplicate_subsequence(Char *buf, size_t buflen, Random &rng);
 
 
 /**
  * Select a random character to replace with a "special" char
  */
 template<typename Char>
-void replace_with_special(
+struct mutated_range replace_with_special(
     Char *buf,
     size_t buflen,
-    std::vector<Char> &extra_interesting
+    std::vector<Char> &extra_interesting,
+    Random &rng
 );
 
 
@@ -74,7 +89,7 @@ void replace_with_special(
  * Make a suggested change from the set.
  */
 template<typename Char>
-void take_a_suggestion(
+struct mutated_range take_a_suggestion(
     Char *buf,
     size_t buflen,
     struct suggestion &suggestion
@@ -85,7 +100,7 @@ void take_a_suggestion(
  * chosen direction (left or right).
  */
 template<typename Char>
-void rotate_once(Char *buf, size_t buflen);
+struct mutated_range rotate_once(Char *buf, size_t buflen, Random &rng);
 
 }
 }
@@ -0,0 +1,101 @@
+#include "path-hash-set.hpp"
+
+
+namespace regulator
+{
+namespace fuzz
+{
+
+PathHashSet::PathHashSet(size_t expected)
+{
+    // stay at most half full
+    size_t capacity = 16;
+    this->shift = 60;
+    while (capacity < expected * 2)
+    {
+        capacity *= 2;
+        this->shift--;
+    }
+    this->slots.assign(capacity, 0);
+    this->n_slotted = 0;
+    this->has_zero = false;
+}
+
+
+bool PathHashSet::InsertOrFind(path_hash_t hash)
+{
+    if (hash == 0)
+    {
+        const bool found = this->has_zero;
+        this->has_zero = true;
+        return found;
+    }
+
+    const size_t mask = this->slots.size() - 1;
+    size_t i = this->Home(hash);
+    while (this->slots[i] != 0)
+    {
+        if (this->slots[i] == hash)
+        {
+            return true;
+        }
+        i = (i + 1) & mask;
+    }
+
+    this->slots[i] = hash;
+    this->n_slotted++;
+    if (this->n_slotted * 2 > this->slots.size())
+    {
+        this->Grow();
+    }
+    return false;
+}
+
+
+bool PathHashSet::Contains(path_hash_t hash) const
+{
+    if (hash == 0)
+    {
+        return this->has_zero;
+    }
+
+    const size_t mask = this->slots.size() - 1;
+    size_t i = this->Home(hash);
+    while (this->slots[i] != 0)
+    {
+        if (this->slots[i] == hash)
+        {
+            return true;
+        }
+        i = (i + 1) & mask;
+    }
+    return false;
+}
+
+
+void PathHashSet::Grow()
+{
+    std::vector<path_hash_t> old;
+    old.swap(this->slots);
+    this->slots.assign(old.size() * 2, 0);
+    this->shift--;
+
+    const size_t mask = this->slots.size() - 1;
+    for (size_t j = 0; j < old.size(); j++)
+    {
+        if (old[j] == 0)
+        {
+            continue;
+        }
+
+        size_t i = this->Home(old[j]);
+        while (this->slots[i] != 0)
+        {
+            i = (i + 1) & mask;
+        }
+        this->slots[i] = old[j];
+    }
+}
+
+}
+}
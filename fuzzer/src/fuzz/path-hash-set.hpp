@@ -0,0 +1,91 @@
+// path-hash-set.hpp
+//
+// A set of path hashes (see path-hash.hpp), used by the corpus
+// to recognize executions which took a path it already has.
+//
+// The hashes sit in one flat, power-of-two sized table probed
+// linearly (open addressing), which doubles once it is half
+// full. The all-zero hash -- the path of an execution which
+// took no branch -- marks empty slots, so whether it is in the
+// set is tracked on the side.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "path-hash.hpp"
+
+namespace regulator
+{
+namespace fuzz
+{
+
+class PathHashSet
+{
+public:
+    /**
+     * Creates an empty set with room for about `expected` hashes
+     * before its first growth
+     */
+    PathHashSet(size_t expected = 64);
+
+    /**
+     * Adds `hash` to the set. Returns true if it was already there.
+     */
+    bool InsertOrFind(path_hash_t hash);
+
+    /**
+     * Returns true if `hash` is in the set
+     */
+    bool Contains(path_hash_t hash) const;
+
+    /**
+     * The number of hashes in the set
+     */
+    inline size_t Size() const
+    {
+        return this->n_slotted + (this->has_zero ? 1 : 0);
+    };
+
+    /**
+     * The number of slots in the table
+     */
+    inline size_t Capacity() const
+    {
+        return this->slots.size();
+    };
+
+private:
+    /**
+     * The slot where probing for `hash` starts
+     */
+    inline size_t Home(path_hash_t hash) const
+    {
+        const uint64_t folded = static_cast<uint64_t>(hash) ^ static_cast<uint64_t>(hash >> 64);
+        return (folded * 0x9E3779B97F4A7C15ull) >> this->shift;
+    };
+
+    /**
+     * Doubles the table, re-inserting every hash
+     */
+    void Grow();
+
+    std::vector<path_hash_t> slots;
+
+    /**
+     * 64 - log2(slots.size())
+     */
+    uint32_t shift;
+
+    /**
+     * The number of non-zero hashes (those held in `slots`)
+     */
+    size_t n_slotted;
+    bool has_zero;
+};
+
+}
+}
@@ -0,0 +1,32 @@
+#include "path-hash.hpp"
+
+extern "C" {
+    #include "murmur3.h"
+}
+
+namespace regulator
+{
+namespace fuzz
+{
+
+struct hash_data
+{
+    path_hash_t prev_hash;
+    uintptr_t src_addr;
+    uintptr_t dst_addr;
+};
+
+
+path_hash_t path_hash_murmur(path_hash_t prev_hash, uintptr_t src_addr, uintptr_t dst_addr)
+{
+    struct hash_data data;
+    data.prev_hash = prev_hash;
+    data.src_addr = src_addr;
+    data.dst_addr = dst_addr;
+    path_hash_t out;
+    MurmurHash3_x64_128(&data, sizeof(data), 0xDEADBEEF /* seed */, &out);
+    return out;
+}
+
+}
+}
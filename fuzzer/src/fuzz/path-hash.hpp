@@ -0,0 +1,87 @@
+// path-hash.hpp
+//
+// Incremental hashes used to fingerprint the path an
+// execution took through the regexp bytecode.
+//
+// CoverageTracker::Cover(src, dst) mixes every branch
+// transition into a running 128-bit path hash. The corpus
+// uses that hash to drop executions which are redundant with
+// an entry it already holds, so the hash must have a very low
+// collision rate -- but it is also computed on every branch
+// the interpreter takes, so it must be cheap.
+//
+// Two strategies are provided:
+//
+//  * path_hash_mulxor -- (default) a 128-bit multiply-xorshift
+//                        rolling hash; a handful of instructions
+//                        per transition.
+//  * path_hash_murmur -- MurmurHash3_x64_128 over the previous
+//                        hash and the transition (the original
+//                        strategy). Select it by building with
+//                        -DREG_PATH_HASH_MURMUR
+//
+
+#pragma once
+
+#include <cstdint>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+typedef __int128_t path_hash_t;
+
+
+/**
+ * Mixes the transition `src_addr` -> `dst_addr` into `prev_hash` using
+ * MurmurHash3_x64_128.
+ */
+path_hash_t path_hash_murmur(path_hash_t prev_hash, uintptr_t src_addr, uintptr_t dst_addr);
+
+
+/**
+ * An odd 128-bit multiplier (the 64-bit golden ratio in the high half,
+ * a splitmix64 constant in the low half)
+ */
+constexpr __uint128_t PATH_HASH_MULTIPLIER =
+    (static_cast<__uint128_t>(0x9E3779B97F4A7C15ull) << 64) | 0xBF58476D1CE4E5B9ull;
+
+
+/**
+ * Added after the first multiply so that the all-zero state does not map
+ * onto itself (otherwise a path of `0 -> 0` transitions would hash to 0
+ * no matter how long it is)
+ */
+constexpr uint64_t PATH_HASH_INCREMENT = 0x2545F4914F6CDD1Dull;
+
+
+/**
+ * Mixes the transition `src_addr` -> `dst_addr` into `prev_hash` using a
+ * 128-bit multiply-xorshift step.
+ *
+ * The transition is folded into both halves of the state, then multiplied
+ * by an odd constant (which carries low bits upward) and xor-shifted (which
+ * carries high bits back down). For a fixed transition each step is a
+ * bijection on the state, so two paths can only collide by chance.
+ */
+inline path_hash_t path_hash_mulxor(path_hash_t prev_hash, uintptr_t src_addr, uintptr_t dst_addr)
+{
+    __uint128_t x = static_cast<__uint128_t>(prev_hash);
+    x ^= (static_cast<__uint128_t>(dst_addr) << 64) | src_addr;
+    x = x * PATH_HASH_MULTIPLIER + PATH_HASH_INCREMENT;
+    x ^= x >> 64;
+    x *= PATH_HASH_MULTIPLIER;
+    x ^= x >> 67;
+    return static_cast<path_hash_t>(x);
+}
+
+
+#if defined REG_PATH_HASH_MURMUR
+#define REGULATOR_FUZZ_PATH_HASH(prev, src, dst) regulator::fuzz::path_hash_murmur(prev, src, dst)
+#else
+#define REGULATOR_FUZZ_PATH_HASH(prev, src, dst) regulator::fuzz::path_hash_mulxor(prev, src, dst)
+#endif
+
+}
+}
@@ -0,0 +1,88 @@
+// random.hpp
+//
+// A small, fast pseudo-random number generator for the
+// fuzzer's mutation and scheduling decisions.
+//
+// glibc's random() serializes every call on a global lock,
+// which worker threads contend on for every mutation. Each
+// fuzz campaign instead owns one of these generators
+// (xoshiro256**, seeded via splitmix64), so drawing a number
+// is lock-free, and a campaign's decisions are reproducible
+// from its seed regardless of how many threads are running.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+/**
+ * xoshiro256** pseudo-random number generator. Not thread-safe; give each
+ * thread (or campaign) its own.
+ */
+class Random
+{
+public:
+    Random(uint64_t seed = 0)
+    {
+        this->Seed(seed);
+    };
+
+    /**
+     * Resets the generator state from `seed`
+     */
+    inline void Seed(uint64_t seed)
+    {
+        // splitmix64, as recommended for seeding xoshiro
+        for (size_t i = 0; i < 4; i++)
+        {
+            seed += 0x9E3779B97F4A7C15ull;
+            uint64_t z = seed;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            this->s[i] = z ^ (z >> 31);
+        }
+    };
+
+    /**
+     * Gets the next 64 random bits
+     */
+    inline uint64_t Next()
+    {
+        const uint64_t ret = rotl(this->s[1] * 5, 7) * 9;
+        const uint64_t t = this->s[1] << 17;
+
+        this->s[2] ^= this->s[0];
+        this->s[3] ^= this->s[1];
+        this->s[1] ^= this->s[2];
+        this->s[0] ^= this->s[3];
+        this->s[2] ^= t;
+        this->s[3] = rotl(this->s[3], 45);
+
+        return ret;
+    };
+
+    /**
+     * Gets a random number in [0, exclusive_max)
+     */
+    inline size_t Below(size_t exclusive_max)
+    {
+        return static_cast<size_t>(this->Next() % exclusive_max);
+    };
+
+private:
+    static inline uint64_t rotl(uint64_t x, int k)
+    {
+        return (x << k) | (x >> (64 - k));
+    };
+
+    uint64_t s[4];
+};
+
+}
+}
@@ -0,0 +1,62 @@
+#include "slab-pool.hpp"
+
+#include <algorithm>
+
+
+namespace regulator
+{
+namespace fuzz
+{
+
+SlabPool::SlabPool(size_t block_size, size_t blocks_per_slab)
+{
+    // every block must be able to hold a free-list link, and keep the
+    // next block aligned
+    const size_t align = alignof(std::max_align_t);
+    block_size = std::max(block_size, sizeof(struct free_block));
+    this->block_size = (block_size + align - 1) / align * align;
+    this->blocks_per_slab = std::max(blocks_per_slab, static_cast<size_t>(1));
+    this->fresh = nullptr;
+    this->n_fresh = 0;
+    this->free_list = nullptr;
+    this->n_live = 0;
+}
+
+
+void *SlabPool::Allocate()
+{
+    this->n_live++;
+
+    if (this->free_list != nullptr)
+    {
+        struct free_block *ret = this->free_list;
+        this->free_list = ret->next;
+        return ret;
+    }
+
+    if (this->n_fresh == 0)
+    {
+        const size_t slab_bytes = this->block_size * this->blocks_per_slab;
+        const size_t slab_units = (slab_bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+        this->slabs.emplace_back(new std::max_align_t[slab_units]);
+        this->fresh = reinterpret_cast<uint8_t *>(this->slabs.back().get());
+        this->n_fresh = this->blocks_per_slab;
+    }
+
+    void *ret = this->fresh;
+    this->fresh += this->block_size;
+    this->n_fresh--;
+    return ret;
+}
+
+
+void SlabPool::Free(void *block)
+{
+    struct free_block *freed = static_cast<struct free_block *>(block);
+    freed->next = this->free_list;
+    this->free_list = freed;
+    this->n_live--;
+}
+
+}
+}
@@ -0,0 +1,90 @@
+// slab-pool.hpp
+//
+// A pool of fixed-size memory blocks carved out of large
+// slabs.
+//
+// Freed blocks go on a free list and are handed out again
+// before any new slab is allocated; slabs themselves are
+// only released when the pool is destroyed. Objects which
+// live and die with one owner (eg, corpus entries with their
+// corpus) thus cost no malloc/free after warm-up, and sit
+// next to each other in memory.
+//
+// Not thread-safe.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+class SlabPool
+{
+public:
+    /**
+     * Creates a pool of blocks of (at least) `block_size` bytes, allocated
+     * `blocks_per_slab` at a time. Blocks are aligned like malloc's.
+     */
+    SlabPool(size_t block_size, size_t blocks_per_slab = 64);
+
+    /**
+     * Gets an uninitialized block
+     */
+    void *Allocate();
+
+    /**
+     * Returns a block obtained from Allocate()
+     */
+    void Free(void *block);
+
+    inline size_t BlockSize() const
+    {
+        return this->block_size;
+    };
+
+    /**
+     * The number of blocks allocated and not yet freed
+     */
+    inline size_t Live() const
+    {
+        return this->n_live;
+    };
+
+    /**
+     * The number of slabs allocated so far
+     */
+    inline size_t Slabs() const
+    {
+        return this->slabs.size();
+    };
+
+private:
+    struct free_block
+    {
+        struct free_block *next;
+    };
+
+    size_t block_size;
+    size_t blocks_per_slab;
+    std::vector<std::unique_ptr<std::max_align_t[]>> slabs;
+
+    /**
+     * The next never-used block of the newest slab, and how many of
+     * those remain
+     */
+    uint8_t *fresh;
+    size_t n_fresh;
+
+    struct free_block *free_list;
+    size_t n_live;
+};
+
+}
+}
@@ -0,0 +1,87 @@
+#include "slice-allocator.hpp"
+
+#include <algorithm>
+
+
+namespace regulator
+{
+namespace fuzz
+{
+
+SliceAllocator::SliceAllocator(
+    size_t n_campaigns,
+    std::chrono::steady_clock::duration base_slice,
+    std::chrono::steady_clock::duration min_slice,
+    std::chrono::steady_clock::duration max_slice,
+    double min_share,
+    double decay)
+    : n_campaigns(n_campaigns),
+      base_slice(base_slice),
+      min_slice(min_slice),
+      max_slice(max_slice),
+      min_share(min_share),
+      decay(decay),
+      rates(new std::atomic<double>[n_campaigns])
+{
+    for (size_t i = 0; i < n_campaigns; i++)
+    {
+        this->rates[i] = -1;
+    }
+}
+
+
+std::chrono::steady_clock::duration SliceAllocator::SliceLength(size_t campaign) const
+{
+    double my_rate = this->Rate(campaign);
+    if (my_rate < 0)
+    {
+        // nothing known yet
+        return this->base_slice;
+    }
+
+    double sum = 0;
+    size_t n_measured = 0;
+    for (size_t i = 0; i < this->n_campaigns; i++)
+    {
+        double rate = this->Rate(i);
+        if (rate >= 0)
+        {
+            sum += rate;
+            n_measured++;
+        }
+    }
+
+    double mean = sum / n_measured;
+    if (mean <= 0)
+    {
+        // nobody is progressing, so nobody deserves more than anyone else
+        return this->base_slice;
+    }
+
+    double scale = std::max(this->min_share, my_rate / mean);
+    auto ret = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        this->base_slice * scale
+    );
+    return std::min(this->max_slice, std::max(this->min_slice, ret));
+}
+
+
+void SliceAllocator::Report(size_t campaign, double reward, std::chrono::steady_clock::duration spent)
+{
+    double seconds = std::chrono::duration<double>(spent).count();
+    if (seconds <= 0)
+    {
+        return;
+    }
+
+    double rate = reward / seconds;
+    double prev = this->Rate(campaign);
+    double next = prev < 0
+        ? rate
+        : (1 - this->decay) * prev + this->decay * rate;
+
+    this->rates[campaign].store(next, std::memory_order_relaxed);
+}
+
+}
+}
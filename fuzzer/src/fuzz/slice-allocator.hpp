@@ -0,0 +1,102 @@
+// slice-allocator.hpp
+//
+// Decides how long each fuzz campaign may run before it
+// yields its worker thread.
+//
+// Campaigns take turns on the worker threads. If every turn
+// were the same length, a short-string campaign which
+// saturated long ago would get as much CPU as a long-string
+// campaign still finding new maxima. Instead, each campaign
+// reports the progress it made in each slice (new corpus
+// entries, new slowest inputs), and the allocator keeps an
+// exponential moving average of that progress per second.
+// A campaign's next slice is the base slice scaled by its
+// rate relative to the mean rate, clamped to [min, max]. A
+// campaign making no progress still gets `min_share` of the
+// base slice, so it keeps a chance to find something.
+//
+// Reports and lookups for different campaigns may come from
+// different threads concurrently.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+/**
+ * Progress reward for each new corpus entry
+ */
+const double SLICE_REWARD_NEW_ENTRY = 1.0;
+
+/**
+ * Progress reward for finding a new slowest input
+ */
+const double SLICE_REWARD_NEW_MAXIMUM = 10.0;
+
+
+class SliceAllocator
+{
+public:
+    /**
+     * Creates an allocator for `n_campaigns` campaigns, numbered from 0
+     *
+     * `base_slice` is the slice given to a campaign progressing at the
+     * mean rate (or before anything is known), `min_slice` and `max_slice`
+     * bound every slice, `min_share` is the fraction of the base slice a
+     * campaign without progress still gets, and `decay` is the weight of
+     * the latest slice in the moving average.
+     */
+    SliceAllocator(
+        size_t n_campaigns,
+        std::chrono::steady_clock::duration base_slice = std::chrono::milliseconds(100),
+        std::chrono::steady_clock::duration min_slice = std::chrono::milliseconds(10),
+        std::chrono::steady_clock::duration max_slice = std::chrono::milliseconds(400),
+        double min_share = 0.25,
+        double decay = 0.3);
+
+    /**
+     * The length of the next slice for `campaign`
+     */
+    std::chrono::steady_clock::duration SliceLength(size_t campaign) const;
+
+    /**
+     * Records that `campaign` earned `reward` over a slice of `spent`
+     * work-time. Only one thread may report for a campaign at a time.
+     */
+    void Report(size_t campaign, double reward, std::chrono::steady_clock::duration spent);
+
+    /**
+     * The moving average of `campaign`'s reward per second, or a
+     * negative number when it has not reported yet
+     */
+    inline double Rate(size_t campaign) const
+    {
+        return this->rates[campaign].load(std::memory_order_relaxed);
+    };
+
+    inline size_t Size() const
+    {
+        return this->n_campaigns;
+    };
+
+private:
+    size_t n_campaigns;
+    std::chrono::steady_clock::duration base_slice;
+    std::chrono::steady_clock::duration min_slice;
+    std::chrono::steady_clock::duration max_slice;
+    double min_share;
+    double decay;
+
+    std::unique_ptr<std::atomic<double>[]> rates;
+};
+
+}
+}
@@ -0,0 +1,111 @@
+#include "watchdog.hpp"
+
+
+namespace regulator
+{
+namespace fuzz
+{
+
+Watchdog::Slot::Slot(std::function<void()> on_expire)
+{
+    this->on_expire = on_expire;
+    this->deadline.store(0);
+    this->state.store(kIdle);
+}
+
+
+void Watchdog::Slot::Arm(std::chrono::steady_clock::time_point deadline)
+{
+    // only the owning thread changes an idle slot, so no one races us here
+    const uint64_t arming = (this->state.load(std::memory_order_relaxed) & ~kPhaseMask) + kPhaseMask + 1;
+    this->deadline.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+    this->state.store(arming | kArmed, std::memory_order_release);
+}
+
+
+bool Watchdog::Slot::Disarm()
+{
+    uint64_t state = this->state.load(std::memory_order_relaxed);
+    if ((state & kPhaseMask) == kArmed &&
+        this->state.compare_exchange_strong(state, state & ~kPhaseMask, std::memory_order_acq_rel))
+    {
+        return false;
+    }
+
+    // the watchdog thread got here first; let it finish firing
+    while ((state & kPhaseMask) == kFiring)
+    {
+        std::this_thread::yield();
+        state = this->state.load(std::memory_order_acquire);
+    }
+    this->state.store(state & ~kPhaseMask, std::memory_order_relaxed);
+    return (state & kPhaseMask) == kFired;
+}
+
+
+void Watchdog::Slot::Check(std::chrono::steady_clock::time_point now)
+{
+    uint64_t state = this->state.load(std::memory_order_acquire);
+    if ((state & kPhaseMask) != kArmed ||
+        now.time_since_epoch().count() < this->deadline.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    // claim this arming, so that an execution can not finish (Disarm)
+    // between our decision to fire and the firing
+    const uint64_t arming = state & ~kPhaseMask;
+    if (this->state.compare_exchange_strong(state, arming | kFiring, std::memory_order_acq_rel))
+    {
+        this->on_expire();
+        this->state.store(arming | kFired, std::memory_order_release);
+    }
+}
+
+
+Watchdog::Watchdog(std::chrono::steady_clock::duration poll_period)
+{
+    this->poll_period = poll_period;
+    this->stopping = false;
+    this->thread = std::thread(&Watchdog::Main, this);
+}
+
+
+Watchdog::~Watchdog()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->stop_requested.notify_all();
+    this->thread.join();
+}
+
+
+Watchdog::Slot *Watchdog::Register(std::function<void()> on_expire)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->slots.emplace_back(new Slot(on_expire));
+    return this->slots.back().get();
+}
+
+
+void Watchdog::Main()
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while (!this->stopping)
+    {
+        const auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < this->slots.size(); i++)
+        {
+            this->slots[i]->Check(now);
+        }
+
+        this->stop_requested.wait_for(lock, this->poll_period, [this] {
+            return this->stopping;
+        });
+    }
+}
+
+}
+}
@@ -0,0 +1,106 @@
+// watchdog.hpp
+//
+// A wall-clock watchdog for individual regexp executions.
+//
+// Each executing thread owns a Slot. Before an execution the
+// thread Arm()s its slot with a deadline, and afterwards it
+// Disarm()s it, neither of which takes a lock. A background
+// thread polls the armed slots and calls a slot's `on_expire`
+// callback (once per arming) when its deadline passes -- for
+// V8 that requests termination of the isolate, which the
+// interpreter notices the next time it services interrupts.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+class Watchdog
+{
+public:
+    class Slot
+    {
+    public:
+        Slot(std::function<void()> on_expire);
+
+        /**
+         * Starts watching until `deadline`
+         */
+        void Arm(std::chrono::steady_clock::time_point deadline);
+
+        /**
+         * Stops watching. Returns true if the deadline passed (and
+         * on_expire was called) since the last Arm(); waits for an
+         * on_expire call in progress, so none happens after this returns.
+         */
+        bool Disarm();
+
+    private:
+        friend class Watchdog;
+
+        /**
+         * Phases of `state`, in its low bits; the rest counts armings,
+         * so that the watchdog thread can not fire an arming which
+         * ended (and was followed by another) since it looked
+         */
+        enum Phase : uint64_t {
+            kIdle = 0,
+            kArmed = 1,
+            kFiring = 2,
+            kFired = 3,
+        };
+        static constexpr uint64_t kPhaseMask = 3;
+
+        /**
+         * Calls on_expire if armed and past the deadline
+         */
+        void Check(std::chrono::steady_clock::time_point now);
+
+        std::function<void()> on_expire;
+        std::atomic<std::chrono::steady_clock::rep> deadline;
+        std::atomic<uint64_t> state;
+    };
+
+    /**
+     * Starts the watchdog thread, which checks every slot once per
+     * `poll_period`
+     */
+    Watchdog(std::chrono::steady_clock::duration poll_period);
+
+    /**
+     * Stops and joins the watchdog thread. Slots must no longer be used.
+     */
+    ~Watchdog();
+
+    /**
+     * Creates a slot, owned by the watchdog, whose expiry calls `on_expire`
+     * (from the watchdog thread)
+     */
+    Slot *Register(std::function<void()> on_expire);
+
+private:
+    void Main();
+
+    std::chrono::steady_clock::duration poll_period;
+    std::mutex mutex;
+    std::condition_variable stop_requested;
+    bool stopping;
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::thread thread;
+};
+
+}
+}
@@ -1,6 +1,7 @@
 #include "work-queue.hpp"
 #include "../flags.hpp"
 
+#include <algorithm>
 #include <vector>
 #include <random>
 #include <iostream>
@@ -40,18 +41,16 @@ CorpusEntry<Char> *Queue<Char>::Pop()
 template<typename Char>
 void Queue<Char>::Fill(Corpus<Char> &corpus)
 {
-    // TODO this could be faster
-
     // Strategy:
     // 1. Create an array with all valid entry indices [0, 1, ... corpus.size() - 1]
     // 2. Shuffle the array
-    // 3. Iterate over the array -- if entry at that index maximizes an edge
-    //    which does not yet have a representative, then assign a representative
-    // 4. Otherwise, with low probability, add the entry to the queue immediately.
-
-    // A bitmap indicating which edges have already been assigned a representative
-    uint8_t represented[MAP_SIZE];
-    memset(represented, 0, MAP_SIZE);
+    // 3. For each covered edge, the maximizing entry which comes first in the
+    //    shuffled array becomes that edge's representative
+    // 4. Walk the array -- representatives are added to the queue, anything
+    //    else is added with low probability (lower still if it is stale)
+    //
+    // Steps 3-4 only visit the corpus' maximizer index, so this costs
+    // O(corpus + sum of maximizer set sizes) rather than a map sweep per entry.
 
     // Step 1: create map from array index to entry index
     size_t index_map_len = corpus.Size();
@@ -64,74 +63,76 @@ void Queue<Char>::Fill(Corpus<Char> &corpus)
     // Step 2: shuffle the index map (Fisher-Yates Shuffle)
     for (size_t i=0; i + 2 <= index_map_len; i++)
     {
-        size_t j = (static_cast<size_t>(random()) % (index_map_len - i)) + i;
+        size_t j = corpus.GetRandom().Below(index_map_len - i) + i;
         size_t tmp = index_map[i];
         index_map[i] = index_map[j];
         index_map[j] = tmp;
     }
 
-    // Step 3: iterate over index map
-    for (size_t i=0; i < index_map_len; i++)
+    // the position of each entry in the shuffled array
+    std::vector<uint32_t> rank(index_map_len);
+    for (size_t i = 0; i < index_map_len; i++)
     {
-        size_t corpus_entry_index = index_map[i];
+        rank[index_map[i]] = static_cast<uint32_t>(i);
+    }
 
-        CorpusEntry<Char> *entry = corpus.Get(corpus_entry_index);
-        bool already_selected = false;
+    // Step 3: assign representatives, and gather staleness stats on the way
+    std::vector<bool> selected(index_map_len, false);
+    std::vector<uint32_t> my_min_staleness(index_map_len, UINT32_MAX);
+    uint32_t global_min_staleness = UINT32_MAX;
+    uint32_t global_max_staleness = 0;
 
-        // iterate over each component in the perfmap to see if this entry
-        // maximizes any components
-        for (size_t j=0; j < MAP_SIZE && !already_selected; j++)
-        {
-            size_t rep_idx = j / 8;
-            uint8_t rep_mask = static_cast<uint8_t>(1) << (j % 8);
+    const std::vector<uint32_t> &covered_edges = corpus.CoveredEdges();
+    for (size_t i = 0; i < covered_edges.size(); i++)
+    {
+        const std::vector<uint32_t> &maximizers = corpus.Maximizers(covered_edges[i]);
+        const uint32_t staleness = corpus.GetStaleness(covered_edges[i]);
+        global_min_staleness = std::min(global_min_staleness, staleness);
+        global_max_staleness = std::max(global_max_staleness, staleness);
 
-            if ((represented[rep_idx] & rep_mask) == 0)
+        uint32_t representative = maximizers[0];
+        for (size_t j = 0; j < maximizers.size(); j++)
+        {
+            if (rank[maximizers[j]] < rank[representative])
             {
-                // this component is not represented, query to determine if
-                // the entry is maximizing
-                if (corpus.MaximizesEdge(entry->GetCoverageTracker(), j))
-                {
-                    // entry is maximizing, select it as a representative
-                    this->queue.push_back(entry);
-                    represented[rep_idx] |= rep_mask;
-                    already_selected = true;
-
-                    // mark all other components that this maximizes as represented
-                    for (size_t k=j; k < MAP_SIZE; k++)
-                    {
-                        if (corpus.MaximizesEdge(entry->GetCoverageTracker(), k))
-                        {
-                            size_t rep_idx_second = k / 8;
-                            uint8_t rep_mask_second = static_cast<uint8_t>(1) << (k % 8);
-                            represented[rep_idx_second] |= rep_mask_second;
-                        }
-                    }
-                }
+                representative = maximizers[j];
             }
+            my_min_staleness[maximizers[j]] = std::min(my_min_staleness[maximizers[j]], staleness);
         }
+        selected[representative] = true;
+    }
+
+    // Corpus::MaximizesEdge() holds for every entry on an uncovered edge
+    // (0 == 0), so those edges are represented by the first entry
+    if (index_map_len > 0 && covered_edges.size() < corpus.MapSize())
+    {
+        selected[index_map[0]] = true;
+    }
+
+    // Step 4: iterate over index map
+    for (size_t i=0; i < index_map_len; i++)
+    {
+        size_t corpus_entry_index = index_map[i];
+        CorpusEntry<Char> *entry = corpus.Get(corpus_entry_index);
 
-        if (!already_selected)
+        if (selected[corpus_entry_index])
+        {
+            this->queue.push_back(entry);
+        }
+        else
         {
-            uint32_t staleness_score = corpus.GetStalenessScore(entry->GetCoverageTracker());
+            uint32_t score = staleness_score(
+                my_min_staleness[corpus_entry_index],
+                global_min_staleness,
+                global_max_staleness
+            );
 
-            if ((random() % MAX_STALENESS_SCORE) >= std::max(staleness_score, MAX_STALENESS_SCORE - MAX_STALENESS_SCORE / 100))
+            if (corpus.GetRandom().Below(MAX_STALENESS_SCORE) >= std::max(score, MAX_STALENESS_SCORE - MAX_STALENESS_SCORE / 100))
             {
                 // Item was selected
                 this->queue.push_back(entry);
             }
         }
-
-        // // Step 4: entry did not maximize any non-represented edges, with
-        // // low probability (1%) add it to work-queue anyway
-
-        // if (random() & (1024 - 1) <= 9) // (10 winners) / (1024 possible) ~= 1%
-        // {
-        //     // This entry was selected to be a parent
-        //     this->queue.push_back(entry);
-        // }
-
-        entry_loop_out:
-        ;
     }
 
     if (regulator::flags::FLAG_debug)
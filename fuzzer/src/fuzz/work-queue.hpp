@@ -26,7 +26,8 @@ public:
     /**
      * Refills the queue based on the given corpus.
      * 
-     * Makes use of various heuristics, etc.
+     * Makes use of various heuristics, etc. Random choices are drawn
+     * from the corpus' generator.
      * 
      * NOTE: does not take ownership of the corpus or corpus
      * entries
@@ -0,0 +1,136 @@
+// work-stealing-deque.hpp
+//
+// A lock-free Chase-Lev work-stealing deque, used to
+// schedule fuzz campaigns across worker threads.
+//
+// Each worker owns one deque. Only the owner may Push() or
+// Pop(); any thread (including the owner) may Steal() the
+// oldest element. The deque has a fixed capacity, which
+// suffices because the set of campaigns is known up-front.
+//
+// Follows "Correct and Efficient Work-Stealing for Weak
+// Memory Models" (Le, Pop, Cohen, Zappa Nardelli; PPoPP '13).
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+template<typename T>
+class WorkStealingDeque
+{
+public:
+    /**
+     * Creates a deque which can hold at least `capacity` elements
+     */
+    WorkStealingDeque(size_t capacity)
+    {
+        size_t rounded = 1;
+        while (rounded < capacity)
+        {
+            rounded <<= 1;
+        }
+        this->mask = rounded - 1;
+        this->buffer.reset(new std::atomic<T>[rounded]);
+        this->top = 0;
+        this->bottom = 0;
+    };
+
+    /**
+     * Adds `item` at the bottom. Owner only; the deque must not be full.
+     */
+    inline void Push(T item)
+    {
+        const int64_t b = this->bottom.load(std::memory_order_relaxed);
+        this->buffer[b & this->mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+    };
+
+    /**
+     * Takes the newest element. Owner only. Returns false if empty.
+     */
+    inline bool Pop(T &out)
+    {
+        const int64_t b = this->bottom.load(std::memory_order_relaxed) - 1;
+        this->bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = this->top.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // empty
+            this->bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        out = this->buffer[b & this->mask].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            // last element -- race against stealers for it
+            bool won = this->top.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed
+            );
+            this->bottom.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    };
+
+    /**
+     * Takes the oldest element. Any thread. Returns false if empty, or
+     * if another thread took the element first.
+     */
+    inline bool Steal(T &out)
+    {
+        int64_t t = this->top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = this->bottom.load(std::memory_order_acquire);
+
+        if (t >= b)
+        {
+            return false;
+        }
+
+        T item = this->buffer[t & this->mask].load(std::memory_order_relaxed);
+        if (!this->top.compare_exchange_strong(
+                t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return false;
+        }
+        out = item;
+        return true;
+    };
+
+    /**
+     * Approximate number of elements (exact when no other thread is
+     * operating on the deque)
+     */
+    inline size_t Size() const
+    {
+        const int64_t b = this->bottom.load(std::memory_order_relaxed);
+        const int64_t t = this->top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    };
+
+private:
+    std::atomic<int64_t> top;
+
+    // keep the thieves' and the owner's index on separate cache lines
+    char padding[64];
+
+    std::atomic<int64_t> bottom;
+    std::unique_ptr<std::atomic<T>[]> buffer;
+    int64_t mask;
+};
+
+}
+}
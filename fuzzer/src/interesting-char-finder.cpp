@@ -39,10 +39,8 @@ bool ExtractInteresting(
         sizeof(subject) / sizeof(Char),
         exec_result,
         -1,
-#if defined REG_COUNT_PATHLENGTH
-        UINT64_MAX,
-#endif
-        sizeof(Char) == 1 ? e::kOnlyOneByte : e::kOnlyTwoByte
+        sizeof(Char) == 1 ? e::kOnlyOneByte : e::kOnlyTwoByte,
+        regulator::fuzz::kInstrumentNone
     );
 
     if (result != e::kSuccess)
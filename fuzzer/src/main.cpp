@@ -6,9 +6,8 @@
 #include "regexp-executor.hpp"
 #include "fuzz-driver.hpp"
 #include "flags.hpp"
-#if defined REG_COUNT_PATHLENGTH
 #include "count-lengths.hpp"
-#endif
+#include "zygote.hpp"
 
 using namespace std;
 
@@ -17,21 +16,12 @@ namespace f = regulator::flags;
 static const char *MY_ZONE_NAME = "MY_ZONE";
 
 
-int main(int argc, char* argv[])
+/**
+ * Compiles the target regexp and runs the requested job on it
+ */
+static int run_job(regulator::ParsedArguments &args)
 {
-    // Read and store our arguments.
-    regulator::ParsedArguments args = regulator::ParsedArguments::Parse(argc, argv);
-
-    if (f::FLAG_debug)
-    {
-        std::cout << "DEBUG enabled. Beginning fuzz run." << std::endl;
-    }
-
-    // Initialize
     v8::Isolate *isolate = regulator::executor::Initialize();
-    v8::HandleScope scope(isolate);
-    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
-    ctx->Enter();
 
     if (f::FLAG_debug)
     {
@@ -43,17 +33,15 @@ int main(int argc, char* argv[])
     regulator::executor::Result compile_result = regulator::executor::Compile(
         reinterpret_cast<char *>(args.target_regex),
         args.flags.c_str(),
-        &regexp,
-        args.num_threads
+        &regexp
     );
 
     if (compile_result != regulator::executor::kSuccess)
     {
         std::cerr << "Regexp compilation failed" << std::endl;
-        exit(15);
+        return 15;
     }
 
-#if defined REG_COUNT_PATHLENGTH
     if (args.count_paths)
     {
         std::cerr << "Counting maximum path; feed base64 lines now" << std::endl;
@@ -65,9 +53,8 @@ int main(int argc, char* argv[])
         {
             regulator::loop_count_lengths(args, regexp, 1);
         }
-        exit(0);
+        return 0;
     }
-#endif
 
     if (f::FLAG_debug)
     {
@@ -84,8 +71,41 @@ int main(int argc, char* argv[])
         args.max_total,
         args.fuzz_one_byte,
         args.fuzz_two_byte,
-        args.num_threads
+        args.num_threads,
+        args.seed
     );
 
     return 0;
 }
+
+
+int main(int argc, char* argv[])
+{
+    // Read and store our arguments.
+    regulator::ParsedArguments args = regulator::ParsedArguments::Parse(argc, argv);
+
+    if (args.zygote)
+    {
+        // forked children inherit no threads, so V8 must not depend on
+        // any background threads it started before the fork
+        v8::V8::SetFlagsFromString("--single-threaded");
+    }
+
+    if (f::FLAG_debug)
+    {
+        std::cout << "DEBUG enabled. Beginning fuzz run." << std::endl;
+    }
+
+    // Initialize
+    v8::Isolate *isolate = regulator::executor::Initialize();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
+    ctx->Enter();
+
+    if (args.zygote)
+    {
+        return regulator::loop_zygote(std::cin, std::cout, run_job);
+    }
+
+    return run_job(args);
+}
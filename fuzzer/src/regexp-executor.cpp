@@ -1,13 +1,22 @@
 #include "regexp-executor.hpp"
+#include "edge-finder.hpp"
+#include "flags.hpp"
+#include "fuzz/backtrack-arena.hpp"
+#include "fuzz/watchdog.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <string>
 #include <iostream>
 #include <memory>
-#include <mutex>
-#include <thread>
+#include <atomic>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
 
 #include "v8.h"
 #include "src/execution/isolate.h"
+#include "src/handles/global-handles.h"
 #include "src/objects/objects.h"
 #include "src/objects/js-regexp.h"
 #include "src/objects/js-regexp-inl.h"
@@ -16,6 +25,7 @@
 #include "src/regexp/regexp-interpreter.h"
 #include "src/objects/fixed-array.h"
 #include "src/objects/fixed-array-inl.h"
+#include "src/roots/roots-inl.h"
 #include "include/libplatform/libplatform.h"
 
 namespace regulator
@@ -36,16 +46,19 @@ thread_local v8::Global<v8::Context> context;
  */
 std::string fake_prog_name = "regulator";
 
+static const char *MY_ZONE_NAME = "MY_ZONE";
+
 /**
- * Sentinel value for std::thread::id to represent null
+ * Sets up this thread's execution state (see thread_exec_state)
  */
-static const std::thread::id kNullThreadId;
+static void claim_exec_state();
 
-static const char *MY_ZONE_NAME = "MY_ZONE";
 
 V8RegExp::V8RegExp()
 {
     this->regexp = v8::internal::Handle<v8::internal::JSRegExp>::null();
+    this->isolate = nullptr;
+    this->id = 0;
 }
 
 
@@ -88,6 +101,7 @@ v8::Isolate *Initialize()
             }
 
             i_isolate = reinterpret_cast<v8::internal::Isolate*>(isolate);
+            claim_exec_state();
         }
         return isolate;
     }
@@ -131,12 +145,30 @@ v8::Isolate *Initialize()
     v8::internal::FLAG_regexp_interpret_all = true;
     v8::internal::FLAG_regexp_tier_up = false;
 
+    claim_exec_state();
+
     return isolate;
 }
 
 
-Result Compile(const char *pattern, const char *flags, V8RegExp *out, uint16_t n_threads)
+/**
+ * Compiles `pattern` in this thread's isolate and forces bytecode
+ * generation for both subject widths. Every isolate runs the same
+ * warm-up, so every isolate ends up with identical bytecode.
+ *
+ * Runs in this thread's context, whether or not the caller entered it
+ * (JSRegExp::New and the warm-up read the native context), and swallows
+ * any exception; the caller provides the HandleScope for `out`.
+ */
+static Result compile_in_this_isolate(
+    const char *pattern,
+    const char *flags,
+    v8::internal::Handle<v8::internal::JSRegExp> *out)
 {
+    v8::Local<v8::Context> local_context = v8::Local<v8::Context>::New(isolate, context);
+    v8::Context::Scope context_scope(local_context);
+    v8::TryCatch try_catch(isolate);
+
     v8::internal::MaybeHandle<v8::internal::String> maybe_h_pattern = (
         i_isolate->factory()
                  ->NewStringFromUtf8(
@@ -215,27 +247,94 @@ Result Compile(const char *pattern, const char *flags, V8RegExp *out, uint16_t n
     v8::internal::Handle<v8::internal::RegExpMatchInfo> match_info =
         v8::internal::RegExpMatchInfo::New(i_isolate, capture_count);
 
-    v8::internal::Handle<v8::internal::Object> o2 = v8::internal::RegExp::Exec(
-        i_isolate, h_regexp, subject, 0, match_info).ToHandleChecked();
+    if (v8::internal::RegExp::Exec(i_isolate, h_regexp, subject, 0, match_info).is_null())
+    {
+        return Result::kCouldNotCompile;
+    }
 
     if (h_regexp->TypeTag() != v8::internal::JSRegExp::IRREGEXP)
     {
         return Result::kCouldNotCompile;
     }
 
+    // The warm-up above only compiled the two-byte bytecode, force
+    // the one-byte bytecode as well
+    v8::internal::Handle<v8::internal::String> one_byte_subject = (
+        i_isolate->factory()
+                ->NewStringFromUtf8(
+                    v8::internal::CStrVector("a")
+                )
+    ).ToHandleChecked();
+
+    if (v8::internal::RegExp::Exec(i_isolate, h_regexp, one_byte_subject, 0, match_info).is_null())
+    {
+        return Result::kCouldNotCompile;
+    }
+
+    *out = h_regexp;
+    return Result::kSuccess;
+}
+
+
+/**
+ * Copies out the bytecode of `regexp` for one subject width; empty if
+ * there is none
+ */
+static std::vector<uint8_t> copy_bytecode(
+    v8::internal::Handle<v8::internal::JSRegExp> regexp,
+    bool is_one_byte)
+{
+    v8::internal::Object bytecode = regexp->Bytecode(is_one_byte);
+    if (!bytecode.IsByteArray())
+    {
+        return std::vector<uint8_t>();
+    }
+
+    v8::internal::ByteArray array = v8::internal::ByteArray::cast(bytecode);
+    const uint8_t *start = array.GetDataStartAddress();
+    return std::vector<uint8_t>(start, start + array.length());
+}
+
+
+Result Compile(const char *pattern, const char *flags, V8RegExp *out)
+{
+    v8::internal::Handle<v8::internal::JSRegExp> h_regexp;
+    Result compile_result = compile_in_this_isolate(pattern, flags, &h_regexp);
+    if (compile_result != Result::kSuccess)
+    {
+        return compile_result;
+    }
+
+    static std::atomic<uint64_t> next_id(0);
+
     out->regexp = h_regexp;
+    out->id = next_id++;
+    out->isolate = i_isolate;
+    out->pattern = pattern;
+    out->flags = flags;
+    out->one_byte_bytecode = copy_bytecode(h_regexp, true);
+    out->two_byte_bytecode = copy_bytecode(h_regexp, false);
 
-    // start allocating space for match infos (while, presumably, on main thread ourselves)
-    std::unique_lock<std::mutex> my_lock(out->match_infos_mutex);
-    out->match_infos = nullptr;
-    // note we'll make one extra for the main thread
-    for (size_t i=0; i < n_threads + 1; i++)
+    if (regulator::flags::FLAG_dense_edges)
     {
-        struct ThreadLocalV8RegExpMatchInfo *mi = new struct ThreadLocalV8RegExpMatchInfo;
-        mi->match_info = v8::internal::RegExpMatchInfo::New(i_isolate, capture_count);
-        mi->next = out->match_infos;
-        mi->owning_thread = kNullThreadId;
-        out->match_infos = mi;
+        regulator::fuzz::edge_list_t one_byte_edges;
+        regulator::fuzz::edge_list_t two_byte_edges;
+        size_t one_byte_code_length;
+        size_t two_byte_code_length;
+        if (regulator::fuzz::FindEdges(*out, true, one_byte_edges, one_byte_code_length) &&
+            regulator::fuzz::FindEdges(*out, false, two_byte_edges, two_byte_code_length))
+        {
+            out->edge_index = std::make_unique<regulator::fuzz::EdgeIndex>(
+                one_byte_edges,
+                one_byte_code_length,
+                two_byte_edges,
+                two_byte_code_length
+            );
+        }
+        else
+        {
+            std::cerr << "WARNING: could not index edges, falling back to hashed coverage" << std::endl;
+        }
     }
 
     return Result::kSuccess;
@@ -265,6 +364,465 @@ inline v8::internal::MaybeHandle<v8::internal::String>
 }
 
 
+/**
+ * The V8 external-string resource type for each Char width
+ */
+template<typename Char>
+struct external_resource_traits;
+
+template<>
+struct external_resource_traits<uint8_t>
+{
+    typedef v8::String::ExternalOneByteStringResource resource_t;
+    typedef char data_t;
+};
+
+template<>
+struct external_resource_traits<uint16_t>
+{
+    typedef v8::String::ExternalStringResource resource_t;
+    typedef uint16_t data_t;
+};
+
+
+/**
+ * Backing store of a reusable subject string. The characters live
+ * outside the V8 heap, so a new subject can be written over the old one
+ * without allocating anything.
+ */
+template<typename Char>
+class ReusableSubjectResource : public external_resource_traits<Char>::resource_t
+{
+public:
+    ReusableSubjectResource(size_t length)
+        : buffer(new Char[length]()),
+          buffer_length(length)
+    {};
+
+    const typename external_resource_traits<Char>::data_t *data() const override
+    {
+        return reinterpret_cast<const typename external_resource_traits<Char>::data_t *>(this->buffer.get());
+    };
+
+    size_t length() const override
+    {
+        return this->buffer_length;
+    };
+
+    inline Char *Buffer()
+    {
+        return this->buffer.get();
+    };
+
+private:
+    std::unique_ptr<Char[]> buffer;
+    size_t buffer_length;
+};
+
+
+/**
+ * A long-lived external subject string, kept alive by a global handle.
+ * The string owns (and eventually disposes) `resource`.
+ */
+template<typename Char>
+struct reusable_subject
+{
+    ReusableSubjectResource<Char> *resource;
+    v8::internal::Handle<v8::internal::String> string;
+};
+
+
+/**
+ * Everything a thread needs to execute regexps, claimed once by
+ * Initialize() so that executions reach it without any shared state.
+ * Objects on the V8 heap belong to the thread's own isolate.
+ */
+struct thread_exec_state
+{
+    /**
+     * Last-match info for Exec. Grows (on the heap) as needed, so one
+     * suffices for every regexp.
+     */
+    v8::internal::Handle<v8::internal::RegExpMatchInfo> match_info;
+
+    /**
+     * Interpreter registers for ExecRaw, grown as needed
+     */
+    std::vector<int> registers;
+
+    /**
+     * Backtrack stack storage for ExecRaw, kept at its deepest size
+     */
+    regulator::fuzz::BacktrackArena backtrack;
+
+    /**
+     * Reusable subject strings, by length
+     */
+    std::unordered_map<size_t, struct reusable_subject<uint8_t>> one_byte_subjects;
+    std::unordered_map<size_t, struct reusable_subject<uint16_t>> two_byte_subjects;
+
+    /**
+     * This thread's copy of the parent when executing child edits
+     */
+    std::vector<uint8_t> one_byte_work;
+    std::vector<uint16_t> two_byte_work;
+
+    /**
+     * Results handed out by ScratchResult, by string length
+     */
+    std::unordered_map<uint32_t, std::unique_ptr<V8RegExpResult>> scratch_results;
+
+    /**
+     * This isolate's copies of regexps compiled elsewhere, by V8RegExp::id
+     */
+    std::unordered_map<uint64_t, v8::internal::Handle<v8::internal::JSRegExp>> regexps;
+
+    /**
+     * This thread's slot in `watchdog`, registered on the first
+     * execution it watches; only valid while `watchdog_generation`
+     * matches the running watchdog's (a later watchdog may well be
+     * allocated at the same address)
+     */
+    uint64_t watchdog_generation;
+    regulator::fuzz::Watchdog::Slot *watchdog_slot;
+};
+
+thread_local struct thread_exec_state *exec_state = nullptr;
+
+
+static void claim_exec_state()
+{
+    if (exec_state != nullptr)
+    {
+        return;
+    }
+
+    // intentionally never freed: the isolate it refers to is never disposed
+    exec_state = new struct thread_exec_state;
+    exec_state->watchdog_generation = 0;
+    exec_state->watchdog_slot = nullptr;
+
+    v8::internal::HandleScope handle_scope(i_isolate);
+    v8::internal::Handle<v8::internal::RegExpMatchInfo> match_info =
+        v8::internal::RegExpMatchInfo::New(i_isolate, 0);
+    exec_state->match_info = v8::internal::Handle<v8::internal::RegExpMatchInfo>::cast(
+        i_isolate->global_handles()->Create(*match_info)
+    );
+}
+
+
+V8RegExpResult &ScratchResult(uint32_t string_length)
+{
+    std::unique_ptr<V8RegExpResult> &result = exec_state->scratch_results[string_length];
+    if (result == nullptr)
+    {
+        result = std::make_unique<V8RegExpResult>(string_length);
+    }
+    return *result;
+}
+
+
+/**
+ * The running watchdog (see ExecWatchdog), or nullptr. Set and cleared
+ * only while no other thread executes.
+ */
+static std::unique_ptr<regulator::fuzz::Watchdog> watchdog;
+static uint64_t watchdog_generation = 0;
+static std::chrono::steady_clock::duration watchdog_exec_timeout;
+static std::chrono::steady_clock::time_point watchdog_deadline;
+
+
+ExecWatchdog::ExecWatchdog(
+    std::chrono::steady_clock::duration exec_timeout,
+    std::chrono::steady_clock::time_point deadline)
+{
+    watchdog_exec_timeout = exec_timeout;
+    watchdog_deadline = deadline;
+
+    // poll often enough to honor short timeouts, but don't spin
+    std::chrono::steady_clock::duration poll = std::chrono::milliseconds(10);
+    if (exec_timeout > std::chrono::steady_clock::duration::zero())
+    {
+        poll = std::max(
+            std::min(poll, exec_timeout / 4),
+            std::chrono::steady_clock::duration(std::chrono::milliseconds(1))
+        );
+    }
+    watchdog = std::make_unique<regulator::fuzz::Watchdog>(poll);
+    watchdog_generation++;
+}
+
+
+ExecWatchdog::~ExecWatchdog()
+{
+    watchdog.reset();
+}
+
+
+/**
+ * Starts watching the execution about to run on this thread, if a
+ * watchdog is running
+ */
+static inline void arm_watchdog()
+{
+    if (watchdog == nullptr)
+    {
+        return;
+    }
+
+    if (exec_state->watchdog_generation != watchdog_generation)
+    {
+        v8::Isolate *my_isolate = isolate;
+        exec_state->watchdog_generation = watchdog_generation;
+        exec_state->watchdog_slot = watchdog->Register([my_isolate]() {
+            // serviced by the interpreter's HandleInterrupts, which then
+            // abandons the match
+            my_isolate->TerminateExecution();
+        });
+    }
+
+    std::chrono::steady_clock::time_point deadline = watchdog_deadline;
+    if (watchdog_exec_timeout > std::chrono::steady_clock::duration::zero())
+    {
+        deadline = std::min(deadline, std::chrono::steady_clock::now() + watchdog_exec_timeout);
+    }
+    exec_state->watchdog_slot->Arm(deadline);
+}
+
+
+/**
+ * Stops watching this thread's execution. If the watchdog fired, the
+ * isolate is made usable again -- whether the termination stopped the
+ * execution or only arrived after it was done.
+ */
+static inline void disarm_watchdog()
+{
+    if (watchdog == nullptr || !exec_state->watchdog_slot->Disarm())
+    {
+        return;
+    }
+
+    isolate->CancelTerminateExecution();
+    if (i_isolate->has_pending_exception())
+    {
+        i_isolate->clear_pending_exception();
+    }
+}
+
+
+/**
+ * True when the execution which just returned on this thread was stopped
+ * by a termination, which leaves the termination exception pending
+ */
+static inline bool was_terminated()
+{
+    return i_isolate->has_pending_exception() &&
+        i_isolate->pending_exception() == v8::internal::ReadOnlyRoots(i_isolate).termination_exception();
+}
+
+
+/**
+ * The max_total the interpreter enforces: the caller's own, or else the
+ * default execution budget
+ */
+static inline int32_t effective_max_total(int32_t max_total)
+{
+    if (max_total >= 0 || regulator::flags::FLAG_exec_budget == 0)
+    {
+        return max_total;
+    }
+    return regulator::flags::FLAG_exec_budget;
+}
+
+
+/**
+ * The outcome of an execution whose coverage reached `total`; the
+ * interpreter gave up on it for lack of budget if `out_of_budget` (the
+ * only sign of that in the tiers which record no edges, where `total`
+ * stays 0)
+ */
+static inline Result limit_result(bool timed_out, bool out_of_budget, uint64_t total, int32_t max_total)
+{
+    if (timed_out)
+    {
+        return Result::kTimedOut;
+    }
+    if (max_total >= 0 && (out_of_budget || total >= static_cast<uint64_t>(max_total)))
+    {
+        return Result::kViolateMaxTotal;
+    }
+    const int32_t limit = effective_max_total(max_total);
+    if (limit >= 0 && (out_of_budget || total >= static_cast<uint64_t>(limit)))
+    {
+        return Result::kBudgetExhausted;
+    }
+    return Result::kSuccess;
+}
+
+
+/**
+ * True when `regexp` has `expected` (a copy of some bytecode) as its
+ * bytecode for the given width
+ */
+static bool bytecode_matches(
+    v8::internal::Handle<v8::internal::JSRegExp> regexp,
+    bool is_one_byte,
+    const std::vector<uint8_t> &expected)
+{
+    v8::internal::Object bytecode = regexp->Bytecode(is_one_byte);
+    if (!bytecode.IsByteArray())
+    {
+        return expected.empty();
+    }
+
+    v8::internal::ByteArray array = v8::internal::ByteArray::cast(bytecode);
+    return static_cast<size_t>(array.length()) == expected.size() &&
+        memcmp(array.GetDataStartAddress(), expected.data(), expected.size()) == 0;
+}
+
+
+/**
+ * The JSRegExp which this thread should execute for `regexp`: the
+ * original when this thread compiled it, otherwise this isolate's own
+ * copy, which is compiled on first use. Null if compilation fails.
+ */
+static v8::internal::Handle<v8::internal::JSRegExp> regexp_for_this_thread(V8RegExp *regexp)
+{
+    if (regexp->isolate == i_isolate)
+    {
+        return regexp->regexp;
+    }
+
+    auto it = exec_state->regexps.find(regexp->id);
+    if (it != exec_state->regexps.end())
+    {
+        return it->second;
+    }
+
+    v8::HandleScope handle_scope(isolate);
+    v8::internal::Handle<v8::internal::JSRegExp> compiled;
+    if (compile_in_this_isolate(regexp->pattern.c_str(), regexp->flags.c_str(), &compiled) != Result::kSuccess)
+    {
+        if (i_isolate->has_pending_exception())
+        {
+            i_isolate->clear_pending_exception();
+        }
+        return v8::internal::Handle<v8::internal::JSRegExp>::null();
+    }
+
+    if (!bytecode_matches(compiled, true, regexp->one_byte_bytecode) ||
+        !bytecode_matches(compiled, false, regexp->two_byte_bytecode))
+    {
+        std::cerr << "WARNING: regexp compiled to different bytecode on another thread; "
+            << "coverage may not agree between threads" << std::endl;
+    }
+
+    v8::internal::Handle<v8::internal::JSRegExp> global = v8::internal::Handle<v8::internal::JSRegExp>::cast(
+        i_isolate->global_handles()->Create(*compiled)
+    );
+    exec_state->regexps.emplace(regexp->id, global);
+    return global;
+}
+
+
+inline std::unordered_map<size_t, struct reusable_subject<uint8_t>> &reusable_subjects(const uint8_t *)
+{
+    return exec_state->one_byte_subjects;
+}
+
+
+inline std::unordered_map<size_t, struct reusable_subject<uint16_t>> &reusable_subjects(const uint16_t *)
+{
+    return exec_state->two_byte_subjects;
+}
+
+
+inline std::vector<uint8_t> &child_work_buffer(const uint8_t *)
+{
+    return exec_state->one_byte_work;
+}
+
+
+inline std::vector<uint16_t> &child_work_buffer(const uint16_t *)
+{
+    return exec_state->two_byte_work;
+}
+
+
+inline v8::internal::MaybeHandle<v8::internal::String>
+    construct_external_string(ReusableSubjectResource<uint8_t> *resource, v8::internal::Isolate *i_isolate)
+{
+    return i_isolate->factory()->NewExternalStringFromOneByte(resource);
+}
+
+
+inline v8::internal::MaybeHandle<v8::internal::String>
+    construct_external_string(ReusableSubjectResource<uint16_t> *resource, v8::internal::Isolate *i_isolate)
+{
+    return i_isolate->factory()->NewExternalStringFromTwoByte(resource);
+}
+
+
+/**
+ * True when V8 would give `subject` the same representation as an
+ * external string of its width. V8 stores two-byte input which fits in
+ * one byte as a one-byte string, so those must still be copied.
+ */
+inline bool can_reuse_subject(const uint8_t *subject, size_t subject_len)
+{
+    return subject_len > 0;
+}
+
+
+inline bool can_reuse_subject(const uint16_t *subject, size_t subject_len)
+{
+    for (size_t i = 0; i < subject_len; i++)
+    {
+        if (subject[i] > 0xFF)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Writes `subject` into this thread's reusable string of its width and
+ * length (creating that string on first use) and returns the string.
+ *
+ * Overwriting the characters of a live string is only sound because
+ * nothing on the interpreter's path hashes, internalizes or caches the
+ * subject; the string never escapes this file.
+ */
+template<typename Char>
+v8::internal::MaybeHandle<v8::internal::String> reuse_subject(const Char *subject, size_t subject_len)
+{
+    auto &subjects = reusable_subjects(subject);
+    auto it = subjects.find(subject_len);
+    if (it == subjects.end())
+    {
+        struct reusable_subject<Char> reusable;
+        reusable.resource = new ReusableSubjectResource<Char>(subject_len);
+
+        v8::internal::Handle<v8::internal::String> string;
+        if (!construct_external_string(reusable.resource, i_isolate).ToHandle(&string))
+        {
+            delete reusable.resource;
+            return v8::internal::MaybeHandle<v8::internal::String>();
+        }
+        reusable.string = v8::internal::Handle<v8::internal::String>::cast(
+            i_isolate->global_handles()->Create(*string)
+        );
+
+        it = subjects.emplace(subject_len, reusable).first;
+    }
+
+    memcpy(it->second.resource->Buffer(), subject, subject_len * sizeof(Char));
+    return it->second.string;
+}
+
+
 template<typename Char>
 Result Exec(
     V8RegExp *regexp,
@@ -272,10 +830,8 @@ Result Exec(
     size_t subject_len,
     V8RegExpResult &out,
     int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-    uint64_t max_path,
-#endif
-    EnforceRepresentation rep)
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation)
 {
     // Following set-up seen at v8 file fuzzer/regexp.cc
     v8::Isolate::Scope isolate_scope(isolate);
@@ -289,11 +845,19 @@ Result Exec(
         std::cerr << "Pending exception???" << std::endl;
     }
 
-    v8::internal::MaybeHandle<v8::internal::String> maybe_h_subject = construct_string(
-        subject,
-        subject_len,
-        i_isolate
-    );
+    v8::internal::MaybeHandle<v8::internal::String> maybe_h_subject;
+    if (!regulator::flags::FLAG_fresh_subjects && can_reuse_subject(subject, subject_len))
+    {
+        maybe_h_subject = reuse_subject(subject, subject_len);
+    }
+    else
+    {
+        maybe_h_subject = construct_string(
+            subject,
+            subject_len,
+            i_isolate
+        );
+    }
 
     v8::internal::Handle<v8::internal::String> h_subject;
     if (!maybe_h_subject.ToHandle(&h_subject))
@@ -320,52 +884,32 @@ Result Exec(
     }
 
 
-    v8::internal::Handle<v8::internal::RegExpMatchInfo> match_info(nullptr);
-    for (struct ThreadLocalV8RegExpMatchInfo *curr = regexp->match_infos;
-         curr != nullptr && match_info.is_null();
-         curr = curr->next)
-    {
-        if (curr->owning_thread == kNullThreadId)
-        {
-            // nobody owns this, claim it for ourselves I guess
-            std::unique_lock<std::mutex> lock(regexp->match_infos_mutex);
+    v8::internal::Handle<v8::internal::RegExpMatchInfo> match_info = exec_state->match_info;
 
-            // double-check to avoid a data race
-            if (curr->owning_thread == kNullThreadId)
-            {
-                curr->owning_thread = std::this_thread::get_id();
-            }
-            else
-            {
-                // if we lost the race then start the list iteration over again
-                curr = regexp->match_infos;
-            }
-        }
-        if (curr->owning_thread == std::this_thread::get_id())
-        {
-            match_info = curr->match_info;
-        }
-    }
-    
-    if (match_info.is_null())
+    v8::internal::Handle<v8::internal::JSRegExp> h_regexp = regexp_for_this_thread(regexp);
+    if (h_regexp.is_null())
     {
-        std::cerr << "ERROR: bad match_info?" << std::endl;
         return Result::kCouldNotCompile;
     }
 
+    out.coverage_tracker->UseEdgeIndex(regexp->edge_index.get());
+    out.coverage_tracker->SelectProgram(out.rep_used == kRepOneByte);
     out.coverage_tracker->Clear();
+    arm_watchdog();
     v8::internal::MaybeHandle<v8::internal::Object> o2 = v8::internal::RegExp::Exec(
         i_isolate,
-        regexp->regexp,
+        h_regexp,
         h_subject,
         0,
         match_info,
-        max_total,
-#if defined REG_COUNT_PATHLENGTH
-        max_path,
-#endif
+        effective_max_total(max_total),
+        instrumentation,
         out.coverage_tracker.get()
     );
+    // the interpreter gives up without an exception only when out of budget
+    const bool out_of_budget = o2.is_null() && !i_isolate->has_pending_exception();
+    const bool timed_out = o2.is_null() && was_terminated();
+    disarm_watchdog();
 
     if (o2.is_null())
     {
@@ -374,6 +918,16 @@ Result Exec(
     else
     {
         out.match_success = !(o2.ToHandleChecked()->IsNull());
+
+        // the match info is re-allocated when it needs room for more
+        // captures; keep the bigger one for next time
+        if (out.match_success && *o2.ToHandleChecked() != *match_info)
+        {
+            v8::internal::GlobalHandles::Destroy(exec_state->match_info.location());
+            exec_state->match_info = v8::internal::Handle<v8::internal::RegExpMatchInfo>::cast(
+                i_isolate->global_handles()->Create(*o2.ToHandleChecked())
+            );
+        }
     }
 
     if (i_isolate->has_pending_exception())
@@ -396,11 +950,248 @@ Result Exec(
     //     std::cout << "unusual number of pumps: " << pumps << std::endl;
     // }
 
-    // check if we violated max total
-    if (max_total >= 0 && out.coverage_tracker->Total() >= max_total)
+    // check if we violated max total (or ran out of time)
+    return limit_result(timed_out, out_of_budget, out.coverage_tracker->Total(), max_total);
+}
+
+/**
+ * Body of ExecRaw and ExecBatch, once this thread's copy of the regexp
+ * (`h_regexp`) is known
+ */
+template<typename Char>
+inline Result exec_raw_one(
+    V8RegExp *regexp,
+    v8::internal::Handle<v8::internal::JSRegExp> h_regexp,
+    const Char *subject,
+    size_t subject_len,
+    V8RegExpResult &out,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation)
+{
+    // only needed when the subject can't use a reusable string
+    v8::internal::HandleScope handle_scope(i_isolate);
+
+    v8::internal::MaybeHandle<v8::internal::String> maybe_h_subject;
+    if (!regulator::flags::FLAG_fresh_subjects && can_reuse_subject(subject, subject_len))
     {
-        return Result::kViolateMaxTotal;
+        maybe_h_subject = reuse_subject(subject, subject_len);
+    }
+    else
+    {
+        maybe_h_subject = construct_string(
+            subject,
+            subject_len,
+            i_isolate
+        );
+    }
+
+    v8::internal::Handle<v8::internal::String> h_subject;
+    if (!maybe_h_subject.ToHandle(&h_subject))
+    {
+        return Result::kNotValidString;
+    }
+    h_subject = v8::internal::String::Flatten(i_isolate, h_subject);
+
+    const bool is_one_byte = v8::internal::String::IsOneByteRepresentationUnderneath(*h_subject);
+    if ((rep == kOnlyOneByte && !is_one_byte) || (rep == kOnlyTwoByte && is_one_byte))
+    {
+        return Result::kBadStrRepresentation;
+    }
+
+    v8::internal::Object bytecode = h_regexp->Bytecode(is_one_byte);
+    if (!bytecode.IsByteArray())
+    {
+        // not compiled for this width yet; let the full path compile it
+        return Exec(
+            regexp,
+            subject,
+            subject_len,
+            out,
+            max_total,
+            rep,
+            instrumentation
+        );
+    }
+
+    out.rep_used = is_one_byte ? kRepOneByte : kRepTwoByte;
+
+    const int n_registers = v8::internal::Smi::ToInt(
+        h_regexp->DataAt(v8::internal::JSRegExp::kIrregexpMaxRegisterCountIndex)
+    );
+    std::vector<int> &registers = exec_state->registers;
+    if (registers.size() < static_cast<size_t>(n_registers))
+    {
+        registers.resize(n_registers);
+    }
+
+    out.coverage_tracker->UseEdgeIndex(regexp->edge_index.get());
+    out.coverage_tracker->SelectProgram(is_one_byte);
+    out.coverage_tracker->Clear();
+
+    arm_watchdog();
+    v8::internal::IrregexpInterpreter::Result result =
+        v8::internal::IrregexpInterpreter::MatchInternal(
+            i_isolate,
+            v8::internal::ByteArray::cast(bytecode),
+            *h_subject,
+            registers.data(),
+            n_registers,
+            0,
+            v8::internal::RegExp::CallOrigin::kFromRuntime,
+            h_regexp->BacktrackLimit(),
+            effective_max_total(max_total),
+            instrumentation,
+            out.coverage_tracker.get(),
+            &exec_state->backtrack
+        );
+    const bool out_of_budget = result == v8::internal::IrregexpInterpreter::EXCEPTION &&
+        !i_isolate->has_pending_exception();
+    // a watchdog which fires once the match is done does not make it a
+    // timeout; disarming only clears up after it
+    const bool timed_out = result == v8::internal::IrregexpInterpreter::TERMINATED;
+    disarm_watchdog();
+
+    out.match_success = result == v8::internal::IrregexpInterpreter::SUCCESS;
+
+    if (i_isolate->has_pending_exception())
+    {
+        // a stack overflow; there is no TryCatch to swallow it for us
+        i_isolate->clear_pending_exception();
+    }
+
+    out.coverage_tracker->Bucketize();
+
+    // check if we violated max total (or ran out of time)
+    return limit_result(timed_out, out_of_budget, out.coverage_tracker->Total(), max_total);
+}
+
+
+template<typename Char>
+Result ExecRaw(
+    V8RegExp *regexp,
+    const Char *subject,
+    size_t subject_len,
+    V8RegExpResult &out,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation)
+{
+    v8::internal::Handle<v8::internal::JSRegExp> h_regexp = regexp_for_this_thread(regexp);
+    if (h_regexp.is_null())
+    {
+        return Result::kCouldNotCompile;
+    }
+
+    return exec_raw_one(
+        regexp,
+        h_regexp,
+        subject,
+        subject_len,
+        out,
+        max_total,
+        rep,
+        instrumentation
+    );
+}
+
+
+template<typename Char>
+Result ExecBatch(
+    V8RegExp *regexp,
+    const Char *subjects,
+    size_t n_subjects,
+    size_t subject_len,
+    V8RegExpResult *results,
+    Result *result_codes,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation)
+{
+    v8::internal::Handle<v8::internal::JSRegExp> h_regexp = regexp_for_this_thread(regexp);
+    if (h_regexp.is_null())
+    {
+        for (size_t i = 0; i < n_subjects; i++)
+        {
+            result_codes[i] = Result::kCouldNotCompile;
+        }
+        return Result::kCouldNotCompile;
+    }
+
+    for (size_t i = 0; i < n_subjects; i++)
+    {
+        V8RegExpResult &out = results[i];
+        if (out.coverage_tracker == nullptr)
+        {
+            // the caller took the previous tracker
+            out.coverage_tracker = std::make_unique<regulator::fuzz::CoverageTracker>(subject_len);
+        }
+
+        result_codes[i] = exec_raw_one(
+            regexp,
+            h_regexp,
+            subjects + i * subject_len,
+            subject_len,
+            out,
+            max_total,
+            rep,
+            instrumentation
+        );
+    }
+
+    return Result::kSuccess;
+}
+
+
+template<typename Char>
+Result ExecBatch(
+    V8RegExp *regexp,
+    const regulator::fuzz::ChildEdits<Char> &children,
+    size_t begin,
+    size_t end,
+    V8RegExpResult *results,
+    Result *result_codes,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation)
+{
+    v8::internal::Handle<v8::internal::JSRegExp> h_regexp = regexp_for_this_thread(regexp);
+    if (h_regexp.is_null())
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            result_codes[i - begin] = Result::kCouldNotCompile;
+        }
+        return Result::kCouldNotCompile;
+    }
+
+    const size_t subject_len = children.Length();
+    std::vector<Char> &work = child_work_buffer(children.Parent());
+    work.assign(children.Parent(), children.Parent() + subject_len);
+
+    for (size_t i = begin; i < end; i++)
+    {
+        V8RegExpResult &out = results[i - begin];
+        if (out.coverage_tracker == nullptr)
+        {
+            // the caller took the previous tracker
+            out.coverage_tracker = std::make_unique<regulator::fuzz::CoverageTracker>(subject_len);
+        }
+
+        children.Apply(i, work.data());
+        result_codes[i - begin] = exec_raw_one(
+            regexp,
+            h_regexp,
+            work.data(),
+            subject_len,
+            out,
+            max_total,
+            rep,
+            instrumentation
+        );
+        children.Revert(i, work.data());
     }
+
     return Result::kSuccess;
 }
 
@@ -411,10 +1202,8 @@ Result Exec<uint8_t>(
     size_t subject_len,
     V8RegExpResult &out,
     int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-    uint64_t max_path,
-#endif
-    EnforceRepresentation rep);
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation);
 
 template
 Result Exec<uint16_t>(
@@ -423,10 +1212,76 @@ Result Exec<uint16_t>(
     size_t subject_len,
     V8RegExpResult &out,
     int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-    uint64_t max_path,
-#endif
-    EnforceRepresentation rep);
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation);
+
+template
+Result ExecRaw<uint8_t>(
+    V8RegExp *regexp,
+    const uint8_t *subject,
+    size_t subject_len,
+    V8RegExpResult &out,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation);
+
+template
+Result ExecRaw<uint16_t>(
+    V8RegExp *regexp,
+    const uint16_t *subject,
+    size_t subject_len,
+    V8RegExpResult &out,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation);
+
+template
+Result ExecBatch<uint8_t>(
+    V8RegExp *regexp,
+    const uint8_t *subjects,
+    size_t n_subjects,
+    size_t subject_len,
+    V8RegExpResult *results,
+    Result *result_codes,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation);
+
+template
+Result ExecBatch<uint16_t>(
+    V8RegExp *regexp,
+    const uint16_t *subjects,
+    size_t n_subjects,
+    size_t subject_len,
+    V8RegExpResult *results,
+    Result *result_codes,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation);
 
+template
+Result ExecBatch<uint8_t>(
+    V8RegExp *regexp,
+    const regulator::fuzz::ChildEdits<uint8_t> &children,
+    size_t begin,
+    size_t end,
+    V8RegExpResult *results,
+    Result *result_codes,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation);
+
+template
+Result ExecBatch<uint16_t>(
+    V8RegExp *regexp,
+    const regulator::fuzz::ChildEdits<uint16_t> &children,
+    size_t begin,
+    size_t end,
+    V8RegExpResult *results,
+    Result *result_codes,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation);
+
+}
 }
-}
\ No newline at end of file
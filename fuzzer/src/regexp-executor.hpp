@@ -8,12 +8,16 @@
 #pragma once
 
 #include <stdint.h>
+#include <chrono>
 #include <memory>
-#include <thread>
-#include <mutex>
+#include <string>
+#include <vector>
 
 #include "src/objects/js-regexp.h"
+#include "fuzz/child-edits.hpp"
 #include "fuzz/coverage-tracker.hpp"
+#include "fuzz/edge-index.hpp"
+#include "fuzz/instrumentation.hpp"
 
 
 namespace regulator
@@ -28,6 +32,17 @@ enum Result {
     kCouldNotCompile,
     kBadStrRepresentation,
     kViolateMaxTotal,
+
+    /**
+     * No max_total was given, and the execution used up the default
+     * budget (flags::FLAG_exec_budget); the coverage is partial
+     */
+    kBudgetExhausted,
+
+    /**
+     * The ExecWatchdog stopped the execution; the coverage is partial
+     */
+    kTimedOut,
 };
 
 enum RepresentationUsed {
@@ -41,26 +56,54 @@ enum EnforceRepresentation {
     kOnlyTwoByte,
 };
 
-struct ThreadLocalV8RegExpMatchInfo
-{
-    struct ThreadLocalV8RegExpMatchInfo *next;
-    v8::internal::Handle<v8::internal::RegExpMatchInfo> match_info;
-    std::thread::id owning_thread;
-};
-
 class V8RegExp {
 public:
     V8RegExp();
 
+    /**
+     * The regexp as compiled in the compiling thread's isolate. Other
+     * threads execute their own copy, compiled in their own isolate on
+     * first use (see Exec).
+     */
     v8::internal::Handle<v8::internal::JSRegExp> regexp;
-    struct ThreadLocalV8RegExpMatchInfo *match_infos;
-    std::mutex match_infos_mutex;
+
+    /**
+     * The isolate which owns `regexp`
+     */
+    v8::internal::Isolate *isolate;
+
+    /**
+     * Identifies this regexp in each thread's compiled copies
+     */
+    uint64_t id;
+
+    /**
+     * The source, to recompile in other isolates
+     */
+    std::string pattern;
+    std::string flags;
+
+    /**
+     * The bytecode compiled for each subject width; other isolates'
+     * copies must match it byte for byte, or coverage would not agree
+     * between threads
+     */
+    std::vector<uint8_t> one_byte_bytecode;
+    std::vector<uint8_t> two_byte_bytecode;
+
+    /**
+     * Dense edge ids for the compiled bytecode, or nullptr when
+     * coverage is hashed (see flags::FLAG_dense_edges)
+     */
+    std::unique_ptr<regulator::fuzz::EdgeIndex> edge_index;
 };
 
 class V8RegExpResult {
 public:
     V8RegExpResult();
     V8RegExpResult(uint32_t string_length);
+    V8RegExpResult(V8RegExpResult &&other) = default;
+    V8RegExpResult &operator=(V8RegExpResult &&other) = default;
     ~V8RegExpResult();
 
     bool match_success;
@@ -71,6 +114,10 @@ public:
 /**
  * Initialize the V8 runtime. This should be called before any regexp operations
  * are performed.
+ *
+ * Each thread which executes regexps must call this once before its first
+ * execution; that creates the thread's isolate and claims its execution state
+ * (match info, registers, reusable subjects and scratch results).
  * 
  * This method is idempotent and can be called multiple times.
  */
@@ -80,9 +127,39 @@ v8::Isolate *Initialize();
  * Compiles the given character string (interpreted as null-terminated utf8) to a regexp, and
  * puts the result in `out`. Returns an indicator of success / failure.
  */
-Result Compile(const char *pattern, const char *flags, V8RegExp *out, uint16_t n_threads = 1);
+Result Compile(const char *pattern, const char *flags, V8RegExp *out);
 
+/**
+ * A result object owned by the calling thread for subjects of length
+ * `string_length`, reused by every caller on this thread. Requires
+ * Initialize() on this thread.
+ */
+V8RegExpResult &ScratchResult(uint32_t string_length);
 
+
+/**
+ * While alive, stops any execution (on any thread) which runs longer than
+ * `exec_timeout` (if positive) or past `deadline`, by terminating the
+ * thread's isolate; the execution then returns kTimedOut, unless it was
+ * done before the interpreter noticed. Create it before starting the
+ * threads which execute, and destroy it once they are done.
+ */
+class ExecWatchdog
+{
+public:
+    ExecWatchdog(
+        std::chrono::steady_clock::duration exec_timeout,
+        std::chrono::steady_clock::time_point deadline);
+    ~ExecWatchdog();
+};
+
+
+/**
+ * Executes `regexp` on `subject`, recording into `out` whatever
+ * `instrumentation` asks for. Every tier counts the branches taken
+ * against max_total (or the default budget), whether or not it records
+ * them as edges.
+ */
 template<typename Char>
 Result Exec(
     V8RegExp *regexp,
@@ -90,10 +167,67 @@ Result Exec(
     size_t subject_lens,
     V8RegExpResult &out,
     int32_t max_total,
-#if defined REG_COUNT_PATHLENGTH
-    uint64_t max_path,
-#endif
-    EnforceRepresentation rep);
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation = regulator::fuzz::kInstrumentFull);
+
+/**
+ * Like Exec, but calls straight into the bytecode interpreter: there is
+ * no Context scope, TryCatch, RegExpMatchInfo or last-match bookkeeping,
+ * and the registers are a per-thread buffer reused across calls. Only
+ * `match_success`, `rep_used` and the coverage are produced.
+ *
+ * Falls back to Exec when the bytecode for the subject's width has not
+ * been compiled yet.
+ */
+template<typename Char>
+Result ExecRaw(
+    V8RegExp *regexp,
+    const Char *subject,
+    size_t subject_len,
+    V8RegExpResult &out,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation = regulator::fuzz::kInstrumentFull);
+
+/**
+ * Runs ExecRaw on each of `n_subjects` subjects of length `subject_len`,
+ * stored back-to-back in `subjects`, setting up the execution once for
+ * the whole batch. Subject i's outcome goes to `results[i]` and
+ * `result_codes[i]`; a result whose coverage tracker was taken (is null)
+ * gets a new one.
+ *
+ * Returns kSuccess, or kCouldNotCompile (for the batch and every subject,
+ * running nothing) if the regexp can not be compiled for this thread.
+ */
+template<typename Char>
+Result ExecBatch(
+    V8RegExp *regexp,
+    const Char *subjects,
+    size_t n_subjects,
+    size_t subject_len,
+    V8RegExpResult *results,
+    Result *result_codes,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation = regulator::fuzz::kInstrumentFull);
+
+/**
+ * Like ExecBatch, but runs children [begin, end) of `children`, each made
+ * by applying its edits to this thread's copy of the parent (and reverted
+ * afterwards). Child i's outcome goes to `results[i - begin]` and
+ * `result_codes[i - begin]`.
+ */
+template<typename Char>
+Result ExecBatch(
+    V8RegExp *regexp,
+    const regulator::fuzz::ChildEdits<Char> &children,
+    size_t begin,
+    size_t end,
+    V8RegExpResult *results,
+    Result *result_codes,
+    int32_t max_total,
+    EnforceRepresentation rep,
+    regulator::fuzz::Instrumentation instrumentation = regulator::fuzz::kInstrumentFull);
 
 }
 }
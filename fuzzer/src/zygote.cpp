@@ -0,0 +1,169 @@
+#include "zygote.hpp"
+#include "util.hpp"
+
+#include <cerrno>
+#include <exception>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace regulator
+{
+
+static const char *ZYGOTE_PROG_NAME = "regulator-zygote-job";
+
+
+bool parse_zygote_job(const std::string &line, std::vector<std::string> &out)
+{
+    static const std::string alphabet =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=";
+
+    out.clear();
+    size_t start = 0;
+    while (start <= line.size())
+    {
+        size_t end = line.find(' ', start);
+        if (end == std::string::npos)
+        {
+            end = line.size();
+        }
+
+        std::string encoded = line.substr(start, end - start);
+        if (encoded.find_first_not_of(alphabet) != std::string::npos)
+        {
+            return false;
+        }
+
+        uint8_t *decoded;
+        size_t decoded_len;
+        base64_decode_one_byte(encoded, decoded, decoded_len);
+        out.push_back(std::string(reinterpret_cast<char *>(decoded), decoded_len));
+        delete[] decoded;
+
+        start = end + 1;
+    }
+
+    return true;
+}
+
+
+/**
+ * Runs one job in the (freshly forked) child; never returns. Every way out
+ * goes through _exit, so that the child skips the zygote's atexit handlers
+ * and static destructors (V8 and platform teardown among them), which
+ * belong to the zygote.
+ */
+static void run_child(std::vector<std::string> &job, std::ostream &out, int (*run_job)(ParsedArguments &))
+{
+    // the control pipe belongs to the zygote
+    int devnull = open("/dev/null", O_RDONLY);
+    if (devnull >= 0)
+    {
+        dup2(devnull, STDIN_FILENO);
+        close(devnull);
+    }
+
+    out << "ZYGOTE_CHILD " << getpid() << std::endl;
+
+    std::vector<char *> argv;
+    argv.push_back(const_cast<char *>(ZYGOTE_PROG_NAME));
+    for (size_t i = 0; i < job.size(); i++)
+    {
+        argv.push_back(&job[i][0]);
+    }
+    argv.push_back(nullptr);
+
+    // the job's arguments are untrusted, and Parse() would exit() on bad
+    // ones; TryParse() reports them instead
+    ParsedArguments args;
+    int status = ParsedArguments::TryParse(static_cast<int>(job.size() + 1), argv.data(), args);
+    if (status == PARSE_CONTINUE)
+    {
+        if (args.zygote || args.count_paths)
+        {
+            std::cerr << "ERROR: a zygote job can not use --zygote or --count-paths" << std::endl;
+            status = 1;
+        }
+        else
+        {
+            try
+            {
+                status = run_job(args);
+            }
+            catch (const std::exception &e)
+            {
+                // must not unwind into the zygote's loop (and out of main)
+                std::cerr << "ERROR: zygote job failed: " << e.what() << std::endl;
+                status = 1;
+            }
+        }
+    }
+
+    std::cout.flush();
+    std::cerr.flush();
+    out.flush();
+    _exit(status);
+}
+
+
+int loop_zygote(std::istream &jobs, std::ostream &out, int (*run_job)(ParsedArguments &))
+{
+    std::vector<std::string> job;
+    for (std::string line; std::getline(jobs, line);)
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+
+        if (!parse_zygote_job(line, job))
+        {
+            std::cerr << "ERROR: could not decode zygote job" << std::endl;
+            out << "ZYGOTE_DONE 0 1" << std::endl;
+            continue;
+        }
+
+        // otherwise the child inherits (and later repeats) anything buffered
+        std::cout.flush();
+        std::cerr.flush();
+        out.flush();
+
+        pid_t pid = fork();
+        if (pid < 0)
+        {
+            std::cerr << "ERROR: fork failed" << std::endl;
+            return 1;
+        }
+        if (pid == 0)
+        {
+            run_child(job, out, run_job);
+        }
+
+        int wstatus = 0;
+        pid_t waited;
+        do
+        {
+            waited = waitpid(pid, &wstatus, 0);
+        } while (waited < 0 && errno == EINTR);
+
+        int status = 1;
+        if (waited < 0)
+        {
+            std::cerr << "ERROR: lost track of zygote child " << pid << std::endl;
+        }
+        else if (WIFEXITED(wstatus))
+        {
+            status = WEXITSTATUS(wstatus);
+        }
+        else if (WIFSIGNALED(wstatus))
+        {
+            status = 128 + WTERMSIG(wstatus);
+        }
+        out << "ZYGOTE_DONE " << pid << " " << status << std::endl;
+    }
+
+    return 0;
+}
+
+}
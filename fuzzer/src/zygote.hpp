@@ -0,0 +1,56 @@
+// zygote.hpp
+//
+// Serves fuzz jobs from a process which has already initialized V8.
+//
+// Starting the fuzzer costs ICU and V8 initialization, startup
+// data and isolate and context creation before the first
+// execution. In zygote mode (--zygote) we pay that once: the
+// zygote then reads jobs from its stdin (the control pipe), and
+// forks a pre-warmed child to run each one.
+//
+// Protocol, one job per line:
+//
+//   request:  the job's command-line arguments (without the program
+//             name), each base64-encoded, separated by single spaces
+//   replies:  "ZYGOTE_CHILD <pid>" from the child, before any of its
+//             own output (kill this pid to abandon the job);
+//             "ZYGOTE_DONE <pid> <status>" from the zygote once the
+//             child is gone, where status is the exit code, or 128 +
+//             the signal number if the child was killed
+//
+// Jobs run one at a time. The zygote exits at end-of-input.
+//
+// A forked child has only the thread which forked it: the V8
+// platform's worker threads are gone, and a task posted to them
+// would never run. The zygote therefore runs V8 with
+// --single-threaded, so that V8 itself posts no background work
+// (concurrent marking or compilation) that it could wait on;
+// jobs' own execution threads are started in the child, and
+// are unaffected. Likewise the child never runs the zygote's
+// exit-time teardown: it leaves through _exit only.
+//
+
+#pragma once
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "argument-parser.hpp"
+
+namespace regulator
+{
+
+/**
+ * Decodes one job line into its arguments. Returns false if the line is
+ * malformed.
+ */
+bool parse_zygote_job(const std::string &line, std::vector<std::string> &out);
+
+/**
+ * Reads jobs from `jobs` until end-of-input, running each with `run_job` in a
+ * forked child. Replies go to `out`. Returns the zygote's exit code.
+ */
+int loop_zygote(std::istream &jobs, std::ostream &out, int (*run_job)(ParsedArguments &));
+
+}
@@ -0,0 +1,114 @@
+#include "fuzz/coverage-tracker.hpp"
+#include "fuzz/random.hpp"
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace regulator::fuzz;
+
+/**
+ * Builds a synthetic trace of `n_covers` branch transitions spread over
+ * roughly `n_edges` distinct (src, dst) pairs, laid out like bytecode
+ * offsets (4-byte aligned).
+ */
+static std::vector<std::pair<uintptr_t, uintptr_t>> make_trace(size_t n_edges, size_t n_covers)
+{
+    std::vector<std::pair<uintptr_t, uintptr_t>> ret;
+    Random random(0x9E3779B97F4A7C15ull);
+    for (size_t i = 0; i < n_covers; i++)
+    {
+        const uint64_t x = random.Next();
+        uintptr_t src = (x % n_edges) * 8;
+        uintptr_t dst = src + 8 + ((x >> 32) & 1) * 16;
+        ret.push_back(std::make_pair(src, dst));
+    }
+    return ret;
+}
+
+/**
+ * Performs the coverage-tracker work of one fuzzer execution: reset,
+ * record the trace, bucketize, test for novelty and snapshot the map.
+ */
+static bool simulate_exec(
+    CoverageTracker &tracker,
+    CoverageTracker &upper_bound,
+    const std::vector<std::pair<uintptr_t, uintptr_t>> &trace)
+{
+    tracker.Clear();
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+        tracker.Cover(trace[i].first, trace[i].second);
+    }
+    tracker.Bucketize();
+    bool ret = upper_bound.HasNewPath(&tracker);
+    CoverageTracker copy(tracker);
+    return ret && copy.Residency() > 0;
+}
+
+TEST_CASE( "Bench CoverageTracker per-execution overhead", "[!benchmark]" )
+{
+    CoverageTracker tracker(16);
+    CoverageTracker upper_bound(0);
+
+    auto small_trace = make_trace(24, 200);
+    auto large_trace = make_trace(4000, 50000);
+
+    BENCHMARK( "small program (24 edges, 200 transitions)" )
+    {
+        return simulate_exec(tracker, upper_bound, small_trace);
+    };
+
+    BENCHMARK( "large program (4000 edges, 50000 transitions)" )
+    {
+        return simulate_exec(tracker, upper_bound, large_trace);
+    };
+
+    // steady state: the upper bound is already populated
+    upper_bound.Union(&tracker);
+    BENCHMARK( "small program, populated upper bound" )
+    {
+        return simulate_exec(tracker, upper_bound, small_trace);
+    };
+}
+
+TEST_CASE( "Bench CoverageTracker full-map sweeps", "[!benchmark]" )
+{
+    // every slot of the map is touched, so sweeps cannot skip anything
+    CoverageTracker tracker(0);
+    CoverageTracker upper_bound(0);
+    for (uintptr_t src = 0; src < MAP_SIZE * 4; src += 4)
+    {
+        for (size_t i = 0; i < 1 + src % 7; i++)
+        {
+            tracker.Cover(src, src);
+        }
+    }
+    CoverageTracker raw(tracker);
+    tracker.Bucketize();
+    upper_bound.Union(&tracker);
+
+    BENCHMARK( "Bucketize" )
+    {
+        CoverageTracker copy(raw);
+        copy.Bucketize();
+        return copy.Total();
+    };
+
+    BENCHMARK( "Union" )
+    {
+        upper_bound.Union(&tracker);
+        return upper_bound.Total();
+    };
+
+    BENCHMARK( "HasNewPath (none new)" )
+    {
+        return upper_bound.HasNewPath(&tracker);
+    };
+
+    BENCHMARK( "Residency" )
+    {
+        return tracker.Residency();
+    };
+}
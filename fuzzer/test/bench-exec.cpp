@@ -0,0 +1,239 @@
+#include "regexp-executor.hpp"
+#include "fuzz/coverage-tracker.hpp"
+#include "v8.h"
+
+#include "catch.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace e = regulator::executor;
+
+/**
+ * Runs Exec, ExecRaw and ExecBatch over one pattern and subject, after
+ * checking that Exec and ExecRaw agree
+ */
+static void bench_exec_paths(const char *pattern, const std::string &subject)
+{
+    e::V8RegExp regexp;
+    REQUIRE( e::Compile(pattern, "", &regexp) == e::kSuccess );
+
+    const uint8_t *subject_bytes = reinterpret_cast<const uint8_t *>(subject.c_str());
+    e::V8RegExpResult result(subject.size());
+    e::V8RegExpResult raw_result(subject.size());
+
+    // also compiles the one-byte bytecode, so ExecRaw takes its own path
+    REQUIRE( e::Exec<uint8_t>(
+        &regexp, subject_bytes, subject.size(), result, -1,
+        e::kOnlyOneByte
+    ) == e::kSuccess );
+    REQUIRE( e::ExecRaw<uint8_t>(
+        &regexp, subject_bytes, subject.size(), raw_result, -1,
+        e::kOnlyOneByte
+    ) == e::kSuccess );
+    REQUIRE( result.match_success == raw_result.match_success );
+    REQUIRE( result.coverage_tracker->Total() == raw_result.coverage_tracker->Total() );
+
+    BENCHMARK( std::string("Exec ") + pattern )
+    {
+        return e::Exec<uint8_t>(
+            &regexp, subject_bytes, subject.size(), result, -1,
+            e::kOnlyOneByte
+        );
+    };
+
+    BENCHMARK( std::string("ExecRaw ") + pattern )
+    {
+        return e::ExecRaw<uint8_t>(
+            &regexp, subject_bytes, subject.size(), raw_result, -1,
+            e::kOnlyOneByte
+        );
+    };
+
+    // 200 children per parent, as the fuzzer evaluates them
+    const size_t n_batch = 200;
+    std::string batch;
+    for (size_t i = 0; i < n_batch; i++)
+    {
+        batch += subject;
+    }
+    std::vector<e::V8RegExpResult> batch_results;
+    for (size_t i = 0; i < n_batch; i++)
+    {
+        batch_results.emplace_back(subject.size());
+    }
+    std::vector<e::Result> batch_codes(n_batch);
+
+    BENCHMARK( std::string("200x ExecRaw ") + pattern )
+    {
+        for (size_t i = 0; i < n_batch; i++)
+        {
+            e::ExecRaw<uint8_t>(
+                &regexp,
+                reinterpret_cast<const uint8_t *>(batch.c_str()) + i * subject.size(),
+                subject.size(), batch_results[i], -1,
+                e::kOnlyOneByte
+            );
+        }
+        return batch_results[0].match_success;
+    };
+
+    BENCHMARK( std::string("ExecBatch of 200 ") + pattern )
+    {
+        return e::ExecBatch<uint8_t>(
+            &regexp,
+            reinterpret_cast<const uint8_t *>(batch.c_str()),
+            n_batch, subject.size(),
+            batch_results.data(), batch_codes.data(), -1,
+            e::kOnlyOneByte
+        );
+    };
+}
+
+TEST_CASE( "Bench Exec vs ExecRaw vs ExecBatch", "[!benchmark]" )
+{
+    v8::Isolate *isolate = regulator::executor::Initialize();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
+    ctx->Enter();
+
+    bench_exec_paths("fo[o]", "foo");
+    bench_exec_paths("fo[o]+", "foooooooooooooooooooooooooooooo");
+    bench_exec_paths("a(b|c)d(e|f)+g.", "acdefefefefefefefefefefefg!");
+    bench_exec_paths("^\\d+1\\d+2", "1111111111111111111111111111111111111111");
+}
+
+
+#ifdef DEBUG
+static const char *build_name = "debug";
+#else
+static const char *build_name = "release";
+#endif
+
+/**
+ * Prints how many ExecRaw calls per second one thread sustains on one
+ * pattern and subject, in the form the fuzzer evaluates children
+ */
+static void bench_exec_rate(const char *pattern, const std::string &subject)
+{
+    e::V8RegExp regexp;
+    REQUIRE( e::Compile(pattern, "", &regexp) == e::kSuccess );
+
+    const uint8_t *subject_bytes = reinterpret_cast<const uint8_t *>(subject.c_str());
+    e::V8RegExpResult result(subject.size());
+
+    const auto duration = std::chrono::seconds(1);
+    const auto start = std::chrono::steady_clock::now();
+    auto now = start;
+    uint64_t n_execs = 0;
+    while (now - start < duration)
+    {
+        // check the clock only every so often, it isn't free either
+        for (size_t i = 0; i < 64; i++)
+        {
+            e::ExecRaw<uint8_t>(
+                &regexp, subject_bytes, subject.size(), result, -1,
+                e::kOnlyOneByte
+            );
+        }
+        n_execs += 64;
+        now = std::chrono::steady_clock::now();
+    }
+
+    const double secs = std::chrono::duration<double>(now - start).count();
+    std::cout << build_name << " build: "
+        << static_cast<uint64_t>(n_execs / secs) << " exec/s  "
+        << pattern << std::endl;
+}
+
+TEST_CASE( "Bench exec/s", "[!benchmark][exec-rate]" )
+{
+    v8::Isolate *isolate = regulator::executor::Initialize();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
+    ctx->Enter();
+
+    bench_exec_rate("fo[o]+", "foooooooooooooooooooooooooooooo");
+    bench_exec_rate("a(b|c)d(e|f)+g.", "acdefefefefefefefefefefefg!");
+    bench_exec_rate("^(a|a)*b", "aaaaaaaaaaaaaaa");
+}
+
+
+/**
+ * Prints how many children per second one thread evaluates on one pattern
+ * and subject, end to end: ExecRaw (which clears and bucketizes the
+ * coverage map) and then the novelty checks against the campaign's upper
+ * bound, as in evaluate_children
+ */
+static void bench_eval_rate(const std::string &pattern, const std::string &subject, const char *label)
+{
+    e::V8RegExp regexp;
+    REQUIRE( e::Compile(pattern.c_str(), "", &regexp) == e::kSuccess );
+
+    const uint8_t *subject_bytes = reinterpret_cast<const uint8_t *>(subject.c_str());
+    e::V8RegExpResult result(subject.size());
+    regulator::fuzz::CoverageTracker upper_bound(subject.size());
+    REQUIRE( e::ExecRaw<uint8_t>(
+        &regexp, subject_bytes, subject.size(), result, -1,
+        e::kOnlyOneByte
+    ) == e::kSuccess );
+    upper_bound.Union(result.coverage_tracker.get());
+
+    const auto duration = std::chrono::seconds(1);
+    const auto start = std::chrono::steady_clock::now();
+    auto now = start;
+    uint64_t n_execs = 0;
+    uint64_t n_new = 0;
+    while (now - start < duration)
+    {
+        for (size_t i = 0; i < 64; i++)
+        {
+            e::ExecRaw<uint8_t>(
+                &regexp, subject_bytes, subject.size(), result, -1,
+                e::kOnlyOneByte
+            );
+            if (upper_bound.HasNewPath(result.coverage_tracker.get()) ||
+                upper_bound.MaximizesAnyEdge(result.coverage_tracker.get()))
+            {
+                n_new++;
+            }
+        }
+        n_execs += 64;
+        now = std::chrono::steady_clock::now();
+    }
+
+    const double secs = std::chrono::duration<double>(now - start).count();
+    std::cout << build_name << " build: "
+        << static_cast<uint64_t>(n_execs / secs) << " exec/s  "
+        << label << " (" << regexp.one_byte_bytecode.size() << " bytes of bytecode, "
+        << n_new << " with new coverage)" << std::endl;
+}
+
+TEST_CASE( "Bench exec/s on small and large programs", "[!benchmark][exec-rate]" )
+{
+    v8::Isolate *isolate = regulator::executor::Initialize();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
+    ctx->Enter();
+
+    bench_eval_rate("a(b|c)d(e|f)+g.", "acdefefefefefefefefefefefg!", "small program");
+
+    // a long alternation of distinct words compiles to a large program,
+    // and a subject cycling through them touches much of it
+    std::string pattern = "^(?:";
+    std::string subject;
+    for (size_t i = 0; i < 400; i++)
+    {
+        const std::string word = "w" + std::to_string(i * 7919 % 10007) + "x";
+        pattern += (i == 0 ? "" : "|") + word;
+        if (i % 13 == 0)
+        {
+            subject += word;
+        }
+    }
+    pattern += ")+$";
+    bench_eval_rate(pattern, subject, "large program");
+}
@@ -0,0 +1,44 @@
+#include "fuzz/path-hash.hpp"
+#include "fuzz/coverage-tracker.hpp"
+
+#include "catch.hpp"
+
+#include <cstdint>
+
+using namespace regulator::fuzz;
+
+TEST_CASE( "Bench path hash strategies", "[!benchmark]" )
+{
+    const size_t n_transitions = 10000;
+
+    BENCHMARK( "murmur, 10000 transitions" )
+    {
+        path_hash_t h = 0;
+        for (uintptr_t i = 0; i < n_transitions; i++)
+        {
+            h = path_hash_murmur(h, (i & 0xFF) * 8, (i & 0xFF) * 8 + 4);
+        }
+        return h;
+    };
+
+    BENCHMARK( "mulxor, 10000 transitions" )
+    {
+        path_hash_t h = 0;
+        for (uintptr_t i = 0; i < n_transitions; i++)
+        {
+            h = path_hash_mulxor(h, (i & 0xFF) * 8, (i & 0xFF) * 8 + 4);
+        }
+        return h;
+    };
+
+    CoverageTracker tracker(0);
+    BENCHMARK( "CoverageTracker::Cover, 10000 transitions" )
+    {
+        tracker.Clear();
+        for (uintptr_t i = 0; i < n_transitions; i++)
+        {
+            tracker.Cover((i & 0xFF) * 8, (i & 0xFF) * 8 + 4);
+        }
+        return tracker.PathHash();
+    };
+}
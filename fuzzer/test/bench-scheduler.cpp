@@ -0,0 +1,161 @@
+#include "fuzz/work-stealing-deque.hpp"
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace regulator::fuzz;
+
+/**
+ * Stands in for one work slice on a campaign
+ */
+static void fake_slice(std::atomic<uint64_t> &work)
+{
+    uint64_t x = work.fetch_add(1);
+    for (size_t i = 0; i < 200; i++)
+    {
+        x = x * 6364136223846793005ull + 1;
+    }
+    if (x == 0)
+    {
+        work++;
+    }
+}
+
+/**
+ * Campaigns in one list guarded by a mutex, handed out round-robin (the
+ * scheduler's previous design). Returns the time spent waiting for the lock.
+ */
+static std::chrono::nanoseconds run_mutex_scheduler(size_t n_threads, size_t n_campaigns, size_t n_slices)
+{
+    std::mutex mutex;
+    std::condition_variable waiter;
+    std::deque<size_t> work;
+    for (size_t i = 0; i < n_campaigns; i++)
+    {
+        work.push_back(i);
+    }
+    std::atomic<uint64_t> progress(0);
+    std::atomic<int64_t> slices_left(n_slices);
+    std::atomic<int64_t> wait_ns(0);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; t++)
+    {
+        threads.emplace_back([&]() {
+            while (slices_left.fetch_sub(1) > 0)
+            {
+                auto start = std::chrono::steady_clock::now();
+                size_t campaign;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    waiter.wait(lock, [&]() { return !work.empty(); });
+                    campaign = work.front();
+                    work.pop_front();
+                }
+                wait_ns += (std::chrono::steady_clock::now() - start).count();
+
+                fake_slice(progress);
+
+                start = std::chrono::steady_clock::now();
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    work.push_back(campaign);
+                }
+                waiter.notify_one();
+                wait_ns += (std::chrono::steady_clock::now() - start).count();
+            }
+        });
+    }
+    for (size_t t = 0; t < n_threads; t++)
+    {
+        threads[t].join();
+    }
+    return std::chrono::nanoseconds(wait_ns.load());
+}
+
+/**
+ * Campaigns dealt over per-thread work-stealing deques. Returns the time
+ * spent acquiring a campaign.
+ */
+static std::chrono::nanoseconds run_stealing_scheduler(size_t n_threads, size_t n_campaigns, size_t n_slices)
+{
+    std::vector<std::unique_ptr<WorkStealingDeque<size_t>>> deques;
+    for (size_t t = 0; t < n_threads; t++)
+    {
+        deques.push_back(std::unique_ptr<WorkStealingDeque<size_t>>(new WorkStealingDeque<size_t>(n_campaigns)));
+    }
+    for (size_t i = 0; i < n_campaigns; i++)
+    {
+        deques[i % n_threads]->Push(i);
+    }
+    std::atomic<uint64_t> progress(0);
+    std::atomic<int64_t> slices_left(n_slices);
+    std::atomic<int64_t> wait_ns(0);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; t++)
+    {
+        threads.emplace_back([&, t]() {
+            while (slices_left.fetch_sub(1) > 0)
+            {
+                auto start = std::chrono::steady_clock::now();
+                size_t campaign;
+                bool found = false;
+                while (!found)
+                {
+                    for (size_t i = 0; i < n_threads && !found; i++)
+                    {
+                        found = deques[(t + i) % n_threads]->Steal(campaign);
+                    }
+                    if (!found)
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                wait_ns += (std::chrono::steady_clock::now() - start).count();
+
+                fake_slice(progress);
+                deques[t]->Push(campaign);
+            }
+        });
+    }
+    for (size_t t = 0; t < n_threads; t++)
+    {
+        threads[t].join();
+    }
+    return std::chrono::nanoseconds(wait_ns.load());
+}
+
+TEST_CASE( "Bench campaign scheduler", "[!benchmark]" )
+{
+    const size_t n_threads = std::max(2u, std::thread::hardware_concurrency());
+    const size_t n_campaigns = n_threads * 4;
+    const size_t n_slices = 200000;
+
+    std::chrono::nanoseconds mutex_wait(0);
+    std::chrono::nanoseconds stealing_wait(0);
+
+    BENCHMARK( "mutex-guarded list" )
+    {
+        mutex_wait = run_mutex_scheduler(n_threads, n_campaigns, n_slices);
+        return mutex_wait.count();
+    };
+
+    BENCHMARK( "work-stealing deques" )
+    {
+        stealing_wait = run_stealing_scheduler(n_threads, n_campaigns, n_slices);
+        return stealing_wait.count();
+    };
+
+    std::cout << "scheduler wait per slice with " << n_threads << " threads: mutex "
+        << (mutex_wait.count() / n_slices) << " ns, work-stealing "
+        << (stealing_wait.count() / n_slices) << " ns" << std::endl;
+}
@@ -0,0 +1,53 @@
+#include "fuzz/corpus.hpp"
+#include "fuzz/coverage-tracker.hpp"
+#include "fuzz/random.hpp"
+#include "fuzz/work-queue.hpp"
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace regulator::fuzz;
+
+/**
+ * Builds a synthetic corpus of `n_entries` entries, each covering a
+ * random subset of ~`n_edges` edges with mostly-tied counts, the way a
+ * corpus looks after a long campaign
+ */
+static void make_corpus(Corpus<uint8_t> &corpus, size_t n_entries, size_t n_edges)
+{
+    Random random(0x9E3779B97F4A7C15ull);
+    for (size_t i = 0; i < n_entries; i++)
+    {
+        CoverageTracker *tracker = new CoverageTracker(0);
+        for (size_t j = 0; j < 64; j++)
+        {
+            uintptr_t src = random.Below(n_edges) * 8;
+            tracker->Cover(src, src + 8);
+        }
+        // a unique edge keeps every entry in the corpus
+        tracker->Cover(0x100000 + i * 8, 0x100000 + i * 8 + 8);
+        tracker->Bucketize();
+        corpus.Record(new CorpusEntry<uint8_t>(new uint8_t[8](), 8, tracker));
+        if (i % 100 == 99)
+        {
+            corpus.FlushGeneration();
+        }
+    }
+    corpus.FlushGeneration();
+}
+
+TEST_CASE( "Bench Queue::Fill", "[!benchmark]" )
+{
+    Corpus<uint8_t> corpus;
+    make_corpus(corpus, 10000, 2000);
+    REQUIRE( corpus.Size() == 10000 );
+
+    BENCHMARK( "Fill from a 10k-entry corpus" )
+    {
+        Queue<uint8_t> queue;
+        queue.Fill(corpus);
+        return queue.HasNext();
+    };
+}
@@ -0,0 +1,46 @@
+// random-trackers.hpp
+//
+// Pseudo-random coverage for the tests and benchmarks which need
+// many distinct, reproducible trackers.
+//
+
+#pragma once
+
+#include "fuzz/coverage-tracker.hpp"
+#include "fuzz/random.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace regulator
+{
+namespace fuzz
+{
+
+/**
+ * Makes a bucketized tracker for subjects of length `string_length`,
+ * covering `10 + seed % spread` branches drawn from `n_offsets` offsets
+ * `stride` bytes apart, each to itself or one of the next two. The same
+ * arguments always make the same coverage.
+ */
+inline CoverageTracker *make_tracker(
+    uint64_t seed,
+    size_t spread = 40,
+    size_t n_offsets = 64,
+    uintptr_t stride = 4,
+    uint32_t string_length = 0)
+{
+    CoverageTracker *ret = new CoverageTracker(string_length);
+    Random random(seed);
+    const size_t n = 10 + seed % spread;
+    for (size_t i = 0; i < n; i++)
+    {
+        uintptr_t src = random.Below(n_offsets) * stride;
+        ret->Cover(src, src + stride * random.Below(3));
+    }
+    ret->Bucketize();
+    return ret;
+}
+
+}
+}
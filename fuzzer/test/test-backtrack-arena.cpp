@@ -0,0 +1,37 @@
+#include "fuzz/backtrack-arena.hpp"
+
+#include "catch.hpp"
+
+using namespace regulator::fuzz;
+
+TEST_CASE( "Backtrack arena grows keeping the live prefix" )
+{
+    BacktrackArena arena(4);
+    REQUIRE( arena.Capacity() == 4 );
+    for (int i = 0; i < 4; i++)
+    {
+        arena.Data()[i] = i * 10;
+    }
+
+    arena.Grow(5, 3);
+    REQUIRE( arena.Capacity() >= 5 );
+    REQUIRE( arena.Data()[0] == 0 );
+    REQUIRE( arena.Data()[1] == 10 );
+    REQUIRE( arena.Data()[2] == 20 );
+
+    // already large enough: nothing moves
+    int *before = arena.Data();
+    arena.Grow(5, 5);
+    REQUIRE( arena.Data() == before );
+}
+
+TEST_CASE( "Empty backtrack arena allocates on first growth" )
+{
+    BacktrackArena arena(0);
+    REQUIRE( arena.Capacity() == 0 );
+    REQUIRE( arena.Data() == nullptr );
+
+    arena.Grow(1, 0);
+    REQUIRE( arena.Capacity() >= 1 );
+    REQUIRE( arena.Data() != nullptr );
+}
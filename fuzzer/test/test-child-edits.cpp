@@ -0,0 +1,138 @@
+#include "fuzz/child-edits.hpp"
+#include "fuzz/corpus.hpp"
+#include "fuzz/coverage-tracker.hpp"
+#include "fuzz/mutations.hpp"
+#include "fuzz/random.hpp"
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace regulator::fuzz;
+
+TEST_CASE( "Child edits record only what differs from the parent" )
+{
+    const uint8_t parent[8] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'};
+    ChildEdits<uint8_t> edits;
+    edits.Reset(parent, 8);
+
+    // two runs within the range
+    edits.Draft()[1] = 'X';
+    edits.Draft()[2] = 'Y';
+    edits.Draft()[5] = 'Z';
+    edits.Commit(0, 8);
+    REQUIRE( memcmp(edits.Draft(), parent, 8) == 0 );
+
+    // an unchanged child
+    edits.Commit(0, 0);
+
+    edits.Draft()[7] = '!';
+    edits.Commit(7, 8);
+
+    REQUIRE( edits.Size() == 3 );
+
+    uint8_t out[8];
+    edits.Materialize(0, out);
+    REQUIRE( memcmp(out, "aXYdeZgh", 8) == 0 );
+    edits.Materialize(1, out);
+    REQUIRE( memcmp(out, parent, 8) == 0 );
+    edits.Materialize(2, out);
+    REQUIRE( memcmp(out, "abcdefg!", 8) == 0 );
+
+    uint8_t work[8];
+    memcpy(work, parent, 8);
+    for (size_t i = 0; i < edits.Size(); i++)
+    {
+        uint8_t expected[8];
+        edits.Materialize(i, expected);
+
+        edits.Apply(i, work);
+        REQUIRE( memcmp(work, expected, 8) == 0 );
+        edits.Revert(i, work);
+        REQUIRE( memcmp(work, parent, 8) == 0 );
+    }
+}
+
+TEST_CASE( "A swapped child round-trips through its edits" )
+{
+    const uint8_t parent[8] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'};
+    ChildEdits<uint8_t> edits;
+    edits.Reset(parent, 8);
+
+    Random rng(3);
+    for (size_t i = 0; i < 20; i++)
+    {
+        struct mutated_range changed = swap_random_char(edits.Draft(), 8, rng);
+        edits.Commit(changed.begin, changed.end);
+    }
+
+    uint8_t work[8];
+    memcpy(work, parent, 8);
+    for (size_t i = 0; i < edits.Size(); i++)
+    {
+        uint8_t child[8];
+        edits.Materialize(i, child);
+
+        // exactly two chars trade places
+        size_t n_differ = 0;
+        size_t differ[2] = {0, 0};
+        for (size_t j = 0; j < 8; j++)
+        {
+            if (child[j] != parent[j])
+            {
+                if (n_differ < 2)
+                {
+                    differ[n_differ] = j;
+                }
+                n_differ++;
+            }
+        }
+        REQUIRE( n_differ == 2 );
+        REQUIRE( child[differ[0]] == parent[differ[1]] );
+        REQUIRE( child[differ[1]] == parent[differ[0]] );
+
+        edits.Apply(i, work);
+        REQUIRE( memcmp(work, child, 8) == 0 );
+        edits.Revert(i, work);
+        REQUIRE( memcmp(work, parent, 8) == 0 );
+    }
+}
+
+TEST_CASE( "Generated child edits match the mutated children" )
+{
+    Corpus<uint16_t> corpus(nullptr, 7);
+    uint16_t *buf = new uint16_t[300];
+    for (size_t i = 0; i < 300; i++)
+    {
+        buf[i] = static_cast<uint16_t>('a' + (i % 26));
+    }
+    corpus.Record(new CorpusEntry<uint16_t>(buf, 300, new CoverageTracker(300)));
+    corpus.FlushGeneration();
+
+    ChildEdits<uint16_t> edits;
+    corpus.GenerateChildren(corpus.Get(0), 200, edits);
+    REQUIRE( edits.Size() == 200 );
+
+    // applying and reverting in turn never disturbs the other children
+    std::vector<uint16_t> work(buf, buf + 300);
+    std::vector<uint16_t> expected(300);
+    size_t n_changed = 0;
+    for (size_t i = 0; i < edits.Size(); i++)
+    {
+        edits.Materialize(i, expected.data());
+        edits.Apply(i, work.data());
+        REQUIRE( work == expected );
+        edits.Revert(i, work.data());
+        REQUIRE( memcmp(work.data(), buf, 300 * sizeof(uint16_t)) == 0 );
+
+        if (memcmp(expected.data(), buf, 300 * sizeof(uint16_t)) != 0)
+        {
+            n_changed++;
+        }
+    }
+
+    // nearly every mutation changes something
+    REQUIRE( n_changed > 150 );
+}
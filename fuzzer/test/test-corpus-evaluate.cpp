@@ -0,0 +1,169 @@
+#include "fuzz/corpus.hpp"
+#include "fuzz/coverage-tracker.hpp"
+
+#include "random-trackers.hpp"
+
+#include "catch.hpp"
+
+#include <vector>
+
+using namespace regulator::fuzz;
+
+/**
+ * Self-edges at every offset below 4096 + 4 * 256, so that the grouped
+ * trackers below have no colliding slots
+ */
+static EdgeIndex *make_grouped_index()
+{
+    edge_list_t edges;
+    for (uint32_t src = 0; src < 4096 + 4 * 256; src += 4)
+    {
+        edges.push_back(std::make_pair(src, src));
+    }
+    return new EdgeIndex(edges, 4096 + 4 * 256, edge_list_t(), 0);
+}
+
+/**
+ * Makes a bucketized tracker covering edge group A, group B if
+ * `with_b`, and one edge unique to `fresh` (unless zero)
+ */
+static CoverageTracker *make_grouped_tracker(
+    const EdgeIndex *index, bool with_a, bool with_b, uint64_t fresh)
+{
+    CoverageTracker *ret = new CoverageTracker(0, index);
+    for (uintptr_t src = 0; src < 32 && with_a; src += 4)
+    {
+        ret->Cover(src, src);
+    }
+    for (uintptr_t src = 512; src < 544 && with_b; src += 4)
+    {
+        ret->Cover(src, src);
+    }
+    if (fresh != 0)
+    {
+        ret->Cover(4096 + fresh * 4, 4096 + fresh * 4);
+    }
+    ret->Bucketize();
+    return ret;
+}
+
+static CorpusEntry<uint8_t> *make_entry(CoverageTracker *tracker)
+{
+    uint8_t *buf = new uint8_t[4]();
+    return new CorpusEntry<uint8_t>(buf, 4, new CoverageTracker(*tracker));
+}
+
+TEST_CASE( "Corpus::Evaluate should agree with HasNewPath, IsRedundant and BumpStaleness" )
+{
+    Corpus<uint8_t> reference;
+    Corpus<uint8_t> fused;
+
+    std::vector<CoverageTracker *> probes;
+    for (uint64_t seed = 1000; seed < 1020; seed++)
+    {
+        probes.push_back(make_tracker(seed));
+    }
+
+    for (uint64_t generation = 0; generation < 20; generation++)
+    {
+        for (uint64_t i = 0; i < 25; i++)
+        {
+            CoverageTracker *child = make_tracker(generation * 7 + i);
+
+            bool expect_keep = reference.HasNewPath(child) && !reference.IsRedundant(child);
+            if (expect_keep)
+            {
+                reference.BumpStaleness(child);
+                reference.Record(make_entry(child));
+            }
+
+            struct novelty novelty = fused.Evaluate(child);
+            REQUIRE( (novelty.has_new_path && !novelty.is_redundant) == expect_keep );
+            if (novelty.has_new_path && !novelty.is_redundant)
+            {
+                fused.Record(make_entry(child));
+            }
+
+            delete child;
+        }
+
+        reference.FlushGeneration();
+        fused.FlushGeneration();
+
+        REQUIRE( fused.Size() == reference.Size() );
+        REQUIRE( fused.Residency() == reference.Residency() );
+        for (size_t i = 0; i < fused.Size(); i++)
+        {
+            REQUIRE(
+                fused.GetStalenessScore(fused.Get(i)->GetCoverage()) ==
+                reference.GetStalenessScore(reference.Get(i)->GetCoverage())
+            );
+        }
+        for (size_t i = 0; i < probes.size(); i++)
+        {
+            REQUIRE( fused.GetStalenessScore(probes[i]) == reference.GetStalenessScore(probes[i]) );
+            REQUIRE( fused.HasNewPath(probes[i]) == reference.HasNewPath(probes[i]) );
+        }
+    }
+
+    for (size_t i = 0; i < probes.size(); i++)
+    {
+        delete probes[i];
+    }
+}
+
+
+TEST_CASE( "Corpus::Evaluate should bump staleness of tied edges like BumpStaleness" )
+{
+    EdgeIndex *index = make_grouped_index();
+    Corpus<uint8_t> reference(index);
+    Corpus<uint8_t> fused(index);
+
+    for (uint64_t i = 1; i < 200; i++)
+    {
+        // every child ties group A, every third child ties group B, and
+        // each child exceeds the upper bound on its own fresh edge
+        CoverageTracker *child = make_grouped_tracker(index, true, i % 3 == 0, i);
+
+        bool expect_keep = reference.HasNewPath(child) && !reference.IsRedundant(child);
+        if (expect_keep)
+        {
+            reference.BumpStaleness(child);
+            reference.Record(make_entry(child));
+        }
+
+        struct novelty novelty = fused.Evaluate(child);
+        REQUIRE( (novelty.has_new_path && !novelty.is_redundant) == expect_keep );
+        REQUIRE( novelty.n_exceeded >= 1 );
+        if (novelty.has_new_path && !novelty.is_redundant)
+        {
+            fused.Record(make_entry(child));
+        }
+
+        delete child;
+
+        if (i % 10 == 0)
+        {
+            reference.FlushGeneration();
+            fused.FlushGeneration();
+        }
+    }
+
+    // group A (ids 0-7) is more stale than group B (ids 128-135)
+    REQUIRE( reference.GetStaleness(0) > reference.GetStaleness(128) );
+    REQUIRE( reference.GetStaleness(128) > 0 );
+
+    // BumpStaleness also bumps edges which are zero in both the child and
+    // the upper bound; those are reset when first covered, so only the
+    // edges covered by a flushed generation must agree
+    for (uint32_t i = 0; i < fused.MapSize(); i++)
+    {
+        bool covered = i < 8 || (i >= 128 && i < 136) || (i > 1024 && i <= 1024 + 190);
+        if (covered)
+        {
+            REQUIRE( fused.GetStaleness(i) == reference.GetStaleness(i) );
+        }
+    }
+
+    delete index;
+}
@@ -19,7 +19,8 @@ inline void test_mutate_gens_unique()
     parent[4] = 'n';
     parent[5] = 't';
 
-    std::vector<Char *> children;
+    regulator::fuzz::ChildEdits<Char> children;
+    Char child[6];
     std::vector<Char> extra_interesting;
     std::vector<Char *> coparent_buffer;
 
@@ -54,12 +55,9 @@ inline void test_mutate_gens_unique()
             children
         );
 
-        REQUIRE( children.size() == 1 );
-        REQUIRE( children[0] != nullptr );
-        REQUIRE_FALSE( memcmp(children[0], coparent, 6 * sizeof(Char)) == 0 );
-
-        delete[] children[0];
-        children.clear();
+        REQUIRE( children.Size() == 1 );
+        children.Materialize(0, child);
+        REQUIRE_FALSE( memcmp(child, coparent, 6 * sizeof(Char)) == 0 );
     }
 }
 
@@ -70,7 +68,7 @@ TEST_CASE( "Mutator returns 0-len vector when asked" )
     uint8_t *buf = new uint8_t[4];
     buf[0] = 'f'; buf[1] = 'o'; buf[2] = 'o'; buf[3] = '\n';
 
-    std::vector<uint8_t *> children;
+    regulator::fuzz::ChildEdits<uint8_t> children;
     regulator::fuzz::Corpus<uint8_t> corpus;
     regulator::fuzz::CorpusEntry<uint8_t> ce(
         buf,
@@ -83,7 +81,7 @@ TEST_CASE( "Mutator returns 0-len vector when asked" )
         children
     );
 
-    REQUIRE( children.size() == 0 );
+    REQUIRE( children.Size() == 0 );
 }
 
 TEST_CASE( "Mutator returns 0-len vector when asked (16-bit)" )
@@ -92,7 +90,7 @@ TEST_CASE( "Mutator returns 0-len vector when asked (16-bit)" )
     uint16_t *buf = new uint16_t[4];
     buf[0] = 'f'; buf[1] = 'o'; buf[2] = 'o'; buf[3] = '\n';
 
-    std::vector<uint16_t *> children;
+    regulator::fuzz::ChildEdits<uint16_t> children;
     regulator::fuzz::Corpus<uint16_t> corpus;
     regulator::fuzz::CorpusEntry<uint16_t> ce(
         buf,
@@ -105,7 +103,7 @@ TEST_CASE( "Mutator returns 0-len vector when asked (16-bit)" )
         children
     );
 
-    REQUIRE( children.size() == 0 );
+    REQUIRE( children.Size() == 0 );
 }
 
 
@@ -131,7 +129,7 @@ TEST_CASE( "Produces more children when prompted" )
     parent[4] = 'n';
     parent[5] = 't';
 
-    std::vector<uint8_t *> children;
+    regulator::fuzz::ChildEdits<uint8_t> children;
     std::vector<uint8_t> extra_interesting;
     std::vector<uint8_t *> coparent_buffer;
 
@@ -164,14 +162,7 @@ TEST_CASE( "Produces more children when prompted" )
         children
     );
 
-    REQUIRE( children.size() == 20 );
-
-    for (size_t i=0; i<children.size(); i++)
-    {
-        delete[] children[i];
-    }
-
-    children.clear();
+    REQUIRE( children.Size() == 20 );
 }
 
 TEST_CASE( "bit-flip will change exactly one bit (1-byte)" )
@@ -179,12 +170,13 @@ TEST_CASE( "bit-flip will change exactly one bit (1-byte)" )
     uint8_t subject[] = {'a', 'b', 'c', 'd'};
 
     uint8_t cpy[sizeof(subject)];
+    f::Random rng;
 
     for (size_t i=0; i<20; i++)
     {
         memcpy(cpy, subject, sizeof(subject));
 
-        f::bit_flip(cpy, sizeof(subject));
+        f::bit_flip(cpy, sizeof(subject), rng);
 
         size_t popcount = 0;
         for (size_t i=0; i<sizeof(subject); i++)
@@ -201,12 +193,13 @@ TEST_CASE( "bit-flip will change exactly one bit (2-byte)" )
     uint16_t subject[] = {'a', 'b', 'c', 'd'};
 
     uint16_t cpy[sizeof(subject) / 2];
+    f::Random rng;
 
     for (size_t i=0; i<20; i++)
     {
         memcpy(cpy, subject, sizeof(subject));
 
-        f::bit_flip(cpy, sizeof(subject) / 2);
+        f::bit_flip(cpy, sizeof(subject) / 2, rng);
 
         size_t popcount = 0;
         for (size_t i=0; i<sizeof(subject) / 2; i++)
@@ -224,7 +217,8 @@ TEST_CASE( "crossover will use another buffer" )
     uint8_t *coparent = new uint8_t[sizeof(parent)];
     memset(coparent, 'x', sizeof(parent));
 
-    f::crossover(parent, sizeof(parent), coparent);
+    f::Random rng;
+    f::crossover(parent, sizeof(parent), coparent, rng);
 
     delete[] coparent;
 }
@@ -246,7 +240,7 @@ TEST_CASE( "mutate will eventually place an interesting utf-16 char ")
     ));
 
     corpus.FlushGeneration();
-    std::vector<uint16_t *> children;
+    regulator::fuzz::ChildEdits<uint16_t> children;
     std::vector<uint16_t> *interesting = new std::vector<uint16_t>;
     interesting->push_back(0xCAFE);
     corpus.SetInteresting(interesting);
@@ -255,7 +249,6 @@ TEST_CASE( "mutate will eventually place an interesting utf-16 char ")
 
     for (size_t i=0; i < 200 && !found_special; i++)
     {
-        children.clear();
         uint16_t *parent = new uint16_t[5];
         parent[0] = 'w';
         parent[1] = 'x';
@@ -275,15 +268,16 @@ TEST_CASE( "mutate will eventually place an interesting utf-16 char ")
             children
         );
 
-        REQUIRE( children.size() == 10 );
+        REQUIRE( children.Size() == 10 );
 
-        for (size_t j=0; j<children.size(); j++)
+        uint16_t child[5];
+        for (size_t j=0; j<children.Size(); j++)
         {
+            children.Materialize(j, child);
             for (size_t k=0; k<5; k++)
             {
-                found_special = found_special || children[j][k] == 0xCAFE;
+                found_special = found_special || child[k] == 0xCAFE;
             }
-            delete[] children[j];
         }
     }
 
@@ -22,7 +22,7 @@ TEST_CASE( "Initialize and destroy corpus entry" )
     REQUIRE( entry->buf != nullptr);
     REQUIRE( entry->buflen == buflen );
     REQUIRE( memcmp(entry->buf, buf, buflen) == 0 );
-    REQUIRE( entry->coverage_tracker != nullptr );
+    REQUIRE( entry->GetCoverage()->Total() == 1 );
 
     delete entry;
 }
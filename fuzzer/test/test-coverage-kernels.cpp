@@ -0,0 +1,132 @@
+#include "fuzz/coverage-kernels.hpp"
+#include "fuzz/random.hpp"
+
+#include "catch.hpp"
+
+#include <cstring>
+
+using namespace regulator::fuzz;
+
+/**
+ * Fills a block with pseudo-random counts, biased towards zero
+ * and small values the way real coverage maps are
+ */
+static void fill_block(uint8_t *block, Random &random)
+{
+    for (size_t i = 0; i < MAP_BLOCK_SIZE; i++)
+    {
+        const uint64_t x = random.Next();
+        switch (x % 4)
+        {
+        case 0:
+            block[i] = 0;
+            break;
+        case 1:
+            block[i] = (x >> 8) % 8;
+            break;
+        default:
+            block[i] = static_cast<uint8_t>(x >> 16);
+            break;
+        }
+    }
+}
+
+TEST_CASE( "Coverage kernels should have a scalar fallback" )
+{
+    auto supported = SupportedCoverageKernels();
+    REQUIRE( supported.size() >= 1 );
+    REQUIRE( strcmp(supported[0]->name, "scalar") == 0 );
+    REQUIRE( &ActiveCoverageKernels() == supported.back() );
+}
+
+TEST_CASE( "Coverage kernels should bucketize every count like the scalar kernel" )
+{
+    auto supported = SupportedCoverageKernels();
+    const struct coverage_kernels *scalar = supported[0];
+
+    uint8_t expected[4][MAP_BLOCK_SIZE];
+    for (size_t i = 0; i < 256; i++)
+    {
+        expected[i / MAP_BLOCK_SIZE][i % MAP_BLOCK_SIZE] = static_cast<uint8_t>(i);
+    }
+    for (size_t b = 0; b < 4; b++)
+    {
+        scalar->bucketize(expected[b]);
+    }
+
+    // spot-check the AFL classes
+    REQUIRE( expected[0][3] == 4 );
+    REQUIRE( expected[0][7] == 8 );
+    REQUIRE( expected[0][16] == 32 );
+    REQUIRE( expected[1][0] == 64 );
+    REQUIRE( expected[3][63] == 128 );
+
+    for (size_t k = 1; k < supported.size(); k++)
+    {
+        INFO( supported[k]->name );
+        for (size_t b = 0; b < 4; b++)
+        {
+            uint8_t block[MAP_BLOCK_SIZE];
+            for (size_t i = 0; i < MAP_BLOCK_SIZE; i++)
+            {
+                block[i] = static_cast<uint8_t>(b * MAP_BLOCK_SIZE + i);
+            }
+            supported[k]->bucketize(block);
+            REQUIRE( memcmp(block, expected[b], MAP_BLOCK_SIZE) == 0 );
+        }
+    }
+}
+
+TEST_CASE( "Coverage kernels should match the scalar kernel on random blocks" )
+{
+    auto supported = SupportedCoverageKernels();
+    const struct coverage_kernels *scalar = supported[0];
+
+    Random random(0xDEADBEEFCAFEF00Dull);
+    for (size_t trial = 0; trial < 2000; trial++)
+    {
+        uint8_t a[MAP_BLOCK_SIZE];
+        uint8_t b[MAP_BLOCK_SIZE];
+        fill_block(a, random);
+        if (trial % 3 == 0)
+        {
+            // make plenty of ties
+            memcpy(b, a, MAP_BLOCK_SIZE);
+            b[trial % MAP_BLOCK_SIZE] ^= 1;
+        }
+        else
+        {
+            fill_block(b, random);
+        }
+
+        uint8_t expected_max[MAP_BLOCK_SIZE];
+        memcpy(expected_max, a, MAP_BLOCK_SIZE);
+        scalar->max_into(expected_max, b);
+
+        uint8_t expected_bucketized[MAP_BLOCK_SIZE];
+        memcpy(expected_bucketized, a, MAP_BLOCK_SIZE);
+        scalar->bucketize(expected_bucketized);
+
+        for (size_t k = 1; k < supported.size(); k++)
+        {
+            INFO( supported[k]->name );
+            const struct coverage_kernels *kern = supported[k];
+
+            REQUIRE( kern->greater_mask(a, b) == scalar->greater_mask(a, b) );
+            REQUIRE( kern->greater_mask(b, a) == scalar->greater_mask(b, a) );
+            REQUIRE( kern->maximizes_mask(a, b) == scalar->maximizes_mask(a, b) );
+            REQUIRE( kern->maximizes_mask(b, a) == scalar->maximizes_mask(b, a) );
+            REQUIRE( kern->nonzero_mask(a) == scalar->nonzero_mask(a) );
+
+            uint8_t max[MAP_BLOCK_SIZE];
+            memcpy(max, a, MAP_BLOCK_SIZE);
+            kern->max_into(max, b);
+            REQUIRE( memcmp(max, expected_max, MAP_BLOCK_SIZE) == 0 );
+
+            uint8_t bucketized[MAP_BLOCK_SIZE];
+            memcpy(bucketized, a, MAP_BLOCK_SIZE);
+            kern->bucketize(bucketized);
+            REQUIRE( memcmp(bucketized, expected_bucketized, MAP_BLOCK_SIZE) == 0 );
+        }
+    }
+}
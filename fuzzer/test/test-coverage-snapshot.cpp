@@ -0,0 +1,127 @@
+#include "fuzz/coverage-snapshot.hpp"
+#include "fuzz/coverage-tracker.hpp"
+
+#include "random-trackers.hpp"
+
+#include "catch.hpp"
+
+#include <vector>
+
+using namespace regulator::fuzz;
+
+/**
+ * Spread over a map big enough for several words per tracker
+ */
+static CoverageTracker *make_big_tracker(uint64_t seed, uint32_t string_length = 0)
+{
+    return make_tracker(seed, 200, 4096, 8, string_length);
+}
+
+TEST_CASE( "Coverage snapshot keeps exactly the covered edges" )
+{
+    CoverageTracker *tracker = make_big_tracker(3, 4);
+    tracker->Suggest(8, 16, 'x', 2);
+    tracker->Suggest(24, 16, 'y', 1);
+    tracker->Observe(1);
+    tracker->Observe(1);
+
+    CoverageSnapshot snapshot(*tracker);
+    REQUIRE( snapshot.Total() == tracker->Total() );
+    REQUIRE( snapshot.PathHash() == tracker->PathHash() );
+    REQUIRE( snapshot.MapSize() == tracker->MapSize() );
+    REQUIRE( snapshot.StringLength() == 4 );
+    REQUIRE( snapshot.MaxObservation() == 2 );
+    REQUIRE_FALSE( snapshot.HasObservations() );
+
+    size_t n_covered = 0;
+    for (size_t i = 0; i < tracker->MapSize(); i++)
+    {
+        REQUIRE( snapshot.EdgeIsCovered(i) == tracker->EdgeIsCovered(i) );
+        REQUIRE( tracker->EdgeIsEqual(snapshot, i) );
+        n_covered += tracker->EdgeIsCovered(i) ? 1 : 0;
+    }
+    REQUIRE( snapshot.NumCovered() == n_covered );
+    for (size_t i = 1; i < snapshot.NumCovered(); i++)
+    {
+        REQUIRE( snapshot.CoveredEdge(i - 1) < snapshot.CoveredEdge(i) );
+    }
+
+    std::vector<struct suggestion> expected, got;
+    tracker->GetSuggestions(expected);
+    snapshot.GetSuggestions(got);
+    REQUIRE( got.size() == 2 );
+    for (size_t i = 0; i < got.size(); i++)
+    {
+        REQUIRE( got[i].c == expected[i].c );
+        REQUIRE( got[i].pos == expected[i].pos );
+        REQUIRE( got[i].component == expected[i].component );
+    }
+
+    CoverageSnapshot copy(snapshot);
+    REQUIRE( copy.NumCovered() == snapshot.NumCovered() );
+    REQUIRE( copy.Edge(snapshot.CoveredEdge(0)) == snapshot.CoveredBucket(0) );
+
+    delete tracker;
+}
+
+TEST_CASE( "Coverage snapshot can keep the observation profile" )
+{
+    CoverageTracker tracker(70000);
+    for (uint32_t i = 0; i < 70000; i++)
+    {
+        if (i % 1000 < 10)
+        {
+            tracker.Observe(i);
+        }
+    }
+    tracker.Observe(69999);
+    tracker.Observe(69999);
+
+    CoverageSnapshot snapshot(tracker, true);
+    REQUIRE( snapshot.HasObservations() );
+    REQUIRE( snapshot.MaxObservation() == 2 );
+    REQUIRE( snapshot.Observation(0) == 1 );
+    REQUIRE( snapshot.Observation(9) == 1 );
+    REQUIRE( snapshot.Observation(10) == 0 );
+    REQUIRE( snapshot.Observation(65009) == 1 );
+    REQUIRE( snapshot.Observation(65535) == 0 );
+    REQUIRE( snapshot.Observation(69998) == 0 );
+    REQUIRE( snapshot.Observation(69999) == 2 );
+}
+
+TEST_CASE( "Upper bound queries agree on trackers and snapshots" )
+{
+    for (uint64_t seed = 0; seed < 50; seed++)
+    {
+        CoverageTracker *bound = make_big_tracker(seed * 3 + 1);
+        CoverageTracker *other = make_big_tracker(seed * 7 + 2);
+        CoverageTracker *more = make_big_tracker(seed * 5 + 3);
+        bound->Union(more);
+        delete more;
+        CoverageSnapshot snapshot(*other);
+
+        std::vector<struct block_comparison> expected, got;
+        bound->Compare(other, expected);
+        bound->Compare(snapshot, got);
+        REQUIRE( got.size() == expected.size() );
+        for (size_t i = 0; i < got.size(); i++)
+        {
+            REQUIRE( got[i].base == expected[i].base );
+            REQUIRE( got[i].greater == expected[i].greater );
+            REQUIRE( got[i].equal == expected[i].equal );
+        }
+        REQUIRE( bound->MaximizesAnyEdge(snapshot) == bound->MaximizesAnyEdge(other) );
+
+        CoverageTracker from_tracker(*bound);
+        from_tracker.Union(other);
+        bound->Union(snapshot);
+        REQUIRE( bound->Total() == from_tracker.Total() );
+        for (size_t i = 0; i < bound->MapSize(); i++)
+        {
+            REQUIRE( bound->EdgeIsEqual(&from_tracker, i) );
+        }
+
+        delete bound;
+        delete other;
+    }
+}
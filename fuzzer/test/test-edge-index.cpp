@@ -0,0 +1,106 @@
+#include "fuzz/edge-index.hpp"
+#include "fuzz/coverage-tracker.hpp"
+
+#include "catch.hpp"
+
+#include <set>
+
+using namespace regulator::fuzz;
+
+/**
+ * A small made-up program: a few two-way branches, plus one "POP_BT"
+ * at offset 64 which may return to many places
+ */
+static edge_list_t make_edges(uint32_t shift)
+{
+    edge_list_t ret;
+    for (uint32_t src = 0; src < 64; src += 8)
+    {
+        ret.push_back(std::make_pair(src + shift, src + shift));
+        ret.push_back(std::make_pair(src + shift, src + shift + 16));
+    }
+    for (uint32_t dst = 0; dst < 64; dst += 4)
+    {
+        ret.push_back(std::make_pair(64 + shift, dst + shift));
+    }
+    return ret;
+}
+
+TEST_CASE( "EdgeIndex should give each edge a distinct id" )
+{
+    edge_list_t one_byte = make_edges(0);
+    edge_list_t two_byte = make_edges(4);
+    EdgeIndex index(one_byte, 72, two_byte, 76);
+
+    REQUIRE( index.Size() == one_byte.size() + two_byte.size() + 1 );
+
+    std::set<uint32_t> seen;
+    for (size_t i = 0; i < one_byte.size(); i++)
+    {
+        uint32_t id = index.Lookup(true, one_byte[i].first, one_byte[i].second);
+        REQUIRE( id < index.UnknownId() );
+        seen.insert(id);
+    }
+    for (size_t i = 0; i < two_byte.size(); i++)
+    {
+        uint32_t id = index.Lookup(false, two_byte[i].first, two_byte[i].second);
+        REQUIRE( id < index.UnknownId() );
+        seen.insert(id);
+    }
+    REQUIRE( seen.size() == one_byte.size() + two_byte.size() );
+}
+
+TEST_CASE( "EdgeIndex should map unknown edges to the reserved id" )
+{
+    edge_list_t one_byte = make_edges(0);
+    edge_list_t two_byte = make_edges(4);
+    EdgeIndex index(one_byte, 72, two_byte, 76);
+
+    REQUIRE( index.Lookup(true, 0, 4) == index.UnknownId() );
+    REQUIRE( index.Lookup(true, 64, 2) == index.UnknownId() );
+    REQUIRE( index.Lookup(true, 1000, 0) == index.UnknownId() );
+    // one-byte edge looked up in the two-byte program
+    REQUIRE( index.Lookup(false, 8, 24) == index.UnknownId() );
+}
+
+TEST_CASE( "CoverageTracker with an EdgeIndex should use one slot per edge" )
+{
+    edge_list_t one_byte = make_edges(0);
+    edge_list_t two_byte = make_edges(4);
+    EdgeIndex index(one_byte, 72, two_byte, 76);
+
+    CoverageTracker cc(0, &index);
+    REQUIRE( cc.MapSize() == index.Size() );
+
+    cc.SelectProgram(true);
+    for (size_t i = 0; i < one_byte.size(); i++)
+    {
+        cc.Cover(one_byte[i].first, one_byte[i].second);
+    }
+    cc.Bucketize();
+
+    // every one-byte edge is covered, nothing else
+    REQUIRE( cc.Residency() == Approx(one_byte.size() / static_cast<double>(index.Size())) );
+    for (size_t i = 0; i < one_byte.size(); i++)
+    {
+        REQUIRE( cc.EdgeIsCovered(index.Lookup(true, one_byte[i].first, one_byte[i].second)) );
+    }
+
+    CoverageTracker copy(cc);
+    REQUIRE( copy.MapSize() == index.Size() );
+    REQUIRE_FALSE( copy.HasNewPath(&cc) );
+
+    // the same offsets in the two-byte program are different edges
+    CoverageTracker upper_bound(0, &index);
+    upper_bound.Union(&cc);
+    cc.Clear();
+    cc.SelectProgram(false);
+    cc.Cover(4, 20);
+    cc.Bucketize();
+    REQUIRE( upper_bound.HasNewPath(&cc) );
+
+    // switching back to hashed coverage
+    cc.UseEdgeIndex(nullptr);
+    REQUIRE( cc.MapSize() == MAP_SIZE );
+    REQUIRE( cc.Total() == 0 );
+}
@@ -1,5 +1,10 @@
+#include <chrono>
 #include <iostream>
+#include <thread>
+#include <vector>
+#include <string>
 
+#include "flags.hpp"
 #include "fuzz/coverage-tracker.hpp"
 #include "regexp-executor.hpp"
 #include "v8.h"
@@ -152,3 +157,269 @@ TEST_CASE( "can execute against 16-bit strings" )
     REQUIRE( exec_result.match_success == true );
     REQUIRE( old_covtrack.HasNewPath(exec_result.coverage_tracker.get()) );
 }
+
+TEST_CASE( "Should see each new subject when reusing subject strings" ) {
+    v8::Isolate *isolate = regulator::executor::Initialize();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
+    ctx->Enter();
+
+    e::V8RegExp regexp;
+    e::Result compile_result_status = e::Compile("^fo[o]$", "", &regexp);
+
+    REQUIRE( compile_result_status == e::kSuccess );
+
+    // one-byte subjects of one length share a single V8 string
+    const char *one_byte_subjects[] = {"foo", "bar", "foo", "fop"};
+    const bool one_byte_expected[] = {true, false, true, false};
+    for (size_t i = 0; i < 4; i++)
+    {
+        e::V8RegExpResult exec_result(3);
+        e::Result exec_result_status = e::Exec<uint8_t>(
+            &regexp,
+            reinterpret_cast<const uint8_t *>(one_byte_subjects[i]),
+            3,
+            exec_result,
+            -1,
+            e::kOnlyOneByte
+        );
+
+        REQUIRE( exec_result_status == e::kSuccess );
+        REQUIRE( exec_result.rep_used == e::kRepOneByte );
+        REQUIRE( exec_result.match_success == one_byte_expected[i] );
+    }
+
+    // two-byte subjects which fit in one byte are still one-byte strings
+    const uint16_t narrow[] = {'f', 'o', 'o'};
+    const uint16_t wide[] = {'f', 'o', 0x2603};
+    e::V8RegExpResult exec_result(3);
+
+    REQUIRE( e::Exec<uint16_t>(
+        &regexp, narrow, 3, exec_result, -1,
+        e::kOnlyTwoByte
+    ) == e::kBadStrRepresentation );
+
+    REQUIRE( e::Exec<uint16_t>(
+        &regexp, wide, 3, exec_result, -1,
+        e::kOnlyTwoByte
+    ) == e::kSuccess );
+    REQUIRE( exec_result.rep_used == e::kRepTwoByte );
+    REQUIRE( exec_result.match_success == false );
+
+    REQUIRE( e::Exec<uint16_t>(
+        &regexp, narrow, 3, exec_result, -1,
+        e::kAnyRepresentation
+    ) == e::kSuccess );
+    REQUIRE( exec_result.rep_used == e::kRepOneByte );
+    REQUIRE( exec_result.match_success == true );
+}
+
+TEST_CASE( "Should execute on threads started after compilation" ) {
+    v8::Isolate *isolate = regulator::executor::Initialize();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
+    ctx->Enter();
+
+    e::V8RegExp regexp;
+    REQUIRE( e::Compile("(f)(o)[o]", "", &regexp) == e::kSuccess );
+
+    const size_t n_threads = 8;
+    std::vector<int> n_matches(n_threads, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; t++)
+    {
+        threads.emplace_back([&regexp, &n_matches, t]() {
+            regulator::executor::Initialize();
+            const char *subjects[] = {"foo", "bar"};
+            for (size_t i = 0; i < 100; i++)
+            {
+                e::V8RegExpResult &result = e::ScratchResult(3);
+                e::Result status = e::Exec<uint8_t>(
+                    &regexp,
+                    reinterpret_cast<const uint8_t *>(subjects[i % 2]),
+                    3,
+                    result,
+                    -1,
+                    e::kOnlyOneByte
+                );
+                if (status == e::kSuccess && result.match_success)
+                {
+                    n_matches[t]++;
+                }
+            }
+        });
+    }
+
+    for (size_t t = 0; t < n_threads; t++)
+    {
+        threads[t].join();
+        REQUIRE( n_matches[t] == 50 );
+    }
+}
+
+TEST_CASE( "ExecBatch should agree with ExecRaw on each subject" ) {
+    v8::Isolate *isolate = regulator::executor::Initialize();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
+    ctx->Enter();
+
+    e::V8RegExp regexp;
+    REQUIRE( e::Compile("a(b|c)d(e|f)+g.", "", &regexp) == e::kSuccess );
+
+    const size_t len = 8;
+    const std::string subjects = "abdeeeg!" "acdfefg?" "abdeeeee" "zzzzzzzz";
+    const size_t n = subjects.size() / len;
+
+    std::vector<e::V8RegExpResult> results;
+    for (size_t i = 0; i < n; i++)
+    {
+        results.emplace_back(len);
+    }
+    // a taken tracker must be replaced
+    results[1].coverage_tracker.reset();
+    std::vector<e::Result> result_codes(n);
+
+    REQUIRE( e::ExecBatch<uint8_t>(
+        &regexp,
+        reinterpret_cast<const uint8_t *>(subjects.c_str()),
+        n,
+        len,
+        results.data(),
+        result_codes.data(),
+        -1,
+        e::kOnlyOneByte
+    ) == e::kSuccess );
+
+    for (size_t i = 0; i < n; i++)
+    {
+        e::V8RegExpResult single(len);
+        REQUIRE( e::ExecRaw<uint8_t>(
+            &regexp,
+            reinterpret_cast<const uint8_t *>(subjects.c_str()) + i * len,
+            len,
+            single,
+            -1,
+            e::kOnlyOneByte
+        ) == e::kSuccess );
+
+        REQUIRE( result_codes[i] == e::kSuccess );
+        REQUIRE( results[i].coverage_tracker != nullptr );
+        REQUIRE( results[i].match_success == single.match_success );
+        REQUIRE( results[i].coverage_tracker->Total() == single.coverage_tracker->Total() );
+    }
+    REQUIRE( results[0].match_success );
+    REQUIRE( results[1].match_success );
+    REQUIRE_FALSE( results[3].match_success );
+}
+
+TEST_CASE( "Instrumentation tiers record only what they promise" ) {
+    v8::Isolate *isolate = regulator::executor::Initialize();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
+    ctx->Enter();
+
+    e::V8RegExp regexp;
+    REQUIRE( e::Compile("(a|b)*c", "", &regexp) == e::kSuccess );
+
+    std::string subject = "ababab";
+    const uint8_t *subject_bytes = reinterpret_cast<const uint8_t *>(subject.c_str());
+
+    e::V8RegExpResult none(subject.size());
+    e::V8RegExpResult path_length(subject.size());
+    e::V8RegExpResult edges(subject.size());
+    e::V8RegExpResult full(subject.size());
+
+    REQUIRE( e::ExecRaw<uint8_t>(&regexp, subject_bytes, subject.size(), none, -1, e::kOnlyOneByte, regulator::fuzz::kInstrumentNone) == e::kSuccess );
+    REQUIRE( e::ExecRaw<uint8_t>(&regexp, subject_bytes, subject.size(), path_length, -1, e::kOnlyOneByte, regulator::fuzz::kInstrumentPathLength) == e::kSuccess );
+    REQUIRE( e::ExecRaw<uint8_t>(&regexp, subject_bytes, subject.size(), edges, -1, e::kOnlyOneByte, regulator::fuzz::kInstrumentEdges) == e::kSuccess );
+    REQUIRE( e::ExecRaw<uint8_t>(&regexp, subject_bytes, subject.size(), full, -1, e::kOnlyOneByte, regulator::fuzz::kInstrumentFull) == e::kSuccess );
+
+    REQUIRE_FALSE( none.match_success );
+    REQUIRE_FALSE( path_length.match_success );
+    REQUIRE_FALSE( edges.match_success );
+    REQUIRE_FALSE( full.match_success );
+
+    REQUIRE( none.coverage_tracker->Total() == 0 );
+    REQUIRE( none.coverage_tracker->PathLength() == 0 );
+
+    REQUIRE( path_length.coverage_tracker->Total() == 0 );
+    REQUIRE( path_length.coverage_tracker->PathLength() > 0 );
+
+    REQUIRE( edges.coverage_tracker->Total() > 0 );
+    REQUIRE( edges.coverage_tracker->Total() == full.coverage_tracker->Total() );
+    REQUIRE( edges.coverage_tracker->MaxObservation() == 0 );
+    REQUIRE( full.coverage_tracker->MaxObservation() > 0 );
+}
+
+TEST_CASE( "An execution without max_total stops at the default budget" ) {
+    v8::Isolate *isolate = regulator::executor::Initialize();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
+    ctx->Enter();
+
+    e::V8RegExp regexp;
+    REQUIRE( e::Compile("(a*)*b", "", &regexp) == e::kSuccess );
+
+    std::string subject(24, 'a');
+    const uint8_t *subject_bytes = reinterpret_cast<const uint8_t *>(subject.c_str());
+
+    const int32_t prev_budget = regulator::flags::FLAG_exec_budget;
+    regulator::flags::FLAG_exec_budget = 1000;
+
+    e::V8RegExpResult exec_result(subject.size());
+    REQUIRE( e::ExecRaw<uint8_t>(&regexp, subject_bytes, subject.size(), exec_result, -1, e::kOnlyOneByte) == e::kBudgetExhausted );
+    REQUIRE( exec_result.coverage_tracker->Total() >= 1000 );
+    REQUIRE_FALSE( exec_result.match_success );
+
+    // an explicit max_total takes precedence
+    REQUIRE( e::ExecRaw<uint8_t>(&regexp, subject_bytes, subject.size(), exec_result, 500, e::kOnlyOneByte) == e::kViolateMaxTotal );
+
+    regulator::flags::FLAG_exec_budget = prev_budget;
+}
+
+TEST_CASE( "The watchdog stops an execution which runs too long" ) {
+    v8::Isolate *isolate = regulator::executor::Initialize();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
+    ctx->Enter();
+
+    e::V8RegExp regexp;
+    REQUIRE( e::Compile("(a*)*b", "", &regexp) == e::kSuccess );
+
+    std::string subject(40, 'a');
+    const uint8_t *subject_bytes = reinterpret_cast<const uint8_t *>(subject.c_str());
+
+    const int32_t prev_budget = regulator::flags::FLAG_exec_budget;
+    regulator::flags::FLAG_exec_budget = 0;
+
+    {
+        e::ExecWatchdog watchdog(
+            std::chrono::milliseconds(20),
+            std::chrono::steady_clock::now() + std::chrono::hours(1)
+        );
+
+        e::V8RegExpResult exec_result(subject.size());
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE( e::ExecRaw<uint8_t>(&regexp, subject_bytes, subject.size(), exec_result, -1, e::kOnlyOneByte) == e::kTimedOut );
+        REQUIRE( std::chrono::steady_clock::now() - start < std::chrono::seconds(5) );
+        REQUIRE( exec_result.coverage_tracker->Total() > 0 );
+
+        // the isolate is usable again afterwards
+        std::string quick = "aab";
+        REQUIRE( e::ExecRaw<uint8_t>(&regexp, reinterpret_cast<const uint8_t *>(quick.c_str()), quick.size(), exec_result, -1, e::kOnlyOneByte) == e::kSuccess );
+        REQUIRE( exec_result.match_success );
+    }
+
+    {
+        // a later watchdog (perhaps at the same address) gets a new slot
+        e::ExecWatchdog watchdog(
+            std::chrono::milliseconds(20),
+            std::chrono::steady_clock::now() + std::chrono::hours(1)
+        );
+
+        e::V8RegExpResult exec_result(subject.size());
+        REQUIRE( e::ExecRaw<uint8_t>(&regexp, subject_bytes, subject.size(), exec_result, -1, e::kOnlyOneByte) == e::kTimedOut );
+    }
+
+    regulator::flags::FLAG_exec_budget = prev_budget;
+}
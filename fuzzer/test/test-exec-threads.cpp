@@ -0,0 +1,162 @@
+#include "fuzz/coverage-tracker.hpp"
+#include "regexp-executor.hpp"
+#include "flags.hpp"
+#include "v8.h"
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace e = regulator::executor;
+
+TEST_CASE( "Should agree with the compiling thread on 64 threads" ) {
+    v8::Isolate *isolate = regulator::executor::Initialize();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
+    ctx->Enter();
+
+    regulator::flags::FLAG_dense_edges = true;
+    e::V8RegExp regexp;
+    REQUIRE( e::Compile("^(a|b|ab)*c", "", &regexp) == e::kSuccess );
+    regulator::flags::FLAG_dense_edges = false;
+    REQUIRE( regexp.edge_index != nullptr );
+
+    const std::vector<std::string> subjects = {
+        "ababababc",
+        "abababab_",
+        "aaaaaaaac",
+        "bbbbbbbba",
+    };
+
+    // expected results, from the compiling thread
+    std::vector<bool> expected_match;
+    std::vector<uint64_t> expected_total;
+    for (size_t i = 0; i < subjects.size(); i++)
+    {
+        e::V8RegExpResult result(subjects[i].size());
+        REQUIRE( e::Exec<uint8_t>(
+            &regexp,
+            reinterpret_cast<const uint8_t *>(subjects[i].c_str()),
+            subjects[i].size(),
+            result,
+            -1,
+            e::kOnlyOneByte
+        ) == e::kSuccess );
+        expected_match.push_back(result.match_success);
+        expected_total.push_back(result.coverage_tracker->Total());
+    }
+
+    const size_t n_threads = 64;
+    std::vector<size_t> n_disagreements(n_threads, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; t++)
+    {
+        threads.emplace_back([&, t]() {
+            regulator::executor::Initialize();
+            for (size_t round = 0; round < 50; round++)
+            {
+                const std::string &subject = subjects[(t + round) % subjects.size()];
+                e::V8RegExpResult &result = e::ScratchResult(subject.size());
+
+                // alternate between both entry points
+                e::Result status = (round % 2 == 0 ? e::Exec<uint8_t> : e::ExecRaw<uint8_t>)(
+                    &regexp,
+                    reinterpret_cast<const uint8_t *>(subject.c_str()),
+                    subject.size(),
+                    result,
+                    -1,
+                    e::kOnlyOneByte
+                );
+
+                const size_t i = (t + round) % subjects.size();
+                if (status != e::kSuccess ||
+                    result.match_success != expected_match[i] ||
+                    result.coverage_tracker->Total() != expected_total[i])
+                {
+                    n_disagreements[t]++;
+                }
+            }
+        });
+    }
+
+    for (size_t t = 0; t < n_threads; t++)
+    {
+        threads[t].join();
+        REQUIRE( n_disagreements[t] == 0 );
+    }
+}
+
+TEST_CASE( "Should compile for a fresh thread whose first call is ExecBatch or ExecRaw" ) {
+    v8::Isolate *isolate = regulator::executor::Initialize();
+    v8::HandleScope scope(isolate);
+    v8::Local<v8::Context> ctx = v8::Context::New(isolate);
+    ctx->Enter();
+
+    // new to every thread, so each compiles it on its first call
+    e::V8RegExp regexp;
+    REQUIRE( e::Compile("(x+x+)+y", "i", &regexp) == e::kSuccess );
+
+    const std::string subject = "xxxxxxxxxxY";
+    e::V8RegExpResult expected(subject.size());
+    REQUIRE( e::Exec<uint8_t>(
+        &regexp,
+        reinterpret_cast<const uint8_t *>(subject.c_str()),
+        subject.size(),
+        expected,
+        -1,
+        e::kOnlyOneByte
+    ) == e::kSuccess );
+    REQUIRE( expected.match_success );
+
+    const size_t n_threads = 8;
+    std::vector<size_t> n_disagreements(n_threads, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < n_threads; t++)
+    {
+        threads.emplace_back([&, t]() {
+            regulator::executor::Initialize();
+            e::V8RegExpResult result(subject.size());
+            e::Result status;
+            if (t % 2 == 0)
+            {
+                e::ExecBatch<uint8_t>(
+                    &regexp,
+                    reinterpret_cast<const uint8_t *>(subject.c_str()),
+                    1,
+                    subject.size(),
+                    &result,
+                    &status,
+                    -1,
+                    e::kOnlyOneByte
+                );
+            }
+            else
+            {
+                status = e::ExecRaw<uint8_t>(
+                    &regexp,
+                    reinterpret_cast<const uint8_t *>(subject.c_str()),
+                    subject.size(),
+                    result,
+                    -1,
+                    e::kOnlyOneByte
+                );
+            }
+
+            if (status != e::kSuccess ||
+                result.match_success != expected.match_success ||
+                result.coverage_tracker->Total() != expected.coverage_tracker->Total())
+            {
+                n_disagreements[t]++;
+            }
+        });
+    }
+
+    for (size_t t = 0; t < n_threads; t++)
+    {
+        threads[t].join();
+        REQUIRE( n_disagreements[t] == 0 );
+    }
+}
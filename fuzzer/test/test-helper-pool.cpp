@@ -0,0 +1,74 @@
+#include "fuzz/helper-pool.hpp"
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace regulator::fuzz;
+
+TEST_CASE( "HelperPool::Run should run every task exactly once" )
+{
+    std::atomic<size_t> n_inits(0);
+    HelperPool pool(4, [&n_inits]() { n_inits++; });
+    REQUIRE( pool.Size() == 4 );
+
+    for (size_t n_tasks = 0; n_tasks < 100; n_tasks += 7)
+    {
+        std::vector<std::atomic<int>> hits(n_tasks);
+        for (size_t i = 0; i < n_tasks; i++)
+        {
+            hits[i] = 0;
+        }
+
+        pool.Run(n_tasks, [&hits](size_t i) { hits[i]++; });
+
+        for (size_t i = 0; i < n_tasks; i++)
+        {
+            REQUIRE( hits[i] == 1 );
+        }
+    }
+
+    // each helper initializes once, when it starts
+    REQUIRE( n_inits <= 4 );
+}
+
+TEST_CASE( "HelperPool::Run should work without helpers" )
+{
+    HelperPool pool(0);
+    size_t sum = 0;
+    pool.Run(10, [&sum](size_t i) { sum += i; });
+    REQUIRE( sum == 45 );
+}
+
+TEST_CASE( "HelperPool::Run should support several concurrent callers" )
+{
+    HelperPool pool(3);
+
+    const size_t n_callers = 4;
+    std::vector<std::thread> callers;
+    std::vector<size_t> sums(n_callers, 0);
+    for (size_t c = 0; c < n_callers; c++)
+    {
+        callers.emplace_back([&pool, &sums, c]() {
+            for (size_t round = 0; round < 200; round++)
+            {
+                std::atomic<size_t> sum(0);
+                pool.Run(25, [&sum](size_t i) {
+                    sum += i;
+                });
+                sums[c] += sum;
+            }
+        });
+    }
+    for (size_t c = 0; c < n_callers; c++)
+    {
+        callers[c].join();
+    }
+
+    for (size_t c = 0; c < n_callers; c++)
+    {
+        REQUIRE( sums[c] == 200 * (24 * 25 / 2) );
+    }
+}
@@ -0,0 +1,152 @@
+#include "fuzz/input-cache.hpp"
+#include "fuzz/child-edits.hpp"
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using namespace regulator::fuzz;
+
+TEST_CASE( "Input cache remembers hashes and counts hits" )
+{
+    InputCache cache(16);
+
+    // looking up does not insert
+    REQUIRE_FALSE( cache.Lookup(1234) );
+    REQUIRE_FALSE( cache.Lookup(1234) );
+    cache.Insert(1234);
+    REQUIRE( cache.Lookup(1234) );
+    cache.Insert(0);
+    REQUIRE( cache.Lookup(0) );
+    REQUIRE( cache.Lookups() == 4 );
+    REQUIRE( cache.Hits() == 2 );
+
+    // a hash in the same slot evicts the old one
+    cache.Insert(1234 + 16);
+    REQUIRE( cache.Lookup(1234 + 16) );
+    REQUIRE_FALSE( cache.Lookup(1234) );
+}
+
+TEST_CASE( "Input hash depends on content and position" )
+{
+    const uint8_t ab[2] = {'a', 'b'};
+    const uint8_t ba[2] = {'b', 'a'};
+    const uint8_t ab_copy[2] = {'a', 'b'};
+
+    REQUIRE( input_hash(ab, 2) == input_hash(ab_copy, 2) );
+    REQUIRE( input_hash(ab, 2) != input_hash(ba, 2) );
+}
+
+TEST_CASE( "Child hashes match their materialized content" )
+{
+    const uint8_t parent[8] = {'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h'};
+    ChildEdits<uint8_t> edits;
+    edits.Reset(parent, 8);
+    REQUIRE( edits.ParentHash() == input_hash(parent, 8) );
+
+    edits.Draft()[1] = 'X';
+    edits.Draft()[5] = 'Z';
+    edits.Commit(0, 8);
+
+    // rewrites a char with itself: no edit at all
+    edits.Commit(3, 4);
+
+    // swaps two chars back and forth
+    edits.Draft()[6] = 'h';
+    edits.Draft()[7] = 'g';
+    edits.Commit(6, 8);
+
+    edits.Draft()[0] = 'b';
+    edits.Draft()[1] = 'a';
+    edits.Commit(0, 2);
+
+    uint8_t out[8];
+    for (size_t i = 0; i < edits.Size(); i++)
+    {
+        edits.Materialize(i, out);
+        REQUIRE( edits.Hash(i) == input_hash(out, 8) );
+    }
+    REQUIRE( edits.Hash(1) == edits.ParentHash() );
+    REQUIRE( edits.Hash(2) != edits.ParentHash() );
+}
+
+TEST_CASE( "Retaining children keeps their order and edits" )
+{
+    const uint8_t parent[4] = {'a', 'a', 'a', 'a'};
+    ChildEdits<uint8_t> edits;
+    edits.Reset(parent, 4);
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        edits.Draft()[i] = 'b';
+        edits.Draft()[3 - i] = 'c';
+        edits.Commit(0, 4);
+    }
+
+    std::vector<uint8_t> keep = {0, 1, 0, 1};
+    edits.Retain(keep);
+    REQUIRE( edits.Size() == 2 );
+
+    uint8_t out[4];
+    edits.Materialize(0, out);
+    REQUIRE( memcmp(out, "abca", 4) == 0 );
+    edits.Materialize(1, out);
+    REQUIRE( memcmp(out, "caab", 4) == 0 );
+
+    uint8_t work[4] = {'a', 'a', 'a', 'a'};
+    edits.Apply(1, work);
+    REQUIRE( memcmp(work, "caab", 4) == 0 );
+    edits.Revert(1, work);
+    REQUIRE( memcmp(work, parent, 4) == 0 );
+
+    keep = {0, 0};
+    edits.Retain(keep);
+    REQUIRE( edits.Size() == 0 );
+}
+
+TEST_CASE( "A batch with repeated children keeps each distinct child once" )
+{
+    const uint8_t parent[4] = {'a', 'b', 'c', 'd'};
+    ChildEdits<uint8_t> edits;
+    edits.Reset(parent, 4);
+
+    // X, no-op, X, Y, no-op, Y
+    const char *children[6] = {"Xbcd", "abcd", "Xbcd", "abYd", "abcd", "abYd"};
+    for (size_t i = 0; i < 6; i++)
+    {
+        memcpy(edits.Draft(), children[i], 4);
+        edits.Commit(0, 4);
+    }
+
+    InputCache cache(64);
+    cache.DropDuplicates(edits);
+    REQUIRE( edits.Size() == 3 );
+
+    uint8_t out[4];
+    edits.Materialize(0, out);
+    REQUIRE( memcmp(out, "Xbcd", 4) == 0 );
+    edits.Materialize(1, out);
+    REQUIRE( memcmp(out, "abcd", 4) == 0 );
+    edits.Materialize(2, out);
+    REQUIRE( memcmp(out, "abYd", 4) == 0 );
+    REQUIRE( cache.Lookups() == 6 );
+    REQUIRE( cache.Hits() == 3 );
+
+    // only the children which ran to completion are remembered: "abYd"
+    // was cut short, say, so the next batch runs it again
+    cache.Insert(edits.Hash(0));
+    cache.Insert(edits.Hash(1));
+
+    edits.Reset(parent, 4);
+    for (size_t i = 0; i < 6; i++)
+    {
+        memcpy(edits.Draft(), children[i], 4);
+        edits.Commit(0, 4);
+    }
+    cache.DropDuplicates(edits);
+    REQUIRE( edits.Size() == 1 );
+    edits.Materialize(0, out);
+    REQUIRE( memcmp(out, "abYd", 4) == 0 );
+}
@@ -0,0 +1,57 @@
+#include "fuzz/path-hash-set.hpp"
+#include "fuzz/corpus.hpp"
+#include "fuzz/coverage-tracker.hpp"
+#include "fuzz/random.hpp"
+
+#include "catch.hpp"
+
+#include <set>
+
+using namespace regulator::fuzz;
+
+TEST_CASE( "Path hash set agrees with std::set through growth" )
+{
+    PathHashSet set(4);
+    std::set<path_hash_t> reference;
+    REQUIRE( set.Capacity() >= 8 );
+
+    Random random(88172645463325252ull);
+    for (size_t i = 0; i < 5000; i++)
+    {
+        const uint64_t x = random.Next();
+
+        // a small range, so that many hashes repeat; zero included
+        path_hash_t hash = static_cast<path_hash_t>(x % 3000) << 64 | (x % 7);
+        const bool expected = reference.count(hash) > 0;
+        REQUIRE( set.Contains(hash) == expected );
+        REQUIRE( set.InsertOrFind(hash) == expected );
+        REQUIRE( set.Contains(hash) );
+        reference.insert(hash);
+    }
+
+    REQUIRE( set.Size() == reference.size() );
+    REQUIRE( set.Capacity() >= 2 * (set.Size() - 1) );
+    REQUIRE( set.Contains(0) == (reference.count(0) > 0) );
+}
+
+TEST_CASE( "Corpus drops duplicate paths when they are recorded" )
+{
+    Corpus<uint8_t> corpus;
+    const uint8_t buf[4] = {'a', 'b', 'c', 'd'};
+
+    CoverageTracker tracker(4);
+    tracker.Cover(8, 16);
+    tracker.Bucketize();
+    REQUIRE_FALSE( corpus.IsRedundant(&tracker) );
+
+    corpus.Record(corpus.NewEntry(buf, 4, new CoverageTracker(tracker)));
+
+    // not yet flushed, but already known
+    REQUIRE( corpus.IsRedundant(&tracker) );
+    REQUIRE( corpus.Evaluate(&tracker).is_redundant );
+    corpus.Record(corpus.NewEntry(buf, 4, new CoverageTracker(tracker)));
+
+    corpus.FlushGeneration();
+    REQUIRE( corpus.Size() == 1 );
+    REQUIRE( corpus.IsRedundant(&tracker) );
+}
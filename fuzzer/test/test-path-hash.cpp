@@ -0,0 +1,148 @@
+#include "fuzz/path-hash.hpp"
+#include "fuzz/random.hpp"
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <set>
+#include <unordered_set>
+#include <vector>
+
+using namespace regulator::fuzz;
+
+typedef path_hash_t (*path_hash_fn)(path_hash_t, uintptr_t, uintptr_t);
+
+/**
+ * Generates `n` distinct paths over a small control-flow graph. Each path
+ * is a sequence of branch targets; paths are short and share many prefixes,
+ * which is the worst case for a rolling hash.
+ */
+static std::vector<std::vector<uintptr_t>> make_paths(size_t n, uint64_t seed)
+{
+    std::set<std::vector<uintptr_t>> seen;
+    std::vector<std::vector<uintptr_t>> ret;
+    // seeded, so the paths are identical across runs
+    Random random(seed);
+    while (ret.size() < n)
+    {
+        std::vector<uintptr_t> path;
+        size_t len = 1 + random.Below(24);
+        for (size_t i = 0; i < len; i++)
+        {
+            // 12 branch sites, 4-byte aligned like bytecode offsets
+            path.push_back(random.Below(12) * 4);
+        }
+        if (seen.insert(path).second)
+        {
+            ret.push_back(path);
+        }
+    }
+    return ret;
+}
+
+static path_hash_t hash_path(path_hash_fn fn, const std::vector<uintptr_t> &path)
+{
+    path_hash_t h = 0;
+    for (size_t i = 0; i + 1 < path.size(); i++)
+    {
+        h = fn(h, path[i] * 2, path[i + 1]);
+    }
+    // a single-element path still takes one (self-looping) transition
+    h = fn(h, path.back() * 2, path.back());
+    return h;
+}
+
+/**
+ * Counts how many paths collide with an earlier path when only the low
+ * `bits` bits of the hash are kept.
+ */
+static size_t count_collisions(
+    path_hash_fn fn,
+    const std::vector<std::vector<uintptr_t>> &paths,
+    unsigned bits)
+{
+    const __uint128_t mask = (static_cast<__uint128_t>(1) << bits) - 1;
+    std::unordered_set<uint64_t> seen;
+    size_t collisions = 0;
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        __uint128_t h = static_cast<__uint128_t>(hash_path(fn, paths[i]));
+        if (!seen.insert(static_cast<uint64_t>(h & mask)).second)
+        {
+            collisions++;
+        }
+    }
+    return collisions;
+}
+
+/**
+ * Same as count_collisions, but over the high `bits` bits
+ */
+static size_t count_collisions_high(
+    path_hash_fn fn,
+    const std::vector<std::vector<uintptr_t>> &paths,
+    unsigned bits)
+{
+    std::unordered_set<uint64_t> seen;
+    size_t collisions = 0;
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        __uint128_t h = static_cast<__uint128_t>(hash_path(fn, paths[i]));
+        if (!seen.insert(static_cast<uint64_t>(h >> (128 - bits))).second)
+        {
+            collisions++;
+        }
+    }
+    return collisions;
+}
+
+
+TEST_CASE( "Path hashes of distinct paths should not collide" )
+{
+    auto paths = make_paths(200000, 0xC0FFEE);
+
+    REQUIRE( count_collisions(path_hash_murmur, paths, 64) == 0 );
+    REQUIRE( count_collisions(path_hash_mulxor, paths, 64) == 0 );
+    REQUIRE( count_collisions_high(path_hash_murmur, paths, 64) == 0 );
+    REQUIRE( count_collisions_high(path_hash_mulxor, paths, 64) == 0 );
+}
+
+
+TEST_CASE( "Truncated path hashes should collide no more often than Murmur" )
+{
+    // With 2^17 paths in a 2^24 space the birthday bound expects about
+    // n^2 / 2^25 = 512 collisions from an ideal hash.
+    const size_t n = 1 << 17;
+    const unsigned bits = 24;
+    const double expected = (static_cast<double>(n) * n) / (2.0 * (1 << bits));
+
+    auto paths = make_paths(n, 0xBADC0DE);
+
+    size_t murmur_low = count_collisions(path_hash_murmur, paths, bits);
+    size_t mulxor_low = count_collisions(path_hash_mulxor, paths, bits);
+    size_t murmur_high = count_collisions_high(path_hash_murmur, paths, bits);
+    size_t mulxor_high = count_collisions_high(path_hash_mulxor, paths, bits);
+
+    INFO( "expected=" << expected << " murmur_low=" << murmur_low << " mulxor_low=" << mulxor_low
+          << " murmur_high=" << murmur_high << " mulxor_high=" << mulxor_high );
+
+    // Both must sit within ~20% of the ideal birthday bound (several
+    // standard deviations), so the mulxor false-positive rate in the
+    // corpus is indistinguishable from Murmur's.
+    REQUIRE( murmur_low < expected * 1.2 );
+    REQUIRE( mulxor_low < expected * 1.2 );
+    REQUIRE( murmur_high < expected * 1.2 );
+    REQUIRE( mulxor_high < expected * 1.2 );
+    REQUIRE( mulxor_low > expected * 0.8 );
+    REQUIRE( mulxor_high > expected * 0.8 );
+}
+
+
+TEST_CASE( "Path hash should depend on transition order and direction" )
+{
+    path_hash_t ab = path_hash_mulxor(path_hash_mulxor(0, 8, 16), 16, 8);
+    path_hash_t ba = path_hash_mulxor(path_hash_mulxor(0, 16, 8), 8, 16);
+    REQUIRE( ab != ba );
+    REQUIRE( path_hash_mulxor(0, 8, 16) != path_hash_mulxor(0, 16, 8) );
+    REQUIRE( path_hash_mulxor(0, 8, 16) != 0 );
+}
@@ -0,0 +1,72 @@
+#include "fuzz/corpus.hpp"
+#include "fuzz/random.hpp"
+
+#include "catch.hpp"
+
+#include <vector>
+
+using namespace regulator::fuzz;
+
+TEST_CASE( "Random should be reproducible from its seed" )
+{
+    Random a(1234);
+    Random b(1234);
+    Random c(1235);
+
+    bool any_differ = false;
+    for (size_t i = 0; i < 1000; i++)
+    {
+        uint64_t x = a.Next();
+        REQUIRE( x == b.Next() );
+        any_differ |= x != c.Next();
+    }
+    REQUIRE( any_differ );
+
+    a.Seed(1234);
+    b.Seed(1234);
+    REQUIRE( a.Next() == b.Next() );
+}
+
+TEST_CASE( "Random::Below should stay in range and hit every value" )
+{
+    Random rng(7);
+    std::vector<size_t> counts(10, 0);
+    for (size_t i = 0; i < 10000; i++)
+    {
+        size_t x = rng.Below(10);
+        REQUIRE( x < 10 );
+        counts[x]++;
+    }
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+        REQUIRE( counts[i] > 800 );
+        REQUIRE( counts[i] < 1200 );
+    }
+}
+
+TEST_CASE( "Corpus::GenerateChildren should be reproducible from the corpus seed" )
+{
+    std::vector<uint8_t> children[2];
+    for (size_t run = 0; run < 2; run++)
+    {
+        Corpus<uint8_t> corpus(nullptr, 42);
+        uint8_t *buf = new uint8_t[8];
+        memcpy(buf, "abcdefgh", 8);
+        corpus.Record(new CorpusEntry<uint8_t>(buf, 8, new CoverageTracker(8)));
+        corpus.FlushGeneration();
+
+        ChildEdits<uint8_t> edits;
+        corpus.GenerateChildren(corpus.Get(0), 100, edits);
+        REQUIRE( edits.Size() == 100 );
+
+        // the parent goes with the corpus, so materialize now
+        children[run].resize(100 * 8);
+        for (size_t i = 0; i < 100; i++)
+        {
+            edits.Materialize(i, &children[run][i * 8]);
+        }
+    }
+
+    REQUIRE( children[0].size() == 100 * 8 );
+    REQUIRE( children[0] == children[1] );
+}
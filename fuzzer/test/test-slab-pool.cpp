@@ -0,0 +1,69 @@
+#include "fuzz/slab-pool.hpp"
+#include "fuzz/corpus.hpp"
+#include "fuzz/coverage-tracker.hpp"
+
+#include "catch.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+using namespace regulator::fuzz;
+
+TEST_CASE( "Slab pool hands freed blocks out again" )
+{
+    SlabPool pool(24, 4);
+    REQUIRE( pool.BlockSize() >= 24 );
+    REQUIRE( pool.BlockSize() % alignof(std::max_align_t) == 0 );
+
+    void *blocks[4];
+    for (size_t i = 0; i < 4; i++)
+    {
+        blocks[i] = pool.Allocate();
+        REQUIRE( reinterpret_cast<uintptr_t>(blocks[i]) % alignof(std::max_align_t) == 0 );
+        memset(blocks[i], 0xAB, 24);
+    }
+    REQUIRE( pool.Live() == 4 );
+    REQUIRE( pool.Slabs() == 1 );
+
+    pool.Free(blocks[2]);
+    REQUIRE( pool.Live() == 3 );
+    REQUIRE( pool.Allocate() == blocks[2] );
+
+    // the first slab is used up
+    pool.Allocate();
+    REQUIRE( pool.Slabs() == 2 );
+    REQUIRE( pool.Live() == 5 );
+}
+
+TEST_CASE( "Corpus entries come from the pool and recycle their trackers" )
+{
+    Corpus<uint8_t> corpus;
+    const uint8_t buf[4] = {'a', 'b', 'c', 'd'};
+
+    // the entry only keeps a snapshot, so the tracker is spare at once
+    CoverageTracker *tracker = new CoverageTracker(4);
+    CorpusEntry<uint8_t> *first = corpus.NewEntry(buf, 4, tracker);
+    REQUIRE( memcmp(first->buf, buf, 4) == 0 );
+    REQUIRE( corpus.TakeSpareTracker(4) == tracker );
+    REQUIRE( corpus.TakeSpareTracker(4) == nullptr );
+
+    corpus.Record(first);
+    corpus.FlushGeneration();
+    REQUIRE( corpus.Size() == 1 );
+
+    // same (empty) coverage: redundant, so it is dropped at the flush
+    corpus.Record(corpus.NewEntry(buf, 4, tracker));
+    corpus.FlushGeneration();
+    REQUIRE( corpus.Size() == 1 );
+
+    // spares of another length are not handed out
+    REQUIRE( corpus.TakeSpareTracker(5) == nullptr );
+    REQUIRE( corpus.TakeSpareTracker(4) == nullptr );
+
+    // entries of another length still work, just off the pool
+    const uint8_t longer[6] = {'a', 'b', 'c', 'd', 'e', 'f'};
+    CorpusEntry<uint8_t> *other = corpus.NewEntry(longer, 6, new CoverageTracker(6));
+    REQUIRE( memcmp(other->buf, longer, 6) == 0 );
+    corpus.Record(other);
+    corpus.FlushGeneration();
+}
@@ -0,0 +1,82 @@
+#include "fuzz/slice-allocator.hpp"
+
+#include "catch.hpp"
+
+#include <chrono>
+
+using namespace regulator::fuzz;
+
+static const auto base = std::chrono::milliseconds(100);
+static const auto min = std::chrono::milliseconds(10);
+static const auto max = std::chrono::milliseconds(400);
+
+TEST_CASE( "SliceAllocator gives the base slice until progress is known" )
+{
+    SliceAllocator slices(3, base, min, max, 0.25, 0.5);
+
+    for (size_t i = 0; i < slices.Size(); i++)
+    {
+        REQUIRE( slices.Rate(i) < 0 );
+        REQUIRE( slices.SliceLength(i) == base );
+    }
+
+    // nobody progressing is the same as nothing known
+    for (size_t i = 0; i < slices.Size(); i++)
+    {
+        slices.Report(i, 0, base);
+    }
+    for (size_t i = 0; i < slices.Size(); i++)
+    {
+        REQUIRE( slices.Rate(i) == 0 );
+        REQUIRE( slices.SliceLength(i) == base );
+    }
+}
+
+TEST_CASE( "SliceAllocator favors progressing campaigns but keeps a minimum share" )
+{
+    SliceAllocator slices(3, base, min, max, 0.25, 0.5);
+
+    slices.Report(0, 10, base);
+    slices.Report(1, 1, base);
+    slices.Report(2, 0, base);
+
+    REQUIRE( slices.Rate(0) == Approx(100) );
+    REQUIRE( slices.Rate(1) == Approx(10) );
+
+    auto slice0 = slices.SliceLength(0);
+    auto slice1 = slices.SliceLength(1);
+    auto slice2 = slices.SliceLength(2);
+
+    REQUIRE( slice0 > base );
+    REQUIRE( slice0 <= max );
+    REQUIRE( slice1 < base );
+    REQUIRE( slice2 < slice1 );
+    REQUIRE( slice2 == base / 4 );
+
+    // campaign 0 saturates; its share decays toward the minimum
+    for (size_t i = 0; i < 20; i++)
+    {
+        slices.Report(0, 0, base);
+    }
+    REQUIRE( slices.SliceLength(0) < base );
+    REQUIRE( slices.SliceLength(0) >= base / 4 );
+    REQUIRE( slices.SliceLength(1) > base );
+}
+
+TEST_CASE( "SliceAllocator clamps to the slice bounds" )
+{
+    SliceAllocator slices(5, base, std::chrono::milliseconds(50), max, 0.1, 1.0);
+
+    slices.Report(0, 1000, base);
+    for (size_t i = 1; i < slices.Size(); i++)
+    {
+        slices.Report(i, 0, base);
+    }
+
+    REQUIRE( slices.SliceLength(0) == max );
+    REQUIRE( slices.SliceLength(1) == std::chrono::milliseconds(50) );
+
+    // an empty slice is ignored
+    slices.Report(1, 5, std::chrono::steady_clock::duration::zero());
+    REQUIRE( slices.Rate(1) == 0 );
+}
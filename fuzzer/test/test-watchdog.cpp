@@ -0,0 +1,77 @@
+#include "fuzz/watchdog.hpp"
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace regulator::fuzz;
+
+static const auto poll = std::chrono::milliseconds(1);
+
+TEST_CASE( "Watchdog fires once for an expired deadline" )
+{
+    Watchdog watchdog(poll);
+    std::atomic<int> n_fired(0);
+    Watchdog::Slot *slot = watchdog.Register([&n_fired] { n_fired++; });
+
+    slot->Arm(std::chrono::steady_clock::now() + std::chrono::milliseconds(5));
+    while (n_fired.load() == 0)
+    {
+        std::this_thread::yield();
+    }
+    // stays fired (but does not fire again) until disarmed
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE( n_fired.load() == 1 );
+    REQUIRE( slot->Disarm() );
+
+    // a fresh arming starts over
+    slot->Arm(std::chrono::steady_clock::now() + std::chrono::hours(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE_FALSE( slot->Disarm() );
+    REQUIRE( n_fired.load() == 1 );
+}
+
+TEST_CASE( "Watchdog ignores disarmed slots" )
+{
+    Watchdog watchdog(poll);
+    std::atomic<int> n_fired(0);
+    Watchdog::Slot *a = watchdog.Register([&n_fired] { n_fired++; });
+    Watchdog::Slot *b = watchdog.Register([&n_fired] { n_fired += 100; });
+
+    // `a` finishes in time, `b` does not
+    a->Arm(std::chrono::steady_clock::now() + std::chrono::hours(1));
+    REQUIRE_FALSE( a->Disarm() );
+    b->Arm(std::chrono::steady_clock::now());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE( b->Disarm() );
+    REQUIRE( n_fired.load() == 100 );
+}
+
+TEST_CASE( "Watchdog disarming waits for a firing in progress" )
+{
+    Watchdog watchdog(poll);
+    std::atomic<int> n_started(0);
+    std::atomic<int> n_finished(0);
+    Watchdog::Slot *slot = watchdog.Register([&n_started, &n_finished] {
+        n_started++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        n_finished++;
+    });
+
+    slot->Arm(std::chrono::steady_clock::now());
+    while (n_started.load() == 0)
+    {
+        std::this_thread::yield();
+    }
+    REQUIRE( slot->Disarm() );
+    REQUIRE( n_finished.load() == 1 );
+
+    // the next arming is not fired on the strength of the last one
+    slot->Arm(std::chrono::steady_clock::now() + std::chrono::hours(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE_FALSE( slot->Disarm() );
+    REQUIRE( n_started.load() == 1 );
+}
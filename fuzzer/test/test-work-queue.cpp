@@ -0,0 +1,175 @@
+#include "fuzz/corpus.hpp"
+#include "fuzz/coverage-tracker.hpp"
+#include "fuzz/work-queue.hpp"
+
+#include "random-trackers.hpp"
+
+#include "catch.hpp"
+
+#include <vector>
+
+using namespace regulator::fuzz;
+
+/**
+ * Fills a corpus over several generations, bumping staleness like the
+ * fuzz driver does
+ */
+static void fill_corpus(Corpus<uint8_t> &corpus, uint64_t n_children)
+{
+    for (uint64_t i = 1; i <= n_children; i++)
+    {
+        CoverageTracker *child = make_tracker(i);
+        struct novelty novelty = corpus.Evaluate(child);
+        if (novelty.has_new_path && !novelty.is_redundant)
+        {
+            uint8_t *buf = new uint8_t[4]();
+            corpus.Record(new CorpusEntry<uint8_t>(buf, 4, child));
+        }
+        else
+        {
+            delete child;
+        }
+
+        if (i % 25 == 0)
+        {
+            corpus.FlushGeneration();
+        }
+    }
+    corpus.FlushGeneration();
+}
+
+/**
+ * Queue::Fill as it was before the maximizer index: a map sweep per entry
+ */
+static void reference_fill(Corpus<uint8_t> &corpus, std::vector<CorpusEntry<uint8_t> *> &out, Random &rng)
+{
+    const size_t map_size = corpus.MapSize();
+    std::vector<bool> represented(map_size, false);
+
+    std::vector<size_t> index_map(corpus.Size());
+    for (size_t i = 0; i < index_map.size(); i++)
+    {
+        index_map[i] = i;
+    }
+    for (size_t i = 0; i + 2 <= index_map.size(); i++)
+    {
+        size_t j = rng.Below(index_map.size() - i) + i;
+        std::swap(index_map[i], index_map[j]);
+    }
+
+    for (size_t i = 0; i < index_map.size(); i++)
+    {
+        CorpusEntry<uint8_t> *entry = corpus.Get(index_map[i]);
+        bool selected = false;
+        for (size_t j = 0; j < map_size && !selected; j++)
+        {
+            if (!represented[j] && corpus.MaximizesEdge(entry->GetCoverage(), j))
+            {
+                out.push_back(entry);
+                selected = true;
+                for (size_t k = j; k < map_size; k++)
+                {
+                    if (corpus.MaximizesEdge(entry->GetCoverage(), k))
+                    {
+                        represented[k] = true;
+                    }
+                }
+            }
+        }
+
+        if (!selected)
+        {
+            uint32_t score = corpus.GetStalenessScore(entry->GetCoverage());
+            if (rng.Below(MAX_STALENESS_SCORE) >= std::max(score, MAX_STALENESS_SCORE - MAX_STALENESS_SCORE / 100))
+            {
+                out.push_back(entry);
+            }
+        }
+    }
+}
+
+TEST_CASE( "Corpus maximizer index should agree with MaximizesEdge" )
+{
+    Corpus<uint8_t> corpus;
+    fill_corpus(corpus, 2000);
+    REQUIRE( corpus.Size() > 50 );
+
+    size_t n_covered = 0;
+    for (size_t edge = 0; edge < corpus.MapSize(); edge++)
+    {
+        std::vector<uint32_t> expected;
+        for (size_t i = 0; i < corpus.Size(); i++)
+        {
+            const CoverageSnapshot *coverage = corpus.Get(i)->GetCoverage();
+            if (coverage->EdgeIsCovered(edge) && corpus.MaximizesEdge(coverage, edge))
+            {
+                expected.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        REQUIRE( corpus.Maximizers(edge) == expected );
+        if (!expected.empty())
+        {
+            n_covered++;
+        }
+    }
+    REQUIRE( corpus.CoveredEdges().size() == n_covered );
+}
+
+TEST_CASE( "Queue::Fill should select the same entries as a full map sweep" )
+{
+    Corpus<uint8_t> corpus;
+    fill_corpus(corpus, 2000);
+
+    for (uint64_t seed = 1; seed < 20; seed++)
+    {
+        std::vector<CorpusEntry<uint8_t> *> expected;
+        Random rng(seed);
+        reference_fill(corpus, expected, rng);
+
+        Queue<uint8_t> queue;
+        corpus.GetRandom().Seed(seed);
+        queue.Fill(corpus);
+
+        std::vector<CorpusEntry<uint8_t> *> got;
+        while (queue.HasNext())
+        {
+            got.insert(got.begin(), queue.Pop());
+        }
+
+        REQUIRE( got == expected );
+    }
+}
+
+TEST_CASE( "Corpus::GetStalenessScore should score stale maximizers above fresh ones" )
+{
+    edge_list_t edges;
+    for (uint32_t src = 0; src < 64; src += 4)
+    {
+        edges.push_back(std::make_pair(src, src));
+    }
+    EdgeIndex index(edges, 64, edge_list_t(), 0);
+    Corpus<uint8_t> corpus(&index);
+
+    // `stale` covers edge 0 once, `fresh` covers edge 4 once
+    CoverageTracker *stale = new CoverageTracker(0, &index);
+    stale->Cover(0, 0);
+    stale->Bucketize();
+    CoverageTracker *fresh = new CoverageTracker(0, &index);
+    fresh->Cover(4, 4);
+    fresh->Bucketize();
+    corpus.Record(new CorpusEntry<uint8_t>(new uint8_t[1](), 1, stale));
+    corpus.FlushGeneration();
+    corpus.Record(new CorpusEntry<uint8_t>(new uint8_t[1](), 1, fresh));
+
+    // a run which ties edge 0 and finds something new makes edge 0 stale
+    CoverageTracker *bumper = new CoverageTracker(0, &index);
+    bumper->Cover(0, 0);
+    bumper->Cover(8, 8);
+    bumper->Bucketize();
+    corpus.Evaluate(bumper);
+    delete bumper;
+    corpus.FlushGeneration();
+
+    REQUIRE( corpus.GetStalenessScore(corpus.Get(0)->GetCoverage()) == MAX_STALENESS_SCORE );
+    REQUIRE( corpus.GetStalenessScore(corpus.Get(1)->GetCoverage()) == 0 );
+}
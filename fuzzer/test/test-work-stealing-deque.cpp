@@ -0,0 +1,101 @@
+#include "fuzz/work-stealing-deque.hpp"
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace regulator::fuzz;
+
+TEST_CASE( "WorkStealingDeque pops newest and steals oldest" )
+{
+    WorkStealingDeque<size_t> deque(3);
+    size_t x;
+
+    REQUIRE_FALSE( deque.Pop(x) );
+    REQUIRE_FALSE( deque.Steal(x) );
+
+    deque.Push(1);
+    deque.Push(2);
+    deque.Push(3);
+    deque.Push(4);
+    REQUIRE( deque.Size() == 4 );
+
+    REQUIRE( deque.Steal(x) );
+    REQUIRE( x == 1 );
+    REQUIRE( deque.Pop(x) );
+    REQUIRE( x == 4 );
+    REQUIRE( deque.Steal(x) );
+    REQUIRE( x == 2 );
+    REQUIRE( deque.Pop(x) );
+    REQUIRE( x == 3 );
+    REQUIRE_FALSE( deque.Pop(x) );
+    REQUIRE_FALSE( deque.Steal(x) );
+
+    // wraps around the buffer
+    for (size_t i = 0; i < 100; i++)
+    {
+        deque.Push(i);
+        REQUIRE( deque.Steal(x) );
+        REQUIRE( x == i );
+    }
+}
+
+TEST_CASE( "WorkStealingDeque hands each element out exactly once under contention" )
+{
+    const size_t n_items = 200000;
+    const size_t n_thieves = 3;
+    WorkStealingDeque<size_t> deque(n_items);
+    std::vector<std::atomic<int>> taken(n_items);
+    for (size_t i = 0; i < n_items; i++)
+    {
+        taken[i] = 0;
+    }
+
+    std::atomic<bool> done(false);
+    std::vector<std::thread> thieves;
+    for (size_t t = 0; t < n_thieves; t++)
+    {
+        thieves.emplace_back([&]() {
+            size_t x;
+            while (!done.load())
+            {
+                if (deque.Steal(x))
+                {
+                    taken[x]++;
+                }
+            }
+        });
+    }
+
+    // the owner pushes everything, popping every third push
+    size_t x;
+    for (size_t i = 0; i < n_items; i++)
+    {
+        deque.Push(i);
+        if (i % 3 == 0 && deque.Pop(x))
+        {
+            taken[x]++;
+        }
+    }
+    while (deque.Pop(x))
+    {
+        taken[x]++;
+    }
+    done = true;
+    for (size_t t = 0; t < n_thieves; t++)
+    {
+        thieves[t].join();
+    }
+
+    size_t n_bad = 0;
+    for (size_t i = 0; i < n_items; i++)
+    {
+        if (taken[i] != 1)
+        {
+            n_bad++;
+        }
+    }
+    REQUIRE( n_bad == 0 );
+}
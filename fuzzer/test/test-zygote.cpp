@@ -0,0 +1,69 @@
+#include "zygote.hpp"
+
+#include "catch.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace regulator;
+
+TEST_CASE( "Zygote job lines decode to arguments" )
+{
+    std::vector<std::string> job;
+
+    // "-r" "a b" "" "--debug"
+    REQUIRE( parse_zygote_job("LXI= YSBi  LS1kZWJ1Zw==", job) );
+    REQUIRE( job.size() == 4 );
+    REQUIRE( job[0] == "-r" );
+    REQUIRE( job[1] == "a b" );
+    REQUIRE( job[2] == "" );
+    REQUIRE( job[3] == "--debug" );
+
+    REQUIRE_FALSE( parse_zygote_job("-r a", job) );
+}
+
+/**
+ * Exits with the first fuzz length, so that the zygote's reply tells
+ * which job ran
+ */
+static int exit_with_length(ParsedArguments &args)
+{
+    return static_cast<int>(args.strlens[0]);
+}
+
+TEST_CASE( "Zygote runs each job in its own child" )
+{
+    // "-r" "a" "-l" "3", then with "-l" "5", then not base64, then with
+    // "-l" "x" (which Parse would have exit()ed on), then "--help"
+    std::istringstream jobs(
+        "LXI= YQ== LWw= Mw==\n"
+        "\n"
+        "LXI= YQ== LWw= NQ==\n"
+        "-r a\n"
+        "LXI= YQ== LWw= eA==\n"
+        "LS1oZWxw\n"
+    );
+    std::ostringstream out;
+
+    REQUIRE( loop_zygote(jobs, out, exit_with_length) == 0 );
+
+    std::istringstream replies(out.str());
+    std::vector<std::string> statuses;
+    std::vector<std::string> pids;
+    std::string tag, pid, status;
+    while (replies >> tag >> pid >> status)
+    {
+        REQUIRE( tag == "ZYGOTE_DONE" );
+        pids.push_back(pid);
+        statuses.push_back(status);
+    }
+
+    REQUIRE( statuses.size() == 5 );
+    REQUIRE( statuses[0] == "3" );
+    REQUIRE( statuses[1] == "5" );
+    REQUIRE( statuses[2] == "1" );
+    REQUIRE( statuses[3] == "1" );
+    REQUIRE( statuses[4] == "0" );
+    REQUIRE( pids[0] != pids[1] );
+}